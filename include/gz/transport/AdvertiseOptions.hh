@@ -18,12 +18,14 @@
 #ifndef GZ_TRANSPORT_ADVERTISEOPTIONS_HH_
 #define GZ_TRANSPORT_ADVERTISEOPTIONS_HH_
 
+#include <chrono>
 #include <cstdint>
 #include <iostream>
 #include <memory>
 
 #include "gz/transport/config.hh"
 #include "gz/transport/Export.hh"
+#include "gz/transport/OverflowPolicy.hh"
 
 namespace gz
 {
@@ -51,6 +53,34 @@ namespace gz
       ALL
     };
 
+    /// \brief This strongly typed enum defines the codecs available to
+    /// compress the messages sent to other processes.
+    enum class Compression_t
+    {
+      /// \brief Messages are sent uncompressed (default).
+      NONE,
+      /// \brief LZ4, fast compression with a moderate ratio.
+      LZ4,
+      /// \brief Zstandard, better ratio at a higher CPU cost.
+      ZSTD
+    };
+
+    /// \brief This strongly typed enum defines the priority classes of the
+    /// messages sent to other processes. Each class is sent and received
+    /// through its own sockets, so the messages of a class never wait
+    /// behind the messages of another class.
+    enum class Priority_t
+    {
+      /// \brief Small and latency critical messages, e.g.: control
+      /// commands. Their callbacks run in the thread that receives them.
+      REALTIME,
+      /// \brief Regular messages (default).
+      NORMAL,
+      /// \brief Large messages where throughput matters more than latency,
+      /// e.g.: images or point clouds.
+      BULK
+    };
+
     /// \class AdvertiseOptions AdvertiseOptions.hh
     /// gz/transport/AdvertiseOptions.hh
     /// \brief A class for customizing the publication options for a topic or
@@ -197,6 +227,97 @@ namespace gz
       /// \param[in] _newMsgsPerSec Maximum number of messages per second.
       public: void SetMsgsPerSec(const uint64_t _newMsgsPerSec);
 
+      /// \brief Get the maximum number of publications of this topic waiting
+      /// to be delivered to the subscribers within the same process.
+      /// \return The queue depth or 0 if the queue is unbounded.
+      /// \sa SetLocalQueueDepth
+      public: uint64_t LocalQueueDepth() const;
+
+      /// \brief Set the maximum number of publications of this topic waiting
+      /// to be delivered to the subscribers within the same process. When the
+      /// queue is full, the overflow policy decides which message is dropped
+      /// and the drop is counted by Node::DroppedMessages().
+      ///
+      /// The depth doesn't apply to the publications sent to other processes.
+      /// Those share the publisher socket of the process, bounded by its high
+      /// water mark (GZ_TRANSPORT_SNDHWM), and ZMQ drops them without
+      /// reporting it.
+      /// \param[in] _depth The queue depth or 0 for an unbounded queue
+      /// (default).
+      /// \sa SetOverflow
+      public: void SetLocalQueueDepth(const uint64_t _depth);
+
+      /// \brief Get the policy applied when the local queue is full.
+      /// \return The overflow policy.
+      /// \sa SetOverflow
+      public: OverflowPolicy Overflow() const;
+
+      /// \brief Set the policy applied when the local queue is full.
+      /// \param[in] _policy The overflow policy. The default is
+      /// OverflowPolicy::DROP_NEWEST.
+      /// \sa SetLocalQueueDepth
+      public: void SetOverflow(const OverflowPolicy _policy);
+
+      /// \brief Get the maximum time that Publish() waits for room in the
+      /// queue with OverflowPolicy::BLOCK.
+      /// \return The timeout.
+      public: std::chrono::milliseconds BlockTimeout() const;
+
+      /// \brief Set the maximum time that Publish() waits for room in the
+      /// queue with OverflowPolicy::BLOCK.
+      /// \param[in] _timeout The timeout. The default is 100 ms.
+      public: void SetBlockTimeout(const std::chrono::milliseconds &_timeout);
+
+      /// \brief Get the codec used to compress the messages sent to other
+      /// processes.
+      /// \return The compression codec.
+      /// \sa SetCompression
+      public: Compression_t Compression() const;
+
+      /// \brief Set the codec used to compress the messages sent to other
+      /// processes. A message is only compressed if its serialized size is
+      /// at least CompressionThreshold() and the remote subscribers that
+      /// announced compression support during discovery all decode the
+      /// codec. The compressed message is only sent to those subscribers,
+      /// the others get it uncompressed. A subscriber never receives a codec
+      /// that it doesn't decode, even before its support is known.
+      /// Subscribers within the same process always get uncompressed
+      /// messages.
+      /// \param[in] _codec The compression codec. The default is
+      /// Compression_t::NONE.
+      /// \sa SetCompressionThreshold
+      public: void SetCompression(const Compression_t _codec);
+
+      /// \brief Get the minimum serialized size of a message to be
+      /// compressed.
+      /// \return The threshold in bytes.
+      /// \sa SetCompressionThreshold
+      public: uint64_t CompressionThreshold() const;
+
+      /// \brief Set the minimum serialized size of a message to be
+      /// compressed. Smaller messages are sent uncompressed.
+      /// \param[in] _bytes The threshold in bytes. The default is 64 KiB.
+      /// \sa SetCompression
+      public: void SetCompressionThreshold(const uint64_t _bytes);
+
+      /// \brief Get the priority class of the messages sent to other
+      /// processes.
+      /// \return The priority class.
+      /// \sa SetPriority
+      public: Priority_t Priority() const;
+
+      /// \brief Set the priority class of the messages sent to other
+      /// processes. The priority is announced during discovery and the
+      /// subscribers receive each class in its own thread. Subscribers
+      /// within the same process are not affected.
+      /// \param[in] _priority The priority class. The default is
+      /// Priority_t::NORMAL.
+      public: void SetPriority(const Priority_t _priority);
+
+      /// \brief MessagePublisher keeps its discovery data in the private
+      /// data of its options.
+      private: friend class MessagePublisher;
+
 #ifdef _WIN32
 // Disable warning C4251 which is triggered by
 // std::unique_ptr
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_TRANSPORT_ARENAPOOL_HH_
+#define GZ_TRANSPORT_ARENAPOOL_HH_
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+#include <google/protobuf/arena.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "gz/transport/config.hh"
+#include "gz/transport/Export.hh"
+
+namespace gz
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE {
+    //
+    // Forward declarations.
+    class ArenaPoolPrivate;
+
+    /// \class ArenaPool ArenaPool.hh gz/transport/ArenaPool.hh
+    /// \brief A thread-safe pool of protobuf arenas used to deserialize
+    /// messages without allocating each of their fields from the heap.
+    ///
+    /// Every arena owns an initial block that survives Arena::Reset(), so a
+    /// recycled arena deserializes messages that fit in that block without
+    /// any allocation. An arena returns to the pool, after being reset, when
+    /// the last copy of the pointer returned by Acquire() is released. The
+    /// pointers may outlive the pool.
+    class GZ_TRANSPORT_VISIBLE ArenaPool
+    {
+      /// \brief Constructor.
+      /// \param[in] _blockSize Size of the initial block of each arena
+      /// (bytes).
+      /// \param[in] _maxIdle Maximum number of idle arenas retained.
+      public: explicit ArenaPool(std::size_t _blockSize = kDefaultBlockSize,
+                                 std::size_t _maxIdle = kDefaultMaxIdle);
+
+      /// \brief Destructor. Frees all the idle arenas.
+      public: ~ArenaPool();
+
+      /// \brief Get an empty arena.
+      /// \return Pointer to the arena. Objects created in the arena must not
+      /// be used after the last copy of the pointer is released.
+      public: std::shared_ptr<google::protobuf::Arena> Acquire();
+
+      /// \brief Get the number of Acquire() calls served from an idle arena.
+      /// \return Number of pool hits.
+      public: uint64_t Hits() const;
+
+      /// \brief Get the number of Acquire() calls that created an arena.
+      /// \return Number of pool misses.
+      public: uint64_t Misses() const;
+
+      /// \brief Get the number of idle arenas.
+      /// \return Idle arenas held by the pool.
+      public: std::size_t Idle() const;
+
+      /// \brief Default size of the initial block of each arena (64 KiB).
+      public: inline static const std::size_t kDefaultBlockSize = 64u << 10;
+
+      /// \brief Default maximum number of idle arenas.
+      public: inline static const std::size_t kDefaultMaxIdle = 4u;
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::shared_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+      /// \internal
+      /// \brief Pointer to private data. It is shared with the arenas in
+      /// use, so they can return to the pool.
+      private: std::shared_ptr<ArenaPoolPrivate> dataPtr;
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+    };
+    }
+  }
+}
+#endif
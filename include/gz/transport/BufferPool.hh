@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_TRANSPORT_BUFFERPOOL_HH_
+#define GZ_TRANSPORT_BUFFERPOOL_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "gz/transport/config.hh"
+#include "gz/transport/Export.hh"
+
+namespace gz
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE {
+    //
+    // Forward declarations.
+    class BufferPoolPrivate;
+
+    /// \class BufferPool BufferPool.hh gz/transport/BufferPool.hh
+    /// \brief A thread-safe pool of byte buffers grouped in power-of-two size
+    /// classes. It is used to recycle the buffers holding serialized messages
+    /// instead of allocating and freeing one per publication.
+    ///
+    /// Buffers bigger than the largest size class are allocated and freed
+    /// directly from the heap. Returned buffers are kept for reuse until the
+    /// pool holds MaxBytesHeld() bytes, after which they are freed.
+    class GZ_TRANSPORT_VISIBLE BufferPool
+    {
+      /// \brief Constructor.
+      /// \param[in] _maxBytesHeld Maximum number of bytes retained by the
+      /// pool in idle buffers.
+      public: explicit BufferPool(
+        std::size_t _maxBytesHeld = kDefaultMaxBytesHeld);
+
+      /// \brief Destructor. Frees all the idle buffers. Buffers still in
+      /// use can be released after the pool is destroyed only through
+      /// Deallocate() with a null hint.
+      public: ~BufferPool();
+
+      /// \brief Get a buffer with room for at least _size bytes.
+      /// \param[in] _size Requested size (bytes).
+      /// \return Pointer to the buffer. It must be returned with Release()
+      /// or Deallocate().
+      public: char *Acquire(std::size_t _size);
+
+      /// \brief Return a buffer previously obtained with Acquire().
+      /// \param[in] _buffer The buffer. A nullptr is ignored.
+      public: void Release(char *_buffer);
+
+      /// \brief Deallocation function compatible with DeallocFunc, so it can
+      /// be passed to ZeroMQ for zero-copy messages.
+      /// \param[in] _buffer Buffer obtained from BufferPool::Acquire().
+      /// \param[in] _hint Pointer to the BufferPool that owns the buffer. If
+      /// nullptr, the buffer is freed instead of recycled.
+      public: static void Deallocate(void *_buffer, void *_hint);
+
+      /// \brief Get the number of Acquire() calls served from an idle buffer.
+      /// \return Number of pool hits.
+      public: uint64_t Hits() const;
+
+      /// \brief Get the number of Acquire() calls that had to allocate.
+      /// \return Number of pool misses.
+      public: uint64_t Misses() const;
+
+      /// \brief Get the number of bytes currently held in idle buffers.
+      /// \return Bytes held by the pool.
+      public: std::size_t BytesHeld() const;
+
+      /// \brief Get the maximum number of bytes retained in idle buffers.
+      /// \return The limit set at construction time.
+      public: std::size_t MaxBytesHeld() const;
+
+      /// \brief Get the capacity of the size class used for a given request.
+      /// \param[in] _size Requested size (bytes).
+      /// \return The capacity of the size class or 0 if _size is bigger than
+      /// the largest size class and is not pooled.
+      public: static std::size_t SizeClassCapacity(std::size_t _size);
+
+      /// \brief Default limit of bytes held by the pool (64 MiB).
+      public: inline static const std::size_t kDefaultMaxBytesHeld =
+        64u << 20;
+
+      /// \brief Smallest size class (bytes).
+      public: inline static const std::size_t kMinBlockSize = 64u;
+
+      /// \brief Largest size class (bytes).
+      public: inline static const std::size_t kMaxBlockSize = 16u << 20;
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<BufferPoolPrivate> dataPtr;
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+    };
+    }
+  }
+}
+#endif
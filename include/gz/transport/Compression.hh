@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_TRANSPORT_COMPRESSION_HH_
+#define GZ_TRANSPORT_COMPRESSION_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "gz/transport/AdvertiseOptions.hh"
+#include "gz/transport/config.hh"
+#include "gz/transport/Export.hh"
+
+namespace gz
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE {
+    //
+    /// \brief Size of the header in front of a compressed message (bytes).
+    /// It holds a zero byte, the codec and the uncompressed size. A
+    /// serialized protobuf message never starts with a zero byte, so
+    /// compressed and uncompressed messages can't be confused.
+    constexpr std::size_t kCompressionHeaderSize = 10u;
+
+    /// \brief Default limit of the uncompressed size of a received message
+    /// (bytes). See GZ_TRANSPORT_MAX_DECOMPRESSED_SIZE.
+    constexpr std::size_t kDefaultMaxDecompressedSize = 256u * 1024u * 1024u;
+
+    /// \brief Get the bit that represents a codec in a codec mask.
+    /// \param[in] _codec The codec.
+    /// \return The bit mask of the codec.
+    constexpr uint32_t codecMask(const Compression_t _codec)
+    {
+      return 1u << static_cast<uint32_t>(_codec);
+    }
+
+    /// \brief Get the codecs that this build can compress and decompress.
+    /// \return The bit mask of supported codecs. See codecMask().
+    uint32_t GZ_TRANSPORT_VISIBLE supportedCodecs();
+
+    /// \brief Get the maximum size of a compressed message, including its
+    /// header.
+    /// \param[in] _codec The codec.
+    /// \param[in] _size Size of the uncompressed message (bytes).
+    /// \return The maximum compressed size or 0 if the codec is not
+    /// supported.
+    std::size_t GZ_TRANSPORT_VISIBLE maxCompressedSize(
+      const Compression_t _codec, const std::size_t _size);
+
+    /// \brief Compress a serialized message.
+    /// \param[in] _codec The codec.
+    /// \param[in] _data The serialized message.
+    /// \param[in] _size Size of _data (bytes).
+    /// \param[out] _out Buffer for the compressed message.
+    /// \param[in] _capacity Size of _out, at least maxCompressedSize().
+    /// \return The size of the compressed message or 0 if the message could
+    /// not be compressed or the result is not smaller than the input.
+    std::size_t GZ_TRANSPORT_VISIBLE compress(const Compression_t _codec,
+      const char *_data, const std::size_t _size, char *_out,
+      const std::size_t _capacity);
+
+    /// \brief Check if a received message is compressed.
+    /// \param[in] _data The received message.
+    /// \param[in] _size Size of _data (bytes).
+    /// \return True if the message starts with a compression header.
+    bool GZ_TRANSPORT_VISIBLE isCompressed(const char *_data,
+                                           const std::size_t _size);
+
+    /// \brief Decompress a message created with compress(). The
+    /// uncompressed size stored in the header is checked against the
+    /// maximum ratio of the codec before allocating any memory.
+    /// \param[in] _data The compressed message.
+    /// \param[in] _size Size of _data (bytes).
+    /// \param[out] _out The serialized message.
+    /// \param[in] _maxSize Largest uncompressed size accepted (bytes).
+    /// \return True on success or false if the message is corrupt, too big
+    /// or its codec is not supported.
+    bool GZ_TRANSPORT_VISIBLE decompress(const char *_data,
+      const std::size_t _size, std::string &_out,
+      const std::size_t _maxSize = kDefaultMaxDecompressedSize);
+    }
+  }
+}
+
+#endif
@@ -64,6 +64,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <string>
 #include <thread>
 #include <vector>
@@ -77,6 +78,7 @@
 #include "gz/transport/Publisher.hh"
 #include "gz/transport/TopicStorage.hh"
 #include "gz/transport/TransportTypes.hh"
+#include "gz/transport/WakeupChannel.hh"
 
 namespace gz
 {
@@ -105,6 +107,20 @@ namespace gz
       const std::vector<int> &_sockets,
       const int _timeout);
 
+    /// \internal
+    /// \brief Discovery helper function to poll sockets until they receive
+    /// data, the timeout expires or a wakeup channel is notified.
+    /// \param[in] _sockets Sockets on which to listen.
+    /// \param[in] _timeout Length of time to poll (milliseconds). A negative
+    /// value waits indefinitely.
+    /// \param[in] _wakeup Channel used to interrupt the poll. Its pending
+    /// notifications are consumed.
+    /// \return True if the sockets received a reply.
+    bool GZ_TRANSPORT_VISIBLE pollSockets(
+      const std::vector<int> &_sockets,
+      const int _timeout,
+      WakeupChannel &_wakeup);
+
     /// \class Discovery Discovery.hh gz/transport/Discovery.hh
     /// \brief A discovery class that implements a distributed topic discovery
     /// protocol. It uses UDP multicast for sending/receiving messages and
@@ -269,6 +285,7 @@ namespace gz
         this->exitMutex.lock();
         this->exit = true;
         this->exitMutex.unlock();
+        this->wakeup.Notify();
 
         // Wait for the service threads to finish before exit.
         if (this->threadReception.joinable())
@@ -329,6 +346,9 @@ namespace gz
           // Add the addressing information (local publisher).
           if (!this->info.AddPublisher(_publisher))
             return false;
+
+          // The next heartbeat has to include the new publisher.
+          this->heartbeatDatagrams.reset();
         }
 
         // Only advertise a message outside this process if the scope
@@ -456,6 +476,9 @@ namespace gz
 
           // Remove the topic information.
           this->info.DelPublisherByNode(_topic, this->pUuid, _nUuid);
+
+          // The next heartbeat can't include the removed publisher.
+          this->heartbeatDatagrams.reset();
         }
 
         // Only unadvertise a message outside this process if the scope
@@ -672,6 +695,7 @@ namespace gz
               uuids.push_back(it->first);
 
               // Remove the activity entry.
+              this->packedPeers.erase(it->first);
               this->activity.erase(it++);
             }
             else
@@ -708,26 +732,59 @@ namespace gz
             return;
         }
 
-        Publisher pub("", "", this->pUuid, "", AdvertiseOptions());
-        this->SendMsg(DestinationType::ALL, msgs::Discovery::HEARTBEAT, pub);
-
-        std::map<std::string, std::vector<Pub>> nodes;
+        // The heartbeat re-advertises the topics that are advertised inside
+        // this process. The datagrams are only rebuilt after the local
+        // publishers change.
+        std::shared_ptr<const HeartbeatDatagrams> datagrams;
+        bool legacyPeers = false;
         {
           std::lock_guard<std::mutex> lock(this->mutex);
 
-          // Re-advertise topics that are advertised inside this process.
-          this->info.PublishersByProc(this->pUuid, nodes);
-        }
+          if (!this->heartbeatDatagrams)
+          {
+            std::map<std::string, std::vector<Pub>> nodes;
+            this->info.PublishersByProc(this->pUuid, nodes);
+            this->heartbeatDatagrams = this->BuildHeartbeatDatagrams(nodes);
+          }
+          datagrams = this->heartbeatDatagrams;
 
-        for (const auto &topic : nodes)
-        {
-          for (const auto &node : topic.second)
+          // The packed datagrams are only sent alone when all the known
+          // peers have sent packed datagrams themselves.
+          for (const auto &proc : this->activity)
           {
-            this->SendMsg(DestinationType::ALL,
-                msgs::Discovery::ADVERTISE, node);
+            if (this->packedPeers.find(proc.first) == this->packedPeers.end())
+            {
+              legacyPeers = true;
+              break;
+            }
           }
         }
 
+        // Peers that don't unpack the datagrams get one message per datagram.
+        // The other peers also get the first packed datagram, which tells
+        // them that this process unpacks the datagrams too.
+        const HeartbeatFrames &frames =
+          legacyPeers ? datagrams->legacy : datagrams->packed;
+
+        if (legacyPeers && !datagrams->packed.multicast.empty())
+        {
+          this->SendMulticastDatagram(datagrams->packed.multicast.front());
+          this->SendUnicastDatagram(datagrams->packed.unicast.front());
+        }
+
+        for (const auto &datagram : frames.multicast)
+          this->SendMulticastDatagram(datagram);
+
+        for (const auto &datagram : frames.unicast)
+          this->SendUnicastDatagram(datagram);
+
+        if (this->verbose)
+        {
+          std::cout << "\t* Sending HEARTBEAT in "
+                    << frames.multicast.size() + (legacyPeers ? 1 : 0)
+                    << " datagram(s)" << std::endl;
+        }
+
         {
           std::lock_guard<std::mutex> lock(this->mutex);
           if (!this->initialized)
@@ -749,6 +806,96 @@ namespace gz
         }
       }
 
+      /// \brief Serialized datagrams of one heartbeat.
+      private: struct HeartbeatFrames
+      {
+        /// \brief Datagrams sent to the multicast group.
+        public: std::vector<std::string> multicast;
+
+        /// \brief Datagrams sent to the unicast relays, with the RELAY flag.
+        public: std::vector<std::string> unicast;
+      };
+
+      /// \brief Serialized datagrams sent on each heartbeat.
+      private: struct HeartbeatDatagrams
+      {
+        /// \brief Datagrams with multiple messages, each one starting with
+        /// an empty frame.
+        public: HeartbeatFrames packed;
+
+        /// \brief Datagrams with one message each.
+        public: HeartbeatFrames legacy;
+      };
+
+      /// \brief Build the datagrams sent on each heartbeat. The first packed
+      /// datagram starts with the HEARTBEAT message and the ADVERTISE
+      /// messages of the local publishers are packed after it, up to
+      /// kMaxDatagramSize bytes per datagram. The same messages are also
+      /// serialized in one datagram each, for the peers that don't unpack
+      /// the datagrams.
+      /// \param[in] _nodes Publishers advertised inside this process.
+      /// \return The serialized datagrams.
+      private: std::shared_ptr<const HeartbeatDatagrams>
+        BuildHeartbeatDatagrams(
+          const std::map<std::string, std::vector<Pub>> &_nodes) const
+      {
+        auto datagrams = std::make_shared<HeartbeatDatagrams>();
+
+        // Append a message to the last packed datagram or start a new one if
+        // the message doesn't fit. A single message larger than
+        // kMaxDatagramSize is sent in its own packed datagram.
+        auto append = [this](gz::msgs::Discovery &_msg,
+                             std::vector<std::string> &_packed,
+                             std::vector<std::string> &_legacy)
+        {
+          std::string frame;
+          if (!this->SerializeFrame(_msg, frame))
+            return;
+
+          if (_packed.empty() ||
+              _packed.back().size() + frame.size() > kMaxDatagramSize)
+          {
+            _packed.push_back(std::string(sizeof(uint16_t), '\0'));
+          }
+          _packed.back() += frame;
+          _legacy.push_back(std::move(frame));
+        };
+
+        // The unicast relays receive the same messages with the RELAY flag.
+        auto appendAll = [&](gz::msgs::Discovery &_msg)
+        {
+          append(_msg, datagrams->packed.multicast,
+            datagrams->legacy.multicast);
+          _msg.mutable_flags()->set_relay(true);
+          append(_msg, datagrams->packed.unicast, datagrams->legacy.unicast);
+        };
+
+        gz::msgs::Discovery heartbeatMsg;
+        heartbeatMsg.set_version(this->Version());
+        heartbeatMsg.set_type(msgs::Discovery::HEARTBEAT);
+        heartbeatMsg.set_process_uuid(this->pUuid);
+        appendAll(heartbeatMsg);
+
+        for (const auto &topic : _nodes)
+        {
+          for (const auto &node : topic.second)
+          {
+            // Remote processes ignore the publishers with 'Process' scope.
+            if (node.Options().Scope() == Scope_t::PROCESS)
+              continue;
+
+            gz::msgs::Discovery advertiseMsg;
+            advertiseMsg.set_version(this->Version());
+            advertiseMsg.set_type(msgs::Discovery::ADVERTISE);
+            advertiseMsg.set_process_uuid(this->pUuid);
+            node.FillDiscovery(advertiseMsg);
+            appendAll(advertiseMsg);
+          }
+        }
+
+        return datagrams;
+      }
+
       /// \brief Calculate the next timeout. There are three main activities to
       /// perform by the discovery component:
       /// 1. Receive discovery messages.
@@ -756,7 +903,8 @@ namespace gz
       /// 3. Maintain the discovery information up to date.
       ///
       /// Tasks (2) and (3) need to be checked at fixed intervals. This function
-      /// calculates the next timeout to satisfy (2) and (3).
+      /// calculates the next timeout to satisfy (2) and (3). Between them,
+      /// the thread only wakes up to receive messages or to exit.
       /// \return A timeout (milliseconds).
       private: int NextTimeout() const
       {
@@ -767,8 +915,7 @@ namespace gz
         int t = static_cast<int>(
           std::chrono::duration_cast<std::chrono::milliseconds>
             (std::min(timeUntilNextHeartbeat, timeUntilNextActivity)).count());
-        int t2 = std::min(t, this->kTimeout);
-        return std::max(t2, 0);
+        return std::max(t, 0);
       }
 
       /// \brief Receive discovery messages.
@@ -780,7 +927,7 @@ namespace gz
           // Calculate the timeout.
           int timeout = this->NextTimeout();
 
-          if (pollSockets(this->sockets, timeout))
+          if (pollSockets(this->sockets, timeout, this->wakeup))
           {
             this->RecvDiscoveryUpdate();
 
@@ -815,7 +962,6 @@ namespace gz
         if (received > 0)
         {
           uint16_t len = 0;
-          memcpy(&len, &rcvStr[0], sizeof(len));
 
           // Gazebo Transport delimits each discovery message with a
           // frame_delimiter that contains byte size information.
@@ -837,20 +983,44 @@ namespace gz
           // It is possible that two incompatible versions of Gazebo
           // Transport exist on the same network. If we receive an
           // unexpected size, then we ignore the message.
+          //
+          // The heartbeat might also pack multiple discovery messages, e.g.
+          // the heartbeat followed by the advertisements of the sender, in
+          // a datagram that starts with an empty frame:
+          //
+          // <0><frame_delimiter><frame_body><frame_delimiter><frame_body>...
+          //
+          // Versions that don't unpack these datagrams ignore them, because
+          // the first frame_delimiter doesn't match the size of the
+          // datagram. A frame that exceeds the datagram discards the rest of
+          // it.
+          memcpy(&len, &rcvStr[0], sizeof(len));
+          const bool packed = len == 0;
 
           // If-condition for version 8+
-          if (len + sizeof(len) == static_cast<uint16_t>(received))
+          if (!packed && len + sizeof(len) != static_cast<uint16_t>(received))
+            return;
+
+          std::string srcAddr = inet_ntoa(clntAddr.sin_addr);
+          uint16_t srcPort = ntohs(clntAddr.sin_port);
+
+          if (this->verbose)
           {
-            std::string srcAddr = inet_ntoa(clntAddr.sin_addr);
-            uint16_t srcPort = ntohs(clntAddr.sin_port);
+            std::cout << "\nReceived discovery update from "
+              << srcAddr << ": " << srcPort << std::endl;
+          }
 
-            if (this->verbose)
-            {
-              std::cout << "\nReceived discovery update from "
-                << srcAddr << ": " << srcPort << std::endl;
-            }
+          int32_t offset = packed ? static_cast<int32_t>(sizeof(len)) : 0;
+          while (offset + static_cast<int32_t>(sizeof(len)) <= received)
+          {
+            memcpy(&len, &rcvStr[offset], sizeof(len));
+            offset += static_cast<int32_t>(sizeof(len));
 
-            this->DispatchDiscoveryMsg(srcAddr, rcvStr + sizeof(len), len);
+            if (offset + len > received)
+              break;
+
+            this->DispatchDiscoveryMsg(srcAddr, rcvStr + offset, len, packed);
+            offset += len;
           }
         }
         else if (received < 0)
@@ -864,8 +1034,11 @@ namespace gz
       /// \param[in] _fromIp IP address of the message sender.
       /// \param[in] _msg Received message.
       /// \param[in] _len Entire length of the package in octets.
+      /// \param[in] _packed Whether the message was received in a packed
+      /// datagram.
       private: void DispatchDiscoveryMsg(const std::string &_fromIp,
-                                         char *_msg, uint16_t _len)
+                                         char *_msg, uint16_t _len,
+                                         bool _packed)
       {
         gz::msgs::Discovery msg;
 
@@ -929,6 +1102,8 @@ namespace gz
         {
           std::lock_guard<std::mutex> lock(this->mutex);
           this->activity[recvPUuid] = std::chrono::steady_clock::now();
+          if (_packed)
+            this->packedPeers.insert(recvPUuid);
           connectCb = this->connectionCb;
           disconnectCb = this->disconnectionCb;
           registerCb = this->registrationCb;
@@ -1044,6 +1219,7 @@ namespace gz
             {
               std::lock_guard<std::mutex> lock(this->mutex);
               this->activity.erase(recvPUuid);
+              this->packedPeers.erase(recvPUuid);
             }
 
             if (disconnectCb)
@@ -1161,9 +1337,13 @@ namespace gz
         }
       }
 
-      /// \brief Send a discovery message through all unicast relays.
+      /// \brief Serialize a discovery message preceded by its frame
+      /// delimiter.
       /// \param[in] _msg Discovery message.
-      private: void SendUnicast(const msgs::Discovery &_msg) const
+      /// \param[out] _frame The serialized frame.
+      /// \return True if the message was serialized or false otherwise.
+      private: bool SerializeFrame(const msgs::Discovery &_msg,
+                                   std::string &_frame) const
       {
         uint16_t msgSize;
 
@@ -1176,105 +1356,101 @@ namespace gz
         {
           std::cerr << "Discovery message too large to send. Discovery won't "
             << "work. This shouldn't happen.\n";
-          return;
+          return false;
         }
         msgSize = msgSizeFull;
 
-        uint16_t totalSize = sizeof(msgSize) + msgSize;
-        char *buffer = static_cast<char *>(new char[totalSize]);
-        memcpy(&buffer[0], &msgSize, sizeof(msgSize));
+        _frame.resize(sizeof(msgSize) + msgSize);
+        memcpy(&_frame[0], &msgSize, sizeof(msgSize));
 
-        if (_msg.SerializeToArray(buffer + sizeof(msgSize), msgSize))
+        if (!_msg.SerializeToArray(&_frame[sizeof(msgSize)], msgSize))
         {
-          // Send the discovery message to the unicast relays.
-          for (const auto &sockAddr : this->relayAddrs)
-          {
-            errno = 0;
-            auto sent = sendto(this->sockets.at(0),
-              reinterpret_cast<const raw_type *>(
-                reinterpret_cast<const unsigned char*>(buffer)),
-              totalSize, 0,
-              reinterpret_cast<const sockaddr *>(&sockAddr),
-              sizeof(sockAddr));
-
-            if (sent != totalSize)
-            {
-              std::cerr << "Exception sending a unicast message:" << std::endl;
-              std::cerr << "  Return value: " << sent << std::endl;
-              std::cerr << "  Error code: " << strerror(errno) << std::endl;
-              break;
-            }
-          }
-        }
-        else
-        {
-          std::cerr << "Discovery::SendUnicast: Error serializing data."
+          std::cerr << "Discovery::SerializeFrame: Error serializing data."
             << std::endl;
+          return false;
         }
 
-        delete [] buffer;
+        return true;
       }
 
-      /// \brief Send a discovery message through the multicast group.
+      /// \brief Send a discovery message through all unicast relays.
       /// \param[in] _msg Discovery message.
-      private: void SendMulticast(const msgs::Discovery &_msg) const
+      private: void SendUnicast(const msgs::Discovery &_msg) const
       {
-        uint16_t msgSize;
+        std::string frame;
+        if (this->SerializeFrame(_msg, frame))
+          this->SendUnicastDatagram(frame);
+      }
 
-#if GOOGLE_PROTOBUF_VERSION >= 3004000
-        size_t msgSizeFull = _msg.ByteSizeLong();
-#else
-        int msgSizeFull = _msg.ByteSize();
-#endif
-        if (msgSizeFull + sizeof(msgSize) > this->kMaxRcvStr)
+      /// \brief Send a serialized datagram through all unicast relays.
+      /// \param[in] _datagram One or more serialized frames.
+      private: void SendUnicastDatagram(const std::string &_datagram) const
+      {
+        uint16_t totalSize = static_cast<uint16_t>(_datagram.size());
+
+        // Send the discovery message to the unicast relays.
+        for (const auto &sockAddr : this->relayAddrs)
         {
-          std::cerr << "Discovery message too large to send. Discovery won't "
-            << "work. This shouldn't happen.\n";
-          return;
+          errno = 0;
+          auto sent = sendto(this->sockets.at(0),
+            reinterpret_cast<const raw_type *>(
+              reinterpret_cast<const unsigned char*>(_datagram.data())),
+            totalSize, 0,
+            reinterpret_cast<const sockaddr *>(&sockAddr),
+            sizeof(sockAddr));
+
+          if (sent != totalSize)
+          {
+            std::cerr << "Exception sending a unicast message:" << std::endl;
+            std::cerr << "  Return value: " << sent << std::endl;
+            std::cerr << "  Error code: " << strerror(errno) << std::endl;
+            break;
+          }
         }
+      }
 
-        msgSize = msgSizeFull;
-        uint16_t totalSize = sizeof(msgSize) + msgSize;
-        char *buffer = static_cast<char *>(new char[totalSize]);
-        memcpy(&buffer[0], &msgSize, sizeof(msgSize));
+      /// \brief Send a discovery message through the multicast group.
+      /// \param[in] _msg Discovery message.
+      private: void SendMulticast(const msgs::Discovery &_msg) const
+      {
+        std::string frame;
+        if (this->SerializeFrame(_msg, frame))
+          this->SendMulticastDatagram(frame);
+      }
+
+      /// \brief Send a serialized datagram through the multicast group.
+      /// \param[in] _datagram One or more serialized frames.
+      private: void SendMulticastDatagram(const std::string &_datagram) const
+      {
+        uint16_t totalSize = static_cast<uint16_t>(_datagram.size());
 
-        if (_msg.SerializeToArray(buffer + sizeof(msgSize), msgSize))
+        // Send the discovery message to the multicast group through all the
+        // sockets.
+        for (const auto &sock : this->Sockets())
         {
-          // Send the discovery message to the multicast group through all the
-          // sockets.
-          for (const auto &sock : this->Sockets())
+          errno = 0;
+          if (sendto(sock, reinterpret_cast<const raw_type *>(
+            reinterpret_cast<const unsigned char*>(_datagram.data())),
+            totalSize, 0,
+            reinterpret_cast<const sockaddr *>(this->MulticastAddr()),
+            sizeof(*(this->MulticastAddr()))) != totalSize)
           {
-            errno = 0;
-            if (sendto(sock, reinterpret_cast<const raw_type *>(
-              reinterpret_cast<const unsigned char*>(buffer)),
-              totalSize, 0,
-              reinterpret_cast<const sockaddr *>(this->MulticastAddr()),
-              sizeof(*(this->MulticastAddr()))) != totalSize)
+            // Ignore EPERM and ENOBUFS errors.
+            //
+            // See issue #106
+            //
+            // Rationale drawn from:
+            //
+            // * https://groups.google.com/forum/#!topic/comp.protocols.tcp-ip/Qou9Sfgr77E
+            // * https://stackoverflow.com/questions/16555101/sendto-dgrams-do-not-block-for-enobufs-on-osx
+            if (errno != EPERM && errno != ENOBUFS)
             {
-              // Ignore EPERM and ENOBUFS errors.
-              //
-              // See issue #106
-              //
-              // Rationale drawn from:
-              //
-              // * https://groups.google.com/forum/#!topic/comp.protocols.tcp-ip/Qou9Sfgr77E
-              // * https://stackoverflow.com/questions/16555101/sendto-dgrams-do-not-block-for-enobufs-on-osx
-              if (errno != EPERM && errno != ENOBUFS)
-              {
-                std::cerr << "Exception sending a multicast message:"
-                  << strerror(errno) << std::endl;
-              }
-              break;
+              std::cerr << "Exception sending a multicast message:"
+                << strerror(errno) << std::endl;
             }
+            break;
           }
         }
-        else
-        {
-          std::cerr << "Discovery::SendMulticast: Error serializing data."
-            << std::endl;
-        }
-
-        delete [] buffer;
       }
 
       /// \brief Get the list of sockets used for discovery.
@@ -1400,9 +1576,6 @@ namespace gz
       /// \brief IP Address used for multicast.
       private: std::string multicastGroup;
 
-      /// \brief Timeout used for receiving messages (ms.).
-      private: const int kTimeout = 250;
-
       /// \brief Longest string to receive.
       private: static const uint16_t kMaxRcvStr =
                std::numeric_limits<uint16_t>::max();
@@ -1411,6 +1584,11 @@ namespace gz
       /// the wire protocol (for discovery or message/service exchange).
       private: static const uint8_t kWireVersion = 10;
 
+      /// \brief Size budget of the datagrams packing multiple discovery
+      /// messages. It keeps them within a typical Ethernet MTU to avoid
+      /// IP fragmentation.
+      private: static const uint16_t kMaxDatagramSize = 1400;
+
       /// \brief Port used to broadcast the discovery messages.
       private: int port;
 
@@ -1459,6 +1637,11 @@ namespace gz
       /// key is the process uuid.
       protected: std::map<std::string, Timestamp> activity;
 
+      /// \brief Process UUIDs of the remote nodes that sent packed
+      /// datagrams. The heartbeat keeps sending one message per datagram
+      /// while any node in 'activity' is missing here.
+      private: std::set<std::string> packedPeers;
+
       /// \brief Print discovery information to stdout.
       private: bool verbose;
 
@@ -1480,6 +1663,10 @@ namespace gz
       /// \brief Time at which the next heartbeat cycle will be sent.
       private: Timestamp timeNextHeartbeat;
 
+      /// \brief Cached heartbeat datagrams. It's reset when the publishers
+      /// advertised inside this process change.
+      private: std::shared_ptr<const HeartbeatDatagrams> heartbeatDatagrams;
+
       /// \brief Time at which the next activity check will be done.
       private: Timestamp timeNextActivity;
 
@@ -1501,6 +1688,9 @@ namespace gz
       /// \brief When true, the service thread will finish.
       private: bool exit;
 
+      /// \brief Wakes up the reception thread when it has to exit.
+      private: WakeupChannel wakeup;
+
       /// \brief When true, the service is enabled.
       private: bool enabled;
     };
@@ -21,9 +21,12 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "gz/transport/config.hh"
+#include "gz/transport/InternTable.hh"
 #include "gz/transport/TransportTypes.hh"
 
 namespace gz
@@ -36,6 +39,15 @@ namespace gz
     /// \class HandlerStorage HandlerStorage.hh
     /// gz/transport/HandlerStorage.hh
     /// \brief Class to store and manage service call handlers.
+    ///
+    /// Besides the maps read by most functions, which must be protected by
+    /// the caller, a storage constructed with snapshots enabled keeps an
+    /// immutable list of handlers per interned topic. Every change publishes
+    /// a new index of lists with std::atomic_store(), so Snapshot() doesn't
+    /// need the lock of the caller and copies nothing, while the writers pay
+    /// for the copy. Note that the standard library may implement the atomic
+    /// shared_ptr operations with an internal lock, held for the duration
+    /// of a pointer copy.
     template<typename T> class HandlerStorage
     {
       /// \brief Stores all the service call data for each topic. The key of
@@ -49,9 +61,27 @@ namespace gz
       using TopicServiceCalls_M =
         std::map<std::string, UUIDHandler_Collection_M>;
 
+      /// \brief Handlers of a topic, ordered by node UUID and handler UUID.
+      public: using HandlerList = std::vector<std::shared_ptr<T>>;
+
+      /// \brief Immutable list of handlers shared with the readers.
+      public: using HandlerListPtr = std::shared_ptr<const HandlerList>;
+
+      /// \brief Lists of handlers keyed by interned topic name.
+      private: using Index =
+        std::unordered_map<const InternedTopic *, HandlerListPtr>;
+
       /// \brief Constructor.
       public: HandlerStorage() = default;
 
+      /// \brief Constructor.
+      /// \param[in] _snapshots Whether to keep the lists of handlers read by
+      /// Snapshot(), at the cost of copying the index on every change.
+      public: explicit HandlerStorage(const bool _snapshots)
+        : snapshots(_snapshots)
+      {
+      }
+
       /// \brief Destructor.
       public: virtual ~HandlerStorage() = default;
 
@@ -74,6 +104,43 @@ namespace gz
         return true;
       }
 
+      /// \brief Get the handlers of a topic without copying them. This can
+      /// be called concurrently with the functions that add or remove
+      /// handlers, without the lock that protects them.
+      /// \param[in] _topic Interned topic name, see InternTable::Topic(), or
+      /// nullptr.
+      /// \return The handlers of the topic or nullptr if there are none or
+      /// if snapshots are not enabled. The list is not modified after it is
+      /// returned.
+      public: HandlerListPtr Snapshot(const InternedTopic *_topic) const
+      {
+        // The topics with handlers are interned, so a topic that is not
+        // interned has no handlers.
+        if (!_topic)
+          return nullptr;
+
+        auto current = std::atomic_load(&this->index);
+        if (!current)
+          return nullptr;
+
+        auto it = current->find(_topic);
+        if (it == current->end())
+          return nullptr;
+
+        return it->second;
+      }
+
+      /// \brief Get the handlers of a topic without copying them. The name
+      /// is looked up in the InternTable first, so the callers that already
+      /// hold the interned topic should use the other overload.
+      /// \param[in] _topic Topic name.
+      /// \return The handlers of the topic or nullptr if there are none or
+      /// if snapshots are not enabled.
+      public: HandlerListPtr Snapshot(const std::string &_topic) const
+      {
+        return this->Snapshot(InternTable::FindTopic(_topic));
+      }
+
       /// \brief Get the first handler for a topic that matches a specific pair
       /// of request/response types.
       /// \param[in] _topic Topic name.
@@ -118,13 +185,15 @@ namespace gz
         if (this->data.find(_topic) == this->data.end())
           return false;
 
+        // Types received from other processes are not interned.
+        const std::string *typeId = InternTable::Find(_msgTypeName);
         const auto &m = this->data.at(_topic);
         for (const auto &node : m)
         {
           for (const auto &handler : node.second)
           {
-            if (_msgTypeName == handler.second->TypeName() ||
-                handler.second->TypeName() == kGenericMessageType)
+            if (typeId ? handler.second->AcceptsType(typeId) :
+                         handler.second->AcceptsType(_msgTypeName))
             {
               _handler = handler.second;
               return true;
@@ -179,6 +248,8 @@ namespace gz
         // Add/Replace the Req handler.
         this->data[_topic][_nUuid].insert(
           std::make_pair(_handler->HandlerUuid(), _handler));
+
+        this->UpdateSnapshot(_topic);
       }
 
       /// \brief Return true if we have stored at least one request for the
@@ -230,6 +301,9 @@ namespace gz
           }
         }
 
+        if (counter > 0)
+          this->UpdateSnapshot(_topic);
+
         return counter > 0;
       }
 
@@ -248,13 +322,62 @@ namespace gz
             this->data.erase(_topic);
         }
 
+        if (counter > 0)
+          this->UpdateSnapshot(_topic);
+
         return counter > 0;
       }
 
+      /// \brief Rebuild the list of handlers of a topic and publish a new
+      /// index with it.
+      /// \param[in] _topic Topic name.
+      private: void UpdateSnapshot(const std::string &_topic)
+      {
+        if (!this->snapshots)
+          return;
+
+        auto newIndex = std::make_shared<Index>();
+        auto current = std::atomic_load(&this->index);
+        if (current)
+          *newIndex = *current;
+
+        auto topicIt = this->data.find(_topic);
+        if (topicIt == this->data.end())
+        {
+          const InternedTopic *key = InternTable::FindTopic(_topic);
+          if (key)
+            newIndex->erase(key);
+        }
+        else
+        {
+          // The topic is registered by a local handler, so it is interned
+          // along with its decomposed name used by MessageInfo.
+          const InternedTopic *key = InternTable::Topic(_topic);
+
+          auto list = std::make_shared<HandlerList>();
+          for (const auto &node : topicIt->second)
+          {
+            for (const auto &handler : node.second)
+              list->push_back(handler.second);
+          }
+          (*newIndex)[key] = std::move(list);
+        }
+
+        std::atomic_store(&this->index,
+          std::shared_ptr<const Index>(std::move(newIndex)));
+      }
+
       /// \brief Stores all the service call data for each topic. The key of
       /// _data is the topic name. The value is another map, where the key is
       /// the node UUID and the value is a smart pointer to the handler.
       private: TopicServiceCalls_M data;
+
+      /// \brief Whether the lists of handlers read by Snapshot() are kept.
+      private: bool snapshots = false;
+
+      /// \brief Lists of handlers read by Snapshot(). Replaced as a whole
+      /// on every change.
+      private: std::shared_ptr<const Index> index;
     };
     }
   }
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_TRANSPORT_INTERNTABLE_HH_
+#define GZ_TRANSPORT_INTERNTABLE_HH_
+
+#include <cstddef>
+#include <string>
+
+#include "gz/transport/config.hh"
+#include "gz/transport/Export.hh"
+
+namespace gz
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE {
+    //
+    /// \brief A fully qualified topic name split in its partition and
+    /// topic, as stored in the InternTable.
+    struct InternedTopic
+    {
+      /// \brief The fully qualified topic name.
+      public: std::string fullyQualified;
+
+      /// \brief The partition. Empty if the name is not valid.
+      public: std::string partition;
+
+      /// \brief The topic name. Empty if the name is not valid.
+      public: std::string topic;
+
+      /// \brief True if the fully qualified name is valid.
+      /// \sa TopicUtils::DecomposeFullyQualifiedTopic
+      public: bool valid = false;
+    };
+
+    /// \class InternTable InternTable.hh gz/transport/InternTable.hh
+    /// \brief Process-wide table of unique instances of the topic and type
+    /// names. Equal names are interned to the same address, so they can be
+    /// compared by pointer and used as keys without hashing them again.
+    ///
+    /// Entries are never removed: the addresses stay valid for the lifetime
+    /// of the process. Only the names registered by local handlers and
+    /// publishers, and the names of the discovered publishers of subscribed
+    /// topics, which are bounded in practice, should be interned. Names
+    /// received in the messages are looked up with Find() and FindTopic(),
+    /// which never add entries.
+    class GZ_TRANSPORT_VISIBLE InternTable
+    {
+      /// \brief Get the unique instance of a string.
+      /// \param[in] _str The string.
+      /// \return Address of the interned copy of _str.
+      public: static const std::string *String(const std::string &_str);
+
+      /// \brief Get the unique instance of a string if it was interned.
+      /// \param[in] _str The string.
+      /// \return Address of the interned copy of _str or nullptr.
+      public: static const std::string *Find(const std::string &_str);
+
+      /// \brief Get the unique instance of a fully qualified topic name,
+      /// decomposed in its partition and topic the first time it is seen.
+      /// \param[in] _fullyQualifiedName The fully qualified topic name.
+      /// \return Address of the interned topic.
+      public: static const InternedTopic *Topic(
+        const std::string &_fullyQualifiedName);
+
+      /// \brief Get the unique instance of a fully qualified topic name if
+      /// it was interned.
+      /// \param[in] _fullyQualifiedName The fully qualified topic name.
+      /// \return Address of the interned topic or nullptr.
+      public: static const InternedTopic *FindTopic(
+        const std::string &_fullyQualifiedName);
+
+      /// \brief Get the number of interned strings and topics.
+      /// \return Number of entries.
+      public: static std::size_t Size();
+    };
+    }
+  }
+}
+#endif
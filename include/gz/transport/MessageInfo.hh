@@ -32,6 +32,7 @@ namespace gz
     inline namespace GZ_TRANSPORT_VERSION_NAMESPACE {
     //
     class MessageInfoPrivate;
+    struct InternedTopic;
 
     /// \brief A class that provides information about the message received.
     class GZ_TRANSPORT_VISIBLE MessageInfo
@@ -51,6 +52,16 @@ namespace gz
       /// \brief Destructor.
       public: ~MessageInfo();
 
+      /// \brief Copy assignment operator.
+      /// \param[in] _other an instance to copy data from
+      /// \return Reference to this object.
+      public: MessageInfo &operator=(const MessageInfo &_other);
+
+      /// \brief Move assignment operator.
+      /// \param[in] _other an instance data is moved from
+      /// \return Reference to this object.
+      public: MessageInfo &operator=(MessageInfo &&_other);  // NOLINT
+
       /// \brief Get the topic name associated to the message.
       /// \return The topic name.
       public: const std::string &Topic() const;
@@ -81,6 +92,25 @@ namespace gz
       /// \sa TopicUtils::FullyQualifiedName
       public: bool SetTopicAndPartition(const std::string &_fullyQualifiedName);
 
+      /// \brief Set both the topic and the partition from an interned fully
+      /// qualified topic name, which was decomposed when it was interned.
+      /// \param[in] _topic The interned topic.
+      /// \return true if the topic and partition were set
+      /// \sa InternTable::Topic
+      public: bool SetTopicAndPartition(const InternedTopic &_topic);
+
+      /// \brief Get the interned instance of the message type name.
+      /// \return The interned type name, or nullptr if the type name is not
+      /// interned.
+      /// \sa InternTable::String
+      public: const std::string *TypeId() const;
+
+      /// \brief Set the name of the message type from its interned instance,
+      /// without looking it up.
+      /// \param[in] _typeId The interned type name, which must not be null.
+      /// \sa InternTable::String
+      public: void SetTypeId(const std::string *_typeId);
+
       /// \brief Whether the message is coming from a node within this process.
       /// \return True when intra-process, false otherwise.
       public: bool IntraProcess() const;
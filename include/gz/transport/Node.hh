@@ -18,6 +18,7 @@
 #define GZ_TRANSPORT_NODE_HH_
 
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -74,6 +75,17 @@ namespace gz
     /// If your buffer reaches the maximum capacity data will be dropped.
     int GZ_TRANSPORT_VISIBLE sndHwm();
 
+    /// \brief Get the number of messages published from this process that
+    /// are waiting to be delivered to the local subscribers.
+    /// \return The number of pending publications.
+    uint64_t GZ_TRANSPORT_VISIBLE publishQueueDepth();
+
+    /// \brief Get the maximum number of messages published from this
+    /// process that have been waiting at the same time to be delivered to
+    /// the local subscribers.
+    /// \return The high-water mark of publishQueueDepth().
+    uint64_t GZ_TRANSPORT_VISIBLE publishQueueHighWater();
+
     /// \brief Block the current thread until a SIGINT or SIGTERM is received.
     /// Note that this function registers a signal handler. Do not use this
     /// function if you want to manage yourself SIGINT/SIGTERM.
@@ -137,6 +149,40 @@ namespace gz
         /// \return true when success.
         public: bool Publish(const ProtoMsg &_msg);
 
+        /// \brief Publish a message owned by the caller without copying it
+        /// for intraprocess subscribers. Local subscribers receive this same
+        /// object, so it must not be modified after this call.
+        /// \param[in] _msg Shared pointer to a google::protobuf message.
+        /// \return true when success.
+        public: bool Publish(std::shared_ptr<const ProtoMsg> _msg);
+
+        /// \brief Publish a message, transferring its ownership to the
+        /// publisher. The message is not copied for intraprocess
+        /// subscribers.
+        /// \param[in] _msg Unique pointer to a google::protobuf message.
+        /// \return true when success.
+        public: template<typename MessageT>
+        bool Publish(std::unique_ptr<MessageT> &&_msg);
+
+        /// \brief Publish a batch of messages with a single lookup of the
+        /// subscribers. Local subscribers receive the messages in order.
+        /// Each message is copied for the intraprocess subscribers, as in
+        /// Publish(const ProtoMsg &).
+        /// \note The whole batch counts as one publication for the
+        /// throttling option: either all the messages are published or none.
+        /// \param[in] _msgs Pointers to the messages. None can be nullptr.
+        /// \return true when success.
+        public: bool PublishBatch(const std::vector<const ProtoMsg *> &_msgs);
+
+        /// \brief Publish a batch of messages owned by the caller without
+        /// copying them for intraprocess subscribers.
+        /// \param[in] _msgs Shared pointers to the messages. None can be
+        /// nullptr, and they must not be modified after this call.
+        /// \return true when success.
+        /// \sa PublishBatch(const std::vector<const ProtoMsg *> &)
+        public: bool PublishBatch(
+          const std::vector<std::shared_ptr<const ProtoMsg>> &_msgs);
+
         /// \brief Publish a raw pre-serialized message.
         ///
         /// \warning This function is only intended for advanced users. The
@@ -162,6 +208,56 @@ namespace gz
           const std::string &_msgData,
           const std::string &_msgType);
 
+        /// \brief Publish a raw pre-serialized message stored in a buffer
+        /// owned by the caller.
+        ///
+        /// The buffer is only read during the call. It is copied only when
+        /// there are remote subscribers, and never for the local ones.
+        /// \param[in] _data Pointer to a serialized google::protobuf message.
+        /// \param[in] _size Size of _data (bytes).
+        /// \param[in] _msgType Message type name.
+        /// \return true when success.
+        /// \sa PublishRaw(const std::string &, const std::string &)
+        public: bool PublishRaw(
+          const void *_data,
+          const std::size_t _size,
+          const std::string &_msgType);
+
+        /// \brief Publish a raw pre-serialized message and transfer the
+        /// ownership of its buffer.
+        ///
+        /// The buffer is handed over to ZeroMQ without copying it when
+        /// publishing to remote subscribers. _ffn is called exactly once
+        /// when the buffer is no longer needed, which may happen after this
+        /// function returns, from a different thread, or immediately if the
+        /// message is not sent. The buffer must not be modified after this
+        /// call.
+        /// \param[in] _data Buffer with a serialized google::protobuf message.
+        /// \param[in] _size Size of _data (bytes).
+        /// \param[in] _ffn Function that releases _data.
+        /// \param[in] _hint Opaque pointer passed to _ffn.
+        /// \param[in] _msgType Message type name.
+        /// \return true when success.
+        /// \sa PublishRaw(const std::string &, const std::string &)
+        public: bool PublishRaw(
+          char *_data,
+          const std::size_t _size,
+          DeallocFunc *_ffn,
+          void *_hint,
+          const std::string &_msgType);
+
+        /// \brief Publish a batch of raw pre-serialized messages with a
+        /// single lookup of the subscribers.
+        /// \note The whole batch counts as one publication for the
+        /// throttling option.
+        /// \param[in] _msgData Serialized google::protobuf messages.
+        /// \param[in] _msgType Message type name of all the messages.
+        /// \return true when success.
+        /// \sa PublishRaw()
+        public: bool PublishRawBatch(
+          const std::vector<std::string> &_msgData,
+          const std::string &_msgType);
+
         /// \brief Check if message publication is throttled. If so, verify
         /// whether the next message should be published or not.
         ///
@@ -241,6 +337,13 @@ namespace gz
       /// \brief Subscribe to a topic registering a callback.
       /// Note that this callback does not include any message information.
       /// In this version the callback is a free function.
+      ///
+      /// In all the versions of Subscribe() and in SubscribeRaw(), the topic
+      /// is a pattern, such as /model/*/pose or /model/**, if the options
+      /// enable SubscribeOptions::SetTopicPattern(). The callback then
+      /// receives the messages of every topic matching the pattern with a
+      /// compatible message type, including the topics advertised later.
+      /// \sa SubscribeOptions::SetTopicPattern
       /// \param[in] _topic Topic to be subscribed.
       /// \param[in] _callback Pointer to the callback function with the
       /// following parameters:
@@ -335,6 +438,24 @@ namespace gz
           ClassT *_obj,
           const SubscribeOptions &_opts = SubscribeOptions());
 
+      /// \brief Subscribe to a topic registering a callback that receives
+      /// the message as a shared pointer. The callback can keep the message
+      /// without copying it. Messages published with
+      /// Publisher::Publish(std::shared_ptr<const ProtoMsg>) are delivered
+      /// to local subscribers without any copy.
+      /// \param[in] _topic Topic to be subscribed.
+      /// \param[in] _callback Lambda function with the following parameters:
+      ///   * _msg Shared pointer to the protobuf message received.
+      ///   * _info Message information (e.g.: topic name).
+      /// \param[in] _opts Subscription options.
+      /// \return true when successfully subscribed or false otherwise.
+      public: template<typename MessageT>
+      bool Subscribe(
+          const std::string &_topic,
+          std::function<void(const std::shared_ptr<const MessageT> &_msg,
+                             const MessageInfo &_info)> &_callback,
+          const SubscribeOptions &_opts = SubscribeOptions());
+
       /// \brief Get the list of topics subscribed by this node. Note that
       /// we might be interested in one topic but we still don't know the
       /// address of a publisher.
@@ -342,7 +463,10 @@ namespace gz
       /// have an address for a particular topic yet).
       public: std::vector<std::string> SubscribedTopics() const;
 
-      /// \brief Unsubscribe from a topic.
+      /// \brief Unsubscribe from a topic. If the node subscribed to a pattern
+      /// with this name, the node is unsubscribed from the pattern and the
+      /// topics matching it, except the ones that the node subscribed to
+      /// explicitly.
       /// \param[in] _topic Topic name to be unsubscribed.
       /// \return true when successfully unsubscribed or false otherwise.
       public: bool Unsubscribe(const std::string &_topic);
@@ -731,6 +855,16 @@ namespace gz
       public: std::optional<TopicStatistics> TopicStats(
                   const std::string &_topic) const;
 
+      /// \brief Get the number of messages dropped on a topic in this
+      /// process because a queue configured with a queue depth was full.
+      /// The messages dropped by the sockets when they reach their high
+      /// water marks are not counted.
+      /// \param[in] _topic The name of the topic.
+      /// \return Number of dropped messages.
+      /// \sa AdvertiseMessageOptions::SetLocalQueueDepth
+      /// \sa SubscribeOptions::SetQueueDepth
+      public: uint64_t DroppedMessages(const std::string &_topic) const;
+
       /// \brief Get a pointer to the shared node (singleton shared by all the
       /// nodes).
       /// \return The pointer to the shared node.
@@ -753,6 +887,22 @@ namespace gz
       /// \return True on success.
       private: bool SubscribeHelper(const std::string &_fullyQualifiedTopic);
 
+      /// \brief Helper function for Subscribe with a topic pattern.
+      /// \param[in] _fullyQualifiedPattern Fully qualified topic pattern.
+      /// \param[in] _handler Subscription handler shared by all the topics
+      /// matching the pattern.
+      /// \return True on success.
+      private: bool SubscribePatternHelper(
+        const std::string &_fullyQualifiedPattern,
+        const ISubscriptionHandlerPtr &_handler);
+
+      /// \brief Get the options of a new subscription, after applying the
+      /// node options.
+      /// \param[in] _opts Options passed to Subscribe().
+      /// \return The options of the subscription.
+      private: SubscribeOptions SubscriptionOptions(
+        const SubscribeOptions &_opts) const;
+
 #ifdef _WIN32
 // Disable warning C4251 which is triggered by
 // std::unique_ptr
@@ -126,6 +126,18 @@ namespace gz
       public: bool TopicRemap(const std::string &_fromTopic,
                               std::string &_toTopic) const;
 
+      /// \brief Whether the subscriptions of the node run their callbacks
+      /// on the publishing thread.
+      /// \return True if inline delivery is enabled.
+      /// \sa SetInlineDelivery
+      public: bool InlineDelivery() const;
+
+      /// \brief Enable SubscribeOptions::SetInlineDelivery() for all the
+      /// subscriptions created by the node.
+      /// \param[in] _inline True to enable inline delivery. The default is
+      /// false.
+      public: void SetInlineDelivery(const bool _inline);
+
 #ifdef _WIN32
 // Disable warning C4251 which is triggered by
 // std::unique_ptr
@@ -27,6 +27,7 @@
 #pragma warning(pop)
 #endif
 
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -36,6 +37,7 @@
 #include <map>
 
 #include "gz/transport/config.hh"
+#include "gz/transport/BufferPool.hh"
 #include "gz/transport/Export.hh"
 #include "gz/transport/HandlerStorage.hh"
 #include "gz/transport/Publisher.hh"
@@ -91,6 +93,69 @@ namespace gz
                            DeallocFunc *_ffn,
                            const std::string &_msgType);
 
+      /// \brief Publish data.
+      /// \param[in] _topic Topic to be published.
+      /// \param[in, out] _data Serialized data. Note that this buffer will be
+      /// automatically deallocated by ZMQ when all data has been published.
+      /// \param[in] _dataSize Data size (bytes).
+      /// \param[in, out] _ffn Deallocation function. This function is
+      /// executed by ZeroMQ when the data is published.
+      /// \param[in] _hint Pointer passed as the second argument of _ffn.
+      /// \param[in] _msgType Message type in string format.
+      /// \param[in] _priority Lane used to send the data.
+      /// \return true when success or false otherwise.
+      public: bool Publish(const std::string &_topic,
+                           char *_data,
+                           const size_t _dataSize,
+                           DeallocFunc *_ffn,
+                           void *_hint,
+                           const std::string &_msgType,
+                           const Priority_t _priority = Priority_t::NORMAL);
+
+      /// \brief A serialized message handed over to PublishBatch(). The
+      /// buffer is released with _ffn(_data, _hint) once ZMQ is done with it.
+      public: struct PublishData
+      {
+        /// \brief Serialized data.
+        public: char *data = nullptr;
+
+        /// \brief Data size (bytes).
+        public: size_t size = 0;
+
+        /// \brief Deallocation function.
+        public: DeallocFunc *ffn = nullptr;
+
+        /// \brief Second argument of the deallocation function.
+        public: void *hint = nullptr;
+
+        /// \brief Compressed copy of the data, created with compress() in a
+        /// buffer of SerializationBufferPool(), or nullptr. It is only sent
+        /// to the remote subscribers that decode its codec and it is
+        /// returned to the pool.
+        public: char *compressed = nullptr;
+
+        /// \brief Size of the compressed copy (bytes).
+        public: size_t compressedSize = 0;
+      };
+
+      /// \brief Publish a batch of messages on the same topic. All the
+      /// messages are sent while holding the mutex only once.
+      /// \param[in] _topic Topic to be published.
+      /// \param[in] _batch Serialized messages. Every buffer is deallocated
+      /// through its deallocation function, even on failure.
+      /// \param[in] _msgType Message type in string format.
+      /// \param[in] _priority Lane used to send the messages.
+      /// \return true when success or false otherwise.
+      public: bool PublishBatch(const std::string &_topic,
+                                const std::vector<PublishData> &_batch,
+                                const std::string &_msgType,
+                                const Priority_t _priority =
+                                  Priority_t::NORMAL);
+
+      /// \brief Get the pool of buffers used to serialize published messages.
+      /// \return Reference to the buffer pool.
+      public: BufferPool &SerializationBufferPool();
+
       /// \brief Method in charge of receiving the topic updates.
       public: void RecvMsgUpdate();
 
@@ -174,6 +239,19 @@ namespace gz
         const std::string &_msgData,
         const HandlerInfo &_handlerInfo);
 
+      /// \brief Call the SubscriptionHandler callbacks (local and raw) for this
+      /// NodeShared without copying the serialized data into a string.
+      /// \param[in] _info Message information.
+      /// \param[in] _msgData The raw serialized data for the message.
+      /// \param[in] _size Size of the serialized data.
+      /// \param[in] _handlerInfo Information for the handlers of this node,
+      /// as generated by CheckHandlerInfo(const std::string&) const
+      public: void TriggerCallbacks(
+        const MessageInfo &_info,
+        const char *_msgData,
+        const std::size_t _size,
+        const HandlerInfo &_handlerInfo);
+
       /// \brief Method in charge of receiving the control updates (when a new
       /// remote subscriber notifies its presence for example).
       /// ToDo: Remove this function when possible.
@@ -268,6 +346,16 @@ namespace gz
       /// If your buffer reaches the maximum capacity data will be dropped.
       public: int SndHwm();
 
+      /// \brief Get the number of intra-process publications waiting for
+      /// the publish thread to run the local callbacks.
+      /// \return The number of publications.
+      public: uint64_t PublishQueueDepth() const;
+
+      /// \brief Get the maximum number of intra-process publications that
+      /// have been waiting for the publish thread at the same time.
+      /// \return The high-water mark of PublishQueueDepth().
+      public: uint64_t PublishQueueHighWater() const;
+
       /// \brief Turn topic statistics on or off.
       /// \param[in] _topic The name of the topic on which to enable or disable
       /// statistics.
@@ -286,6 +374,16 @@ namespace gz
       public: std::optional<TopicStatistics> TopicStats(
                   const std::string &_topic) const;
 
+      /// \brief Get the number of messages dropped on a topic because a
+      /// queue configured with a queue depth was full. The messages dropped
+      /// by the sockets when they reach their high water marks are not
+      /// counted.
+      /// \param[in] _topic Fully qualified topic name.
+      /// \return Number of dropped messages.
+      /// \sa AdvertiseMessageOptions::SetLocalQueueDepth
+      /// \sa SubscribeOptions::SetQueueDepth
+      public: uint64_t DroppedMessages(const std::string &_topic) const;
+
       /// \brief Constructor.
       protected: NodeShared();
 
@@ -297,6 +395,29 @@ namespace gz
       /// return false if any operation on a ZMQ socket triggered an exception.
       private: bool InitializeSockets();
 
+      /// \brief Receive the topic updates of one subscriber shard. See
+      /// GZ_TRANSPORT_RECEPTION_SHARDS.
+      /// \param[in] _shard Index of the shard.
+      private: void RecvMsgUpdate(std::size_t _shard);
+
+      /// \brief Receive the topic updates of a subscriber shard other than
+      /// the first one, which is received by RunReceptionTask().
+      /// \param[in] _shard Index of the shard.
+      private: void RunShardReceptionTask(std::size_t _shard);
+
+      /// \brief Store the handlers of the pattern subscriptions matching a
+      /// topic, as if they had subscribed to it. The caller must hold the
+      /// mutex.
+      /// \param[in] _topic Fully qualified topic name.
+      /// \param[in] _msgType Message type published on the topic.
+      /// \return True if at least one handler was stored.
+      private: bool MatchTopicPatterns(
+        const std::string &_topic, const std::string &_msgType);
+
+      /// \brief Consume the handshake events of the service sockets and
+      /// send the requests and responses that were waiting for them.
+      private: void ProcessServiceConnections();
+
       //////////////////////////////////////////////////
       /////// Declare here other member variables //////
       //////////////////////////////////////////////////
@@ -340,9 +461,6 @@ namespace gz
       /// \brief Remote connections for pub/sub messages.
       private: TopicStorage<MessagePublisher> connections;
 
-      /// \brief List of connected zmq end points for request/response.
-      private: std::vector<std::string> srvConnections;
-
       /// \brief Remote subscribers.
       public: TopicStorage<MessagePublisher> remoteSubscribers;
 #ifdef _WIN32
@@ -396,12 +514,12 @@ namespace gz
             const std::string &_nUuid);
 
         /// \brief Normal local subscriptions.
-        public: HandlerStorage<ISubscriptionHandler> normal;
+        public: HandlerStorage<ISubscriptionHandler> normal{true};
 
         /// \brief Raw local subscriptions. Keeping these separate from
         /// localSubscriptions allows us to avoid an unnecessary deserialization
         /// followed by an immediate reserialization.
-        public: HandlerStorage<RawSubscriptionHandler> raw;
+        public: HandlerStorage<RawSubscriptionHandler> raw{true};
       };
 
       public: HandlerWrapper localSubscribers;
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_TRANSPORT_OVERFLOWPOLICY_HH_
+#define GZ_TRANSPORT_OVERFLOWPOLICY_HH_
+
+#include "gz/transport/config.hh"
+
+namespace gz
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE {
+    //
+    /// \brief This strongly typed enum defines what happens when a new
+    /// message arrives at a bounded queue that is already full.
+    /// \sa AdvertiseMessageOptions::SetLocalQueueDepth
+    /// \sa SubscribeOptions::SetQueueDepth
+    enum class OverflowPolicy
+    {
+      /// \brief Discard the new message (default policy).
+      DROP_NEWEST,
+      /// \brief Discard the oldest queued message to make room for the new
+      /// one.
+      DROP_OLDEST,
+      /// \brief Wait until there is room for the new message, up to a
+      /// timeout. The new message is discarded if the timeout expires.
+      BLOCK
+    };
+    }
+  }
+}
+#endif
@@ -20,6 +20,7 @@
 
 #include <gz/msgs/discovery.pb.h>
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 
@@ -232,6 +233,30 @@ namespace gz
       /// \sa Options.
       public: void SetOptions(const AdvertiseMessageOptions &_opts);
 
+      /// \brief Get the compact topic ID. A non-zero value means that the
+      /// messages of this topic can be sent with a compact binary header
+      /// that replaces the topic, address and type frames.
+      /// \return The topic ID or 0 if the compact header is not supported.
+      /// \sa SetTopicId.
+      public: uint64_t TopicId() const;
+
+      /// \brief Set the compact topic ID.
+      /// \param[in] _topicId New topic ID or 0 to disable the compact header.
+      /// \sa TopicId.
+      public: void SetTopicId(const uint64_t _topicId);
+
+      /// \brief Get the compression codecs that a subscriber can decode or,
+      /// in an advertised publisher, that its process supports. Bit N is set
+      /// when the codec with value N of Compression_t is supported.
+      /// \return The bit mask of supported codecs or 0 if none.
+      /// \sa SetCodecs.
+      public: uint32_t Codecs() const;
+
+      /// \brief Set the compression codecs that a subscriber can decode.
+      /// \param[in] _codecs New bit mask of supported codecs.
+      /// \sa Codecs.
+      public: void SetCodecs(const uint32_t _codecs);
+
       /// \brief Populate a discovery message.
       /// \param[in] _msg Message to fill.
       public: virtual void FillDiscovery(msgs::Discovery &_msg) const final;
@@ -286,7 +311,8 @@ namespace gz
 #pragma warning(pop)
 #endif
 
-      /// \brief Advertise options (e.g.: msgsPerSec).
+      /// \brief Advertise options (e.g.: msgsPerSec). Its private data also
+      /// holds the compact topic ID and the codecs of this publisher.
       private: AdvertiseMessageOptions msgOpts;
     };
 
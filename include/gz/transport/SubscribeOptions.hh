@@ -18,11 +18,13 @@
 #ifndef GZ_TRANSPORT_SUBSCRIBEOPTIONS_HH_
 #define GZ_TRANSPORT_SUBSCRIBEOPTIONS_HH_
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 
 #include "gz/transport/config.hh"
 #include "gz/transport/Export.hh"
+#include "gz/transport/OverflowPolicy.hh"
 
 namespace gz
 {
@@ -66,6 +68,137 @@ namespace gz
       /// \return The maximum number of messages per second.
       public: uint64_t MsgsPerSec() const;
 
+      /// \brief Get the maximum number of messages received from other
+      /// processes waiting in this process for this subscription's callback.
+      /// \return The queue depth or 0 if messages are not queued.
+      /// \sa SetQueueDepth
+      public: uint64_t QueueDepth() const;
+
+      /// \brief Set the maximum number of messages received from other
+      /// processes waiting in this process for this subscription's callback.
+      /// With a non-zero depth, the messages are queued and the callback is
+      /// executed from a pool of threads shared by the queued subscriptions
+      /// (see the GZ_TRANSPORT_CALLBACK_THREADS environment variable), so a
+      /// slow callback does not delay the reception of other topics. When
+      /// the queue is full, the overflow policy decides which message is
+      /// dropped. The depth only applies to the local delivery, after the
+      /// message is received. The messages waiting in the sockets are bounded
+      /// by the socket high water marks (GZ_TRANSPORT_SNDHWM and
+      /// GZ_TRANSPORT_RCVHWM), shared by all the topics.
+      /// \param[in] _depth The queue depth or 0 to execute the callback as
+      /// soon as the message is received (default).
+      /// \sa SetOverflow
+      public: void SetQueueDepth(const uint64_t _depth);
+
+      /// \brief Get the maximum number of messages published from this
+      /// process waiting for this subscription's callback.
+      /// \return The queue depth or 0 if unbounded.
+      /// \sa SetLocalQueueDepth
+      public: uint64_t LocalQueueDepth() const;
+
+      /// \brief Set the maximum number of messages published from this
+      /// process waiting for this subscription's callback. It only applies
+      /// when the local callbacks run on a pool of threads (see the
+      /// GZ_TRANSPORT_LOCAL_CALLBACK_THREADS environment variable). When the
+      /// queue is full, the overflow policy decides which message is
+      /// dropped. Note that with OverflowPolicy::BLOCK, the publish thread
+      /// waits and the local delivery of all topics waits too.
+      /// \param[in] _depth The queue depth or 0 for no limit (default).
+      /// \sa SetOverflow
+      public: void SetLocalQueueDepth(const uint64_t _depth);
+
+      /// \brief Get the policy applied when the queue is full.
+      /// \return The overflow policy.
+      /// \sa SetOverflow
+      public: OverflowPolicy Overflow() const;
+
+      /// \brief Set the policy applied when the queue is full.
+      /// \param[in] _policy The overflow policy. The default is
+      /// OverflowPolicy::DROP_NEWEST.
+      /// \sa SetQueueDepth
+      public: void SetOverflow(const OverflowPolicy _policy);
+
+      /// \brief Get the maximum time that the reception waits for room in
+      /// the queue with OverflowPolicy::BLOCK.
+      /// \return The timeout.
+      public: std::chrono::milliseconds BlockTimeout() const;
+
+      /// \brief Set the maximum time that the reception waits for room in
+      /// the queue with OverflowPolicy::BLOCK. Note that the reception of all
+      /// topics waits.
+      /// \param[in] _timeout The timeout. The default is 100 ms.
+      public: void SetBlockTimeout(const std::chrono::milliseconds &_timeout);
+
+      /// \brief Get the number of latest messages kept for this
+      /// subscription's callback.
+      /// \return The number of messages kept or 0 if disabled.
+      /// \sa SetKeepLast
+      public: uint64_t KeepLast() const;
+
+      /// \brief Deliver only the latest messages, for topics where only the
+      /// most recent value matters. With a non-zero value, the messages are
+      /// queued and the callback is executed from the pool of threads of the
+      /// queued subscriptions (see SetQueueDepth()). Once
+      /// _n messages are waiting, a new message replaces the oldest one
+      /// before it is deserialized, so a slow callback always gets fresh
+      /// data. This applies to messages published from this process too.
+      /// When enabled, it takes precedence over SetQueueDepth() and
+      /// SetOverflow(), and the replaced messages are not counted as dropped.
+      /// \param[in] _n The number of messages kept or 0 to disable (default).
+      public: void SetKeepLast(const uint64_t _n);
+
+      /// \brief Whether the received messages are deserialized in a
+      /// protobuf arena.
+      /// \return True if arena allocation is enabled.
+      /// \sa SetUseArena
+      public: bool UseArena() const;
+
+      /// \brief Deserialize the messages of this subscription in protobuf
+      /// arenas recycled by the subscription, instead of allocating every
+      /// field from the heap. This mostly helps with large nested messages.
+      /// The message passed to a shared pointer callback keeps its arena
+      /// busy until the last copy of the pointer is released.
+      /// \param[in] _useArena True to enable arena allocation. The default
+      /// is false.
+      public: void SetUseArena(const bool _useArena);
+
+      /// \brief Whether the callback runs on the publishing thread for the
+      /// messages published from this process.
+      /// \return True if inline delivery is enabled.
+      /// \sa SetInlineDelivery
+      public: bool InlineDelivery() const;
+
+      /// \brief Run the callback directly from Node::Publisher::Publish()
+      /// for the messages published from this process, instead of handing
+      /// them over to the publish thread. This removes a thread switch from
+      /// tightly coupled pipelines, but the publisher waits for the callback
+      /// and the callback may run concurrently from several publishing
+      /// threads. A callback that publishes back to its own subscription,
+      /// directly or through other inline subscriptions, gets that message
+      /// from the publish thread instead, as do the messages nested too
+      /// deeply. Ignored when SetKeepLast() is enabled. Messages from other
+      /// processes are not affected.
+      /// \param[in] _inline True to enable inline delivery. The default is
+      /// false.
+      /// \sa NodeOptions::SetInlineDelivery
+      public: void SetInlineDelivery(const bool _inline);
+
+      /// \brief Whether the topic of the subscription is a pattern.
+      /// \return True if the topic is a pattern.
+      /// \sa SetTopicPattern
+      public: bool TopicPattern() const;
+
+      /// \brief Interpret the topic of the subscription as a pattern, such
+      /// as /model/*/pose or /model/**. A "*" segment matches one segment of
+      /// a topic and a "**" segment matches any number of them. The callback
+      /// then receives the messages of every topic matching the pattern
+      /// with a compatible message type, including the topics advertised
+      /// later. Without this option, "*" and "**" are literal segments.
+      /// \param[in] _pattern True to subscribe to a pattern. The default is
+      /// false.
+      /// \sa TopicUtils::IsTopicPattern
+      public: void SetTopicPattern(const bool _pattern);
+
 #ifdef _WIN32
 // Disable warning C4251 which is triggered by
 // std::unique_ptr
@@ -34,13 +34,16 @@
 #include <chrono>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 
 #include <gz/msgs/Factory.hh>
 
+#include "gz/transport/ArenaPool.hh"
 #include "gz/transport/config.hh"
 #include "gz/transport/Export.hh"
+#include "gz/transport/InternTable.hh"
 #include "gz/transport/MessageInfo.hh"
 #include "gz/transport/SubscribeOptions.hh"
 #include "gz/transport/TransportTypes.hh"
@@ -72,6 +75,25 @@ namespace gz
       /// \return String representation of the message type.
       public: virtual std::string TypeName() = 0;
 
+      /// \brief Get the interned type of the messages from which this
+      /// subscriber handler is subscribed. Handlers can be matched against a
+      /// message type by comparing the addresses returned by
+      /// InternTable::String().
+      /// \return The interned TypeName().
+      public: const std::string *TypeId();
+
+      /// \brief Check if this handler accepts messages of a type.
+      /// \param[in] _typeId Interned message type.
+      /// \return True if the handler subscribes to _typeId or to any type.
+      public: bool AcceptsType(const std::string *_typeId);
+
+      /// \brief Check if this handler accepts messages of a type that is
+      /// not interned, by comparing the names.
+      /// \param[in] _typeName Message type name.
+      /// \return True if the handler subscribes to _typeName or to any
+      /// type.
+      public: bool AcceptsType(const std::string &_typeName);
+
       /// \brief Get the node UUID.
       /// \return The string representation of the node UUID.
       public: std::string NodeUuid() const;
@@ -80,6 +102,10 @@ namespace gz
       /// \return A string representation of the handler UUID.
       public: std::string HandlerUuid() const;
 
+      /// \brief Get the subscribe options.
+      /// \return The options of this subscription.
+      public: const SubscribeOptions &Options() const;
+
       /// \brief Check if message subscription is throttled. If so, verify
       /// whether the callback should be executed or not.
       /// \return true if the callback should be executed or false otherwise.
@@ -104,6 +130,10 @@ namespace gz
       /// \brief Timestamp of the last callback executed.
       protected: Timestamp lastCbTimestamp;
 
+      /// \brief Interned type name. Derived classes set it in their
+      /// constructor, otherwise TypeId() interns TypeName() on every call.
+      protected: const std::string *typeId = nullptr;
+
       /// \brief Node UUID.
       private: std::string nUuid;
 #ifdef _WIN32
@@ -140,6 +170,16 @@ namespace gz
         const ProtoMsg &_msg,
         const MessageInfo &_info) = 0;
 
+      /// \brief Executes the local callback registered for this handler with
+      /// a message that may be shared with other handlers. The default
+      /// implementation forwards to RunLocalCallback(const ProtoMsg &, ~).
+      /// \param[in] _msg Protobuf message received.
+      /// \param[in] _info Message information (e.g.: topic name).
+      /// \return True when success, false otherwise.
+      public: virtual bool RunLocalCallback(
+        const std::shared_ptr<const ProtoMsg> &_msg,
+        const MessageInfo &_info);
+
       /// \brief Create a specific protobuf message given its serialized data.
       /// \param[in] _data The serialized data.
       /// \param[in] _type The data type.
@@ -147,6 +187,31 @@ namespace gz
       public: virtual const std::shared_ptr<ProtoMsg> CreateMsg(
         const std::string &_data,
         const std::string &_type) const = 0;
+
+      /// \brief Create a specific protobuf message given its serialized data,
+      /// without copying the data. The default implementation copies the
+      /// data and forwards to CreateMsg(const std::string &, ~).
+      /// \param[in] _data The serialized data.
+      /// \param[in] _size Size of the serialized data.
+      /// \param[in] _type The data type.
+      /// \return Pointer to the specific protobuf message.
+      public: virtual const std::shared_ptr<ProtoMsg> CreateMsg(
+        const char *_data,
+        const std::size_t _size,
+        const std::string &_type) const;
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::shared_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+      /// \brief Arenas used to deserialize the messages when enabled with
+      /// SubscribeOptions::SetUseArena(), or nullptr.
+      protected: std::shared_ptr<ArenaPool> arenas;
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
     };
 
     /// \class SubscriptionHandler SubscriptionHandler.hh
@@ -161,20 +226,41 @@ namespace gz
         const SubscribeOptions &_opts = SubscribeOptions())
         : ISubscriptionHandler(_nUuid, _opts)
       {
+        this->typeId = InternTable::String(T().GetTypeName());
       }
 
       // Documentation inherited.
       public: const std::shared_ptr<ProtoMsg> CreateMsg(
         const std::string &_data,
+        const std::string &_type) const
+      {
+        return this->CreateMsg(_data.data(), _data.size(), _type);
+      }
+
+      // Documentation inherited.
+      public: const std::shared_ptr<ProtoMsg> CreateMsg(
+        const char *_data,
+        const std::size_t _size,
         const std::string &/*_type*/) const
       {
         // Instantiate a specific protobuf message
-        auto msgPtr = std::make_shared<T>();
+        std::shared_ptr<T> msgPtr;
+        if (this->arenas)
+        {
+          // The message keeps its arena busy until it is released.
+          auto arena = this->arenas->Acquire();
+          msgPtr = std::shared_ptr<T>(arena,
+            google::protobuf::Arena::CreateMessage<T>(arena.get()));
+        }
+        else
+        {
+          msgPtr = std::make_shared<T>();
+        }
 
         // Create the message using some serialized data
-        if (!msgPtr->ParseFromString(_data))
+        if (!msgPtr->ParseFromArray(_data, static_cast<int>(_size)))
         {
-          std::cerr << "SubscriptionHandler::CreateMsg() error: ParseFromString"
+          std::cerr << "SubscriptionHandler::CreateMsg() error: ParseFromArray"
                     << " failed" << std::endl;
         }
 
@@ -184,7 +270,7 @@ namespace gz
       // Documentation inherited.
       public: std::string TypeName()
       {
-        return T().GetTypeName();
+        return *this->typeId;
       }
 
       /// \brief Set the callback for this handler.
@@ -194,12 +280,19 @@ namespace gz
         this->cb = _cb;
       }
 
+      /// \brief Set a callback receiving the message as a shared pointer.
+      /// \param[in] _cb The callback.
+      public: void SetCallback(const MsgSharedCallback<T> &_cb)
+      {
+        this->sharedCb = _cb;
+      }
+
       // Documentation inherited.
       public: bool RunLocalCallback(const ProtoMsg &_msg,
                                     const MessageInfo &_info)
       {
         // No callback stored.
-        if (!this->cb)
+        if (!this->cb && !this->sharedCb)
         {
           std::cerr << "SubscriptionHandler::RunLocalCallback() error: "
                     << "Callback is NULL" << std::endl;
@@ -216,12 +309,41 @@ namespace gz
         auto msgPtr = google::protobuf::internal::down_cast<const T*>(&_msg);
 #endif
 
-        this->cb(*msgPtr, _info);
+        if (this->cb)
+        {
+          this->cb(*msgPtr, _info);
+        }
+        else
+        {
+          // The message is not owned by us, so the shared callback needs
+          // its own copy.
+          this->sharedCb(std::make_shared<const T>(*msgPtr), _info);
+        }
+        return true;
+      }
+
+      // Documentation inherited.
+      public: bool RunLocalCallback(
+        const std::shared_ptr<const ProtoMsg> &_msg,
+        const MessageInfo &_info)
+      {
+        if (!this->sharedCb)
+          return this->RunLocalCallback(*_msg, _info);
+
+        // Check the subscription throttling option.
+        if (!this->UpdateThrottling())
+          return true;
+
+        this->sharedCb(std::static_pointer_cast<const T>(_msg), _info);
         return true;
       }
 
       /// \brief Callback to the function registered for this handler.
       private: MsgCallback<T> cb;
+
+      /// \brief Callback receiving shared pointers registered for this
+      /// handler.
+      private: MsgSharedCallback<T> sharedCb;
     };
 
     /// \brief Specialized template when the user prefers a callbacks that
@@ -234,6 +356,7 @@ namespace gz
         const SubscribeOptions &_opts = SubscribeOptions())
         : ISubscriptionHandler(_nUuid, _opts)
       {
+        this->typeId = InternTable::String(kGenericMessageType);
       }
 
       // Documentation inherited.
@@ -241,32 +364,37 @@ namespace gz
         const std::string &_data,
         const std::string &_type) const
       {
-        std::shared_ptr<google::protobuf::Message> msgPtr;
+        return this->CreateMsg(_data.data(), _data.size(), _type);
+      }
 
-        const google::protobuf::Descriptor *desc =
-          google::protobuf::DescriptorPool::generated_pool()
-            ->FindMessageTypeByName(_type);
+      // Documentation inherited.
+      public: const std::shared_ptr<ProtoMsg> CreateMsg(
+        const char *_data,
+        const std::size_t _size,
+        const std::string &_type) const
+      {
+        const std::shared_ptr<const ProtoMsg> prototype =
+          this->Prototype(_type);
+        if (!prototype)
+          return nullptr;
 
-        // First, check if we have the descriptor from the generated proto
-        // classes.
-        if (desc)
+        std::shared_ptr<google::protobuf::Message> msgPtr;
+        if (this->arenas)
         {
-          msgPtr.reset(google::protobuf::MessageFactory::generated_factory()
-            ->GetPrototype(desc)->New());
+          // The message keeps its arena busy until it is released.
+          auto arena = this->arenas->Acquire();
+          msgPtr = std::shared_ptr<ProtoMsg>(arena,
+            prototype->New(arena.get()));
         }
         else
         {
-          // Fallback on Gazebo Msgs if the message type is not found.
-          msgPtr = gz::msgs::Factory::New(_type);
+          msgPtr.reset(prototype->New());
         }
 
-        if (!msgPtr)
-          return nullptr;
-
         // Create the message using some serialized data
-        if (!msgPtr->ParseFromString(_data))
+        if (!msgPtr->ParseFromArray(_data, static_cast<int>(_size)))
         {
-          std::cerr << "CreateMsg() error: ParseFromString failed" << std::endl;
+          std::cerr << "CreateMsg() error: ParseFromArray failed" << std::endl;
           return nullptr;
         }
 
@@ -286,12 +414,19 @@ namespace gz
         this->cb = _cb;
       }
 
+      /// \brief Set a callback receiving the message as a shared pointer.
+      /// \param[in] _cb The callback.
+      public: void SetCallback(const MsgSharedCallback<ProtoMsg> &_cb)
+      {
+        this->sharedCb = _cb;
+      }
+
       // Documentation inherited.
       public: bool RunLocalCallback(const ProtoMsg &_msg,
                                     const MessageInfo &_info)
       {
         // No callback stored.
-        if (!this->cb)
+        if (!this->cb && !this->sharedCb)
         {
           std::cerr << "SubscriptionHandler::RunLocalCallback() "
                     << "error: Callback is NULL" << std::endl;
@@ -302,12 +437,92 @@ namespace gz
         if (!this->UpdateThrottling())
           return true;
 
-        this->cb(_msg, _info);
+        if (this->cb)
+        {
+          this->cb(_msg, _info);
+        }
+        else
+        {
+          // The message is not owned by us, so the shared callback needs
+          // its own copy.
+          std::shared_ptr<ProtoMsg> msgCopy(_msg.New());
+          msgCopy->CopyFrom(_msg);
+          this->sharedCb(msgCopy, _info);
+        }
+        return true;
+      }
+
+      // Documentation inherited.
+      public: bool RunLocalCallback(
+        const std::shared_ptr<const ProtoMsg> &_msg,
+        const MessageInfo &_info)
+      {
+        if (!this->sharedCb)
+          return this->RunLocalCallback(*_msg, _info);
+
+        // Check the subscription throttling option.
+        if (!this->UpdateThrottling())
+          return true;
+
+        this->sharedCb(_msg, _info);
         return true;
       }
 
+      /// \brief Get the default instance of a message type. The last type
+      /// found is cached, since a topic usually carries a single type.
+      /// \param[in] _type The message type name.
+      /// \return The default instance or nullptr if the type is unknown.
+      private: std::shared_ptr<const ProtoMsg> Prototype(
+        const std::string &_type) const
+      {
+        std::lock_guard<std::mutex> lk(this->prototypeMutex);
+        if (this->prototype && this->prototypeType == _type)
+          return this->prototype;
+
+        std::shared_ptr<const ProtoMsg> newPrototype;
+
+        const google::protobuf::Descriptor *desc =
+          google::protobuf::DescriptorPool::generated_pool()
+            ->FindMessageTypeByName(_type);
+
+        // First, check if we have the descriptor from the generated proto
+        // classes. Their default instances live as long as the process.
+        if (desc)
+        {
+          newPrototype = std::shared_ptr<const ProtoMsg>(
+            std::shared_ptr<const ProtoMsg>(),
+            google::protobuf::MessageFactory::generated_factory()
+              ->GetPrototype(desc));
+        }
+        else
+        {
+          // Fallback on Gazebo Msgs if the message type is not found.
+          newPrototype = gz::msgs::Factory::New(_type);
+        }
+
+        if (newPrototype)
+        {
+          this->prototypeType = _type;
+          this->prototype = newPrototype;
+        }
+        return newPrototype;
+      }
+
       /// \brief Callback to the function registered for this handler.
       private: MsgCallback<ProtoMsg> cb;
+
+      /// \brief Callback receiving shared pointers registered for this
+      /// handler.
+      private: MsgSharedCallback<ProtoMsg> sharedCb;
+
+      /// \brief Protects prototypeType and prototype.
+      private: mutable std::mutex prototypeMutex;
+
+      /// \brief Type name of the cached prototype.
+      private: mutable std::string prototypeType;
+
+      /// \brief Cached default instance of prototypeType.
+      private: mutable std::shared_ptr<const ProtoMsg> prototype;
     };
 
     //////////////////////////////////////////////////
@@ -19,8 +19,10 @@
 #define GZ_TRANSPORT_TOPICSTORAGE_HH_
 
 #include <algorithm>
+#include <iostream>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "gz/transport/config.hh"
@@ -38,6 +40,11 @@ namespace gz
     /// \class TopicStorage TopicStorage.hh gz/transport/TopicStorage.hh
     /// \brief Store address information about topics and provide convenient
     /// methods for adding new topics, removing them, etc.
+    ///
+    /// The publishers are stored in a hash map keyed by topic, with
+    /// secondary indexes by process and node UUID, by message type and by
+    /// address. Adding or removing a publisher doesn't depend on the number
+    /// of topics, and removing a process only visits its own publishers.
     template<typename T> class TopicStorage
     {
       /// \brief Constructor.
@@ -52,34 +59,27 @@ namespace gz
       /// was already stored).
       public: bool AddPublisher(const T &_publisher)
       {
-        // The topic does not exist.
-        if (this->data.find(_publisher.Topic()) == this->data.end())
-        {
-          // VS2013 is buggy with initializer list here {}
-          this->data[_publisher.Topic()] =
-            std::map<std::string, std::vector<T>>();
-        }
+        auto &entry = this->data[_publisher.Topic()];
 
-        // Check if the process uuid exists.
-        auto &m = this->data[_publisher.Topic()];
-        if (m.find(_publisher.PUuid()) != m.end())
-        {
-          // Check that the Publisher does not exist.
-          auto &v = m[_publisher.PUuid()];
-          auto found = std::find_if(v.begin(), v.end(),
-            [&](const T &_pub)
-            {
-              return _pub.Addr()  == _publisher.Addr() &&
-                     _pub.NUuid() == _publisher.NUuid();
-            });
+        // Check that the Publisher does not exist.
+        auto &v = entry.procs[_publisher.PUuid()];
+        auto found = std::find_if(v.begin(), v.end(),
+          [&](const T &_pub)
+          {
+            return _pub.Addr()  == _publisher.Addr() &&
+                   _pub.NUuid() == _publisher.NUuid();
+          });
 
-          // The publisher was already existing, just exit.
-          if (found != v.end())
-            return false;
-        }
+        // The publisher was already existing, just exit.
+        if (found != v.end())
+          return false;
 
         // Add a new Publisher entry.
-        m[_publisher.PUuid()].push_back(T(_publisher));
+        v.push_back(T(_publisher));
+        ++entry.types[TypeName(_publisher)];
+        ++this->addresses[_publisher.Addr()];
+        ++this->byProc[_publisher.PUuid()][_publisher.NUuid()][
+          _publisher.Topic()];
         return true;
       }
 
@@ -100,29 +100,13 @@ namespace gz
       public: bool HasTopic(const std::string &_topic,
                             const std::string &_type) const
       {
-        if (!this->HasTopic(_topic))
+        auto it = this->data.find(_topic);
+        if (it == this->data.end())
           return false;
 
-        // m is {pUUID=>std::vector<Publisher>}.
-        auto &m = this->data.at(_topic);
-
-        for (auto const &procs : m)
-        {
-          // Vector of publishers for a given topic and pUuid.
-          auto &v = procs.second;
-          auto found = std::find_if(v.begin(), v.end(),
-            [&](const T &_pub)
-            {
-              return _pub.MsgTypeName() == _type ||
-                     _pub.MsgTypeName() == kGenericMessageType;
-            });
-
-          // Type found!
-          if (found != v.end())
-            return true;
-        }
-
-        return false;
+        const auto &types = it->second.types;
+        return types.find(_type) != types.end() ||
+               types.find(kGenericMessageType) != types.end();
       }
 
       /// \brief Return if there is any publisher stored for the given topic and
@@ -134,11 +118,11 @@ namespace gz
       public: bool HasAnyPublishers(const std::string &_topic,
                                     const std::string &_pUuid) const
       {
-        if (!this->HasTopic(_topic))
+        auto it = this->data.find(_topic);
+        if (it == this->data.end())
           return false;
 
-        return this->data.at(_topic).find(_pUuid) !=
-               this->data.at(_topic).end();
+        return it->second.procs.find(_pUuid) != it->second.procs.end();
       }
 
       /// \brief Return if the requested publisher's address is stored.
@@ -146,18 +130,7 @@ namespace gz
       /// \return true if the publisher's address is stored.
       public: bool HasPublisher(const std::string &_addr) const
       {
-        for (auto const &topic : this->data)
-        {
-          for (auto const &proc : topic.second)
-          {
-            for (auto const &pub : proc.second)
-            {
-              if (pub.Addr() == _addr)
-                return true;
-            }
-          }
-        }
-        return false;
+        return this->addresses.find(_addr) != this->addresses.end();
       }
 
       /// \brief Get the address information for a given topic and node UUID.
@@ -172,18 +145,17 @@ namespace gz
                              T &_publisher) const
       {
         // Topic not found.
-        if (this->data.find(_topic) == this->data.end())
+        auto it = this->data.find(_topic);
+        if (it == this->data.end())
           return false;
 
-        // m is {pUUID=>Publisher}.
-        auto &m = this->data.at(_topic);
-
         // pUuid not found.
-        if (m.find(_pUuid) == m.end())
+        auto procIt = it->second.procs.find(_pUuid);
+        if (procIt == it->second.procs.end())
           return false;
 
         // Vector of 0MQ known addresses for a given topic and pUuid.
-        auto &v = m.at(_pUuid);
+        auto &v = procIt->second;
         auto found = std::find_if(v.begin(), v.end(),
           [&](const T &_pub)
           {
@@ -207,10 +179,11 @@ namespace gz
       public: bool Publishers(const std::string &_topic,
                              std::map<std::string, std::vector<T>> &_info) const
       {
-        if (!this->HasTopic(_topic))
+        auto it = this->data.find(_topic);
+        if (it == this->data.end())
           return false;
 
-        _info = this->data.at(_topic);
+        _info = it->second.procs;
         return true;
       }
 
@@ -223,37 +196,40 @@ namespace gz
                                       const std::string &_pUuid,
                                       const std::string &_nUuid)
       {
-        size_t counter = 0;
+        auto it = this->data.find(_topic);
+        if (it == this->data.end())
+          return false;
 
-        // Iterate over all the topics.
-        if (this->data.find(_topic) != this->data.end())
-        {
-          // m is {pUUID=>Publisher}.
-          auto &m = this->data[_topic];
+        // m is {pUUID=>Publisher}.
+        auto &m = it->second.procs;
+        auto procIt = m.find(_pUuid);
+        if (procIt == m.end())
+          return false;
 
-          // The pUuid exists.
-          if (m.find(_pUuid) != m.end())
+        // Vector of 0MQ known addresses for a given topic and pUuid.
+        auto &v = procIt->second;
+        auto removed = std::stable_partition(v.begin(), v.end(),
+          [&](const T &_pub)
           {
-            // Vector of 0MQ known addresses for a given topic and pUuid.
-            auto &v = m[_pUuid];
-            auto priorSize = v.size();
-            v.erase(std::remove_if(v.begin(), v.end(),
-              [&](const T &_pub)
-              {
-                return _pub.NUuid() == _nUuid;
-              }),
-              v.end());
-            counter = priorSize - v.size();
-
-            if (v.empty())
-              m.erase(_pUuid);
+            return _pub.NUuid() != _nUuid;
+          });
+        if (removed == v.end())
+          return false;
 
-            if (m.empty())
-              this->data.erase(_topic);
-          }
+        for (auto pub = removed; pub != v.end(); ++pub)
+        {
+          this->Unindex(it->second, *pub);
+          this->UnindexNode(*pub);
         }
+        v.erase(removed, v.end());
 
-        return counter > 0;
+        if (v.empty())
+          m.erase(procIt);
+
+        if (m.empty())
+          this->data.erase(it);
+
+        return true;
       }
 
       /// \brief Remove all the publishers associated to a given process.
@@ -261,21 +237,36 @@ namespace gz
       /// \return True when at least one address was removed or false otherwise.
       public: bool DelPublishersByProc(const std::string &_pUuid)
       {
-        size_t counter = 0;
+        auto procIt = this->byProc.find(_pUuid);
+        if (procIt == this->byProc.end())
+          return false;
 
-        // Iterate over all the topics.
-        for (auto it = this->data.begin(); it != this->data.end();)
+        // Only the topics of the process are visited. A topic shared by
+        // several nodes of the process is removed on the first visit.
+        for (auto const &node : procIt->second)
         {
-          // m is {pUUID=>Publisher}.
-          auto &m = it->second;
-          counter += m.erase(_pUuid);
-          if (m.empty())
-            this->data.erase(it++);
-          else
-            ++it;
+          for (auto const &topic : node.second)
+          {
+            auto it = this->data.find(topic.first);
+            if (it == this->data.end())
+              continue;
+
+            auto &m = it->second.procs;
+            auto pubs = m.find(_pUuid);
+            if (pubs == m.end())
+              continue;
+
+            for (auto const &pub : pubs->second)
+              this->Unindex(it->second, pub);
+            m.erase(pubs);
+
+            if (m.empty())
+              this->data.erase(it);
+          }
         }
 
-        return counter > 0;
+        this->byProc.erase(procIt);
+        return true;
       }
 
       /// \brief Given a process UUID, the function returns the list of
@@ -288,20 +279,12 @@ namespace gz
       {
         _pubs.clear();
 
-        // Iterate over all the topics.
-        for (auto const &topic : this->data)
-        {
-          // m is {pUUID=>Publisher}.
-          auto &m = topic.second;
-          if (m.find(_pUuid) != m.end())
-          {
-            auto &v = m.at(_pUuid);
-            for (auto const &pub : v)
-            {
-              _pubs[pub.NUuid()].push_back(T(pub));
-            }
-          }
-        }
+        auto procIt = this->byProc.find(_pUuid);
+        if (procIt == this->byProc.end())
+          return;
+
+        for (auto const &node : procIt->second)
+          this->CollectNode(_pUuid, node.first, node.second, _pubs[node.first]);
       }
 
       /// \brief Given a process UUID and the node UUID, the function returns
@@ -315,41 +298,38 @@ namespace gz
       {
         _pubs.clear();
 
-        // Iterate over all the topics.
-        for (auto const &topic : this->data)
-        {
-          // m is {pUUID=>Publisher}.
-          auto const &m = topic.second;
-          if (m.find(_pUuid) != m.end())
-          {
-            auto const &v = m.at(_pUuid);
-            for (auto const &pub : v)
-            {
-              if (pub.NUuid() == _nUuid)
-              {
-                _pubs.push_back(T(pub));
-              }
-            }
-          }
-        }
+        auto procIt = this->byProc.find(_pUuid);
+        if (procIt == this->byProc.end())
+          return;
+
+        auto nodeIt = procIt->second.find(_nUuid);
+        if (nodeIt == procIt->second.end())
+          return;
+
+        this->CollectNode(_pUuid, _nUuid, nodeIt->second, _pubs);
       }
 
       /// \brief Get the list of topics currently stored.
-      /// \param[out] _topics List of stored topics.
+      /// \param[out] _topics List of stored topics, in alphabetical order.
       public: void TopicList(std::vector<std::string> &_topics) const
       {
+        const std::size_t first = _topics.size();
         for (auto const &topic : this->data)
           _topics.push_back(topic.first);
+        std::sort(_topics.begin() + first, _topics.end());
       }
 
       /// \brief Print all the information for debugging purposes.
       public: void Print() const
       {
+        std::vector<std::string> topics;
+        this->TopicList(topics);
+
         std::cout << "---" << std::endl;
-        for (auto const &topic : this->data)
+        for (auto const &topic : topics)
         {
-          std::cout << "[" << topic.first << "]" << std::endl;
-          auto &m = topic.second;
+          std::cout << "[" << topic << "]" << std::endl;
+          auto &m = this->data.at(topic).procs;
           for (auto const &proc : m)
           {
             std::cout << "\tProc. UUID: " << proc.first << std::endl;
@@ -362,10 +342,114 @@ namespace gz
         }
       }
 
-      /// \brief The keys are topics. The values are another map, where the key
-      /// is the process UUID and the value a vector of publishers.
-      private: std::map<std::string,
-                        std::map<std::string, std::vector<T>>> data;
+      /// \brief Publishers of a topic.
+      private: struct TopicEntry
+      {
+        /// \brief The key is the process UUID and the value a vector of
+        /// publishers.
+        public: std::map<std::string, std::vector<T>> procs;
+
+        /// \brief Number of publishers of each message type.
+        public: std::unordered_map<std::string, std::size_t> types;
+      };
+
+      /// \brief Number of topics published by a node, keyed by topic.
+      private: using NodeTopics = std::unordered_map<std::string, std::size_t>;
+
+      /// \brief Message type of a publisher, used by the type index.
+      /// \param[in] _pub The publisher.
+      /// \return The message type.
+      private: static std::string TypeName(const MessagePublisher &_pub)
+      {
+        return _pub.MsgTypeName();
+      }
+
+      /// \brief Publishers without a message type are indexed by an empty
+      /// type.
+      /// \return An empty string.
+      private: static std::string TypeName(
+        const transport::Publisher &/*_pub*/)
+      {
+        return "";
+      }
+
+      /// \brief Remove a publisher from the type and address indexes.
+      /// \param[in, out] _entry Entry of the publisher's topic.
+      /// \param[in] _pub The publisher.
+      private: void Unindex(TopicEntry &_entry, const T &_pub)
+      {
+        auto type = _entry.types.find(TypeName(_pub));
+        if (type != _entry.types.end() && --type->second == 0)
+          _entry.types.erase(type);
+
+        auto addr = this->addresses.find(_pub.Addr());
+        if (addr != this->addresses.end() && --addr->second == 0)
+          this->addresses.erase(addr);
+      }
+
+      /// \brief Remove a publisher from the process and node index.
+      /// \param[in] _pub The publisher.
+      private: void UnindexNode(const T &_pub)
+      {
+        auto procIt = this->byProc.find(_pub.PUuid());
+        if (procIt == this->byProc.end())
+          return;
+
+        auto nodeIt = procIt->second.find(_pub.NUuid());
+        if (nodeIt == procIt->second.end())
+          return;
+
+        auto topic = nodeIt->second.find(_pub.Topic());
+        if (topic != nodeIt->second.end() && --topic->second == 0)
+          nodeIt->second.erase(topic);
+
+        if (nodeIt->second.empty())
+          procIt->second.erase(nodeIt);
+
+        if (procIt->second.empty())
+          this->byProc.erase(procIt);
+      }
+
+      /// \brief Append the publishers of a node.
+      /// \param[in] _pUuid Process UUID.
+      /// \param[in] _nUuid Node UUID.
+      /// \param[in] _topics Topics published by the node.
+      /// \param[out] _pubs Vector where the publishers are appended.
+      private: void CollectNode(const std::string &_pUuid,
+                                const std::string &_nUuid,
+                                const NodeTopics &_topics,
+                                std::vector<T> &_pubs) const
+      {
+        for (auto const &topic : _topics)
+        {
+          auto it = this->data.find(topic.first);
+          if (it == this->data.end())
+            continue;
+
+          auto procIt = it->second.procs.find(_pUuid);
+          if (procIt == it->second.procs.end())
+            continue;
+
+          for (auto const &pub : procIt->second)
+          {
+            if (pub.NUuid() == _nUuid)
+              _pubs.push_back(T(pub));
+          }
+        }
+      }
+
+      /// \brief The keys are topics. The values are the publishers of the
+      /// topic.
+      private: std::unordered_map<std::string, TopicEntry> data;
+
+      /// \brief Index of the topics published by each node. The key is the
+      /// process UUID and the value is another map, where the key is the
+      /// node UUID.
+      private: std::unordered_map<std::string,
+                 std::unordered_map<std::string, NodeTopics>> byProc;
+
+      /// \brief Number of publishers using each address.
+      private: std::unordered_map<std::string, std::size_t> addresses;
     };
     }
   }
@@ -63,6 +63,16 @@ namespace gz
       /// \return true if the topic name is valid.
       public: static bool IsValidTopic(const std::string &_topic);
 
+      /// \brief Determines if a topic name has pattern segments, which
+      /// happens when any of its segments is "*" or "**". A subscription
+      /// with SubscribeOptions::SetTopicPattern() enabled subscribes to all
+      /// the topics matching such a name. Otherwise, those segments are
+      /// literal.
+      /// Examples of patterns: /model/*/pose, /model/**
+      /// \param[in] _topic Topic name to be checked.
+      /// \return true if the topic name is a pattern.
+      public: static bool IsTopicPattern(const std::string &_topic);
+
       /// \brief Get the full topic path given a namespace and a topic name.
       /// A fully qualified topic name's length must not exceed kMaxNameLength.
       /// The fully qualified name follows the next syntax:
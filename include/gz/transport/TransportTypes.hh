@@ -141,6 +141,16 @@ namespace gz
     using MsgCallback =
       std::function<void(const T &_msg, const MessageInfo &_info)>;
 
+    /// \def MsgSharedCallback
+    /// \brief User callback used for receiving messages as shared pointers.
+    /// The callback can keep the message without copying it.
+    ///   \param[in] _msg Protobuf message containing the topic update.
+    ///   \param[in] _info Message information (e.g.: topic name).
+    template <typename T>
+    using MsgSharedCallback =
+      std::function<void(const std::shared_ptr<const T> &_msg,
+                         const MessageInfo &_info)>;
+
     /// \def RawCallback
     /// \brief User callback used for receiving raw message data:
     /// \param[in] _msgData string of a serialized protobuf message
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_TRANSPORT_WAKEUPCHANNEL_HH_
+#define GZ_TRANSPORT_WAKEUPCHANNEL_HH_
+
+#include <memory>
+
+#include "gz/transport/config.hh"
+#include "gz/transport/Export.hh"
+
+namespace gz
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE {
+    //
+    // Forward declarations.
+    class WakeupChannelPrivate;
+
+    /// \class WakeupChannel WakeupChannel.hh gz/transport/WakeupChannel.hh
+    /// \brief Internal channel used to wake up a thread blocked polling its
+    /// sockets, e.g. to stop it or to make it reload its configuration.
+    ///
+    /// The thread adds Socket() to the items that it polls, without a
+    /// timeout, and calls Drain() when the socket is readable. Any other
+    /// thread calls Notify() to wake it up. Notifications sent while the
+    /// polling thread is busy are coalesced.
+    class GZ_TRANSPORT_VISIBLE WakeupChannel
+    {
+      /// \brief Constructor.
+      public: WakeupChannel();
+
+      /// \brief Destructor.
+      public: ~WakeupChannel();
+
+      /// \brief Wake up the polling thread. It can be called from any
+      /// thread.
+      public: void Notify();
+
+      /// \brief Consume the pending notifications. It should only be called
+      /// from the polling thread.
+      /// \return True if there was at least one pending notification.
+      public: bool Drain();
+
+      /// \brief Get the ZMQ socket to poll. It becomes readable when
+      /// Notify() is called.
+      /// \return Pointer to the underlying ZMQ socket.
+      public: void *Socket() const;
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<WakeupChannelPrivate> dataPtr;
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+    };
+    }
+  }
+}
+#endif
@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 
 namespace gz
 {
@@ -36,6 +37,13 @@ namespace gz
       return this->Advertise(_topic, MessageT().GetTypeName(), _options);
     }
 
+    //////////////////////////////////////////////////
+    template<typename MessageT>
+    bool Node::Publisher::Publish(std::unique_ptr<MessageT> &&_msg)
+    {
+      return this->Publish(std::shared_ptr<const ProtoMsg>(std::move(_msg)));
+    }
+
     //////////////////////////////////////////////////
     template<typename MessageT>
     bool Node::Subscribe(
@@ -128,13 +136,21 @@ namespace gz
 
       // Create a new subscription handler.
       std::shared_ptr<SubscriptionHandler<MessageT>> subscrHandlerPtr(
-          new SubscriptionHandler<MessageT>(this->NodeUuid(), _opts));
+          new SubscriptionHandler<MessageT>(this->NodeUuid(),
+            this->SubscriptionOptions(_opts)));
 
       // Insert the callback into the handler.
       subscrHandlerPtr->SetCallback(_cb);
 
       std::lock_guard<std::recursive_mutex> lk(this->Shared()->mutex);
 
+      // A pattern subscribes the handler to every matching topic.
+      if (_opts.TopicPattern())
+      {
+        return this->SubscribePatternHelper(
+          fullyQualifiedTopic, subscrHandlerPtr);
+      }
+
       // Store the subscription handler. Each subscription handler is
       // associated with a topic. When the receiving thread gets new data,
       // it will recover the subscription handler associated to the topic and
@@ -145,6 +161,50 @@ namespace gz
       return this->SubscribeHelper(fullyQualifiedTopic);
     }
 
+    //////////////////////////////////////////////////
+    template<typename MessageT>
+    bool Node::Subscribe(
+        const std::string &_topic,
+        std::function<void(const std::shared_ptr<const MessageT> &_msg,
+                           const MessageInfo &_info)> &_cb,
+        const SubscribeOptions &_opts)
+    {
+      // Topic remapping.
+      std::string topic = _topic;
+      this->Options().TopicRemap(_topic, topic);
+
+      std::string fullyQualifiedTopic;
+      if (!TopicUtils::FullyQualifiedName(this->Options().Partition(),
+        this->Options().NameSpace(), topic, fullyQualifiedTopic))
+      {
+        std::cerr << "Topic [" << topic << "] is not valid." << std::endl;
+        return false;
+      }
+
+      // Create a new subscription handler.
+      std::shared_ptr<SubscriptionHandler<MessageT>> subscrHandlerPtr(
+          new SubscriptionHandler<MessageT>(this->NodeUuid(),
+            this->SubscriptionOptions(_opts)));
+
+      // Insert the callback into the handler.
+      subscrHandlerPtr->SetCallback(_cb);
+
+      std::lock_guard<std::recursive_mutex> lk(this->Shared()->mutex);
+
+      // A pattern subscribes the handler to every matching topic.
+      if (_opts.TopicPattern())
+      {
+        return this->SubscribePatternHelper(
+          fullyQualifiedTopic, subscrHandlerPtr);
+      }
+
+      // Store the subscription handler.
+      this->Shared()->localSubscribers.normal.AddHandler(
+        fullyQualifiedTopic, this->NodeUuid(), subscrHandlerPtr);
+
+      return this->SubscribeHelper(fullyQualifiedTopic);
+    }
+
     //////////////////////////////////////////////////
     template<typename ClassT, typename MessageT>
     bool Node::Subscribe(
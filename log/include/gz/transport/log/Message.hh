@@ -18,6 +18,7 @@
 #define GZ_TRANSPORT_LOG_MESSAGE_HH_
 
 #include <chrono>
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -76,6 +77,16 @@ namespace gz
         /// \return The raw data for this message
         public: std::string Data() const;
 
+        /// \brief Get the message data without copying it
+        /// \return Pointer to the raw data for this message. It is borrowed
+        /// from the creator of this message, like the rest of its contents.
+        /// \sa DataSize()
+        public: const void *RawData() const;
+
+        /// \brief Get the size of the message data
+        /// \return Number of bytes pointed by RawData()
+        public: std::size_t DataSize() const;
+
         /// \brief Get the message type as a string
         /// \return The message type name
         public: std::string Type() const;
@@ -82,6 +82,18 @@ std::string Message::Data() const
       this->dataPtr->dataLen);
 }
 
+//////////////////////////////////////////////////
+const void *Message::RawData() const
+{
+  return this->dataPtr->data;
+}
+
+//////////////////////////////////////////////////
+std::size_t Message::DataSize() const
+{
+  return this->dataPtr->dataLen;
+}
+
 //////////////////////////////////////////////////
 std::string Message::Type() const
 {
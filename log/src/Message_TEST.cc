@@ -29,6 +29,8 @@ TEST(Message, DefaultConstructor)
 {
   transport::log::Message msg;
   EXPECT_EQ(std::string(""), msg.Data());
+  EXPECT_EQ(nullptr, msg.RawData());
+  EXPECT_EQ(0u, msg.DataSize());
   EXPECT_EQ(std::string(""), msg.Topic());
   EXPECT_EQ(std::string(""), msg.Type());
   EXPECT_EQ(0ns, msg.TimeReceived());
@@ -48,6 +50,8 @@ TEST(Message, DataConstructor)
       topic.c_str(), topic.size());
 
   EXPECT_EQ(data, msg.Data());
+  EXPECT_EQ(data.c_str(), msg.RawData());
+  EXPECT_EQ(data.size(), msg.DataSize());
   EXPECT_EQ(msgType, msg.Type());
   EXPECT_EQ(topic, msg.Topic());
   EXPECT_EQ(goldenTime, msg.TimeReceived());
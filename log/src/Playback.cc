@@ -562,7 +562,8 @@ void PlaybackHandle::Implementation::StartPlayback()
           this->publishers[
             this->messageIter->Topic()][
               this->messageIter->Type()].PublishRaw(
-                this->messageIter->Data(), this->messageIter->Type());
+                this->messageIter->RawData(), this->messageIter->DataSize(),
+                this->messageIter->Type());
           // Advance iterator to next message
           ++this->messageIter;
           this->playbackTime = this->nextMessageTime;
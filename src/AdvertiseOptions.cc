@@ -15,6 +15,7 @@
  *
 */
 
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <iostream>
@@ -22,57 +23,11 @@
 #include "gz/transport/AdvertiseOptions.hh"
 #include "gz/transport/Helpers.hh"
 
+#include "AdvertiseOptionsPrivate.hh"
+
 using namespace gz;
 using namespace transport;
 
-namespace gz
-{
-  namespace transport
-  {
-    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE
-    {
-    /// \internal
-    /// \brief Private data for AdvertiseOptions class.
-    class AdvertiseOptionsPrivate
-    {
-      /// \brief Constructor.
-      public: AdvertiseOptionsPrivate() = default;
-
-      /// \brief Destructor.
-      public: virtual ~AdvertiseOptionsPrivate() = default;
-
-      /// \brief Default scope value.
-      public: Scope_t scope = Scope_t::ALL;
-    };
-
-    /// \internal
-    /// \brief Private data for AdvertiseMessageOptions class.
-    class AdvertiseMessageOptionsPrivate
-    {
-      /// \brief Constructor.
-      public: AdvertiseMessageOptionsPrivate() = default;
-
-      /// \brief Destructor.
-      public: virtual ~AdvertiseMessageOptionsPrivate() = default;
-
-      /// \brief Default message publication rate.
-      public: uint64_t msgsPerSec = kUnthrottled;
-    };
-
-    /// \internal
-    /// \brief Private data for AdvertiseServiceOptions class.
-    class AdvertiseServiceOptionsPrivate
-    {
-      /// \brief Constructor.
-      public: AdvertiseServiceOptionsPrivate() = default;
-
-      /// \brief Destructor.
-      public: virtual ~AdvertiseServiceOptionsPrivate() = default;
-    };
-    }
-  }
-}
-
 //////////////////////////////////////////////////
 AdvertiseOptions::AdvertiseOptions()
   : dataPtr(new AdvertiseOptionsPrivate())
@@ -148,6 +103,14 @@ AdvertiseMessageOptions &AdvertiseMessageOptions::operator=(
 {
   AdvertiseOptions::operator=(_other);
   this->SetMsgsPerSec(_other.MsgsPerSec());
+  this->SetLocalQueueDepth(_other.LocalQueueDepth());
+  this->SetOverflow(_other.Overflow());
+  this->SetBlockTimeout(_other.BlockTimeout());
+  this->SetCompression(_other.Compression());
+  this->SetCompressionThreshold(_other.CompressionThreshold());
+  this->SetPriority(_other.Priority());
+  this->dataPtr->topicId = _other.dataPtr->topicId;
+  this->dataPtr->codecs = _other.dataPtr->codecs;
   return *this;
 }
 
@@ -156,7 +119,13 @@ bool AdvertiseMessageOptions::operator==(
   const AdvertiseMessageOptions &_other) const
 {
   return AdvertiseOptions::operator==(_other) &&
-         this->MsgsPerSec() == _other.MsgsPerSec();
+         this->MsgsPerSec() == _other.MsgsPerSec() &&
+         this->LocalQueueDepth() == _other.LocalQueueDepth() &&
+         this->Overflow() == _other.Overflow() &&
+         this->BlockTimeout() == _other.BlockTimeout() &&
+         this->Compression() == _other.Compression() &&
+         this->CompressionThreshold() == _other.CompressionThreshold() &&
+         this->Priority() == _other.Priority();
 }
 
 //////////////////////////////////////////////////
@@ -184,6 +153,79 @@ void AdvertiseMessageOptions::SetMsgsPerSec(const uint64_t _newMsgsPerSec)
   this->dataPtr->msgsPerSec = _newMsgsPerSec;
 }
 
+//////////////////////////////////////////////////
+uint64_t AdvertiseMessageOptions::LocalQueueDepth() const
+{
+  return this->dataPtr->localQueueDepth;
+}
+
+//////////////////////////////////////////////////
+void AdvertiseMessageOptions::SetLocalQueueDepth(const uint64_t _depth)
+{
+  this->dataPtr->localQueueDepth = _depth;
+}
+
+//////////////////////////////////////////////////
+OverflowPolicy AdvertiseMessageOptions::Overflow() const
+{
+  return this->dataPtr->overflow;
+}
+
+//////////////////////////////////////////////////
+void AdvertiseMessageOptions::SetOverflow(const OverflowPolicy _policy)
+{
+  this->dataPtr->overflow = _policy;
+}
+
+//////////////////////////////////////////////////
+std::chrono::milliseconds AdvertiseMessageOptions::BlockTimeout() const
+{
+  return this->dataPtr->blockTimeout;
+}
+
+//////////////////////////////////////////////////
+void AdvertiseMessageOptions::SetBlockTimeout(
+  const std::chrono::milliseconds &_timeout)
+{
+  this->dataPtr->blockTimeout = _timeout;
+}
+
+//////////////////////////////////////////////////
+Compression_t AdvertiseMessageOptions::Compression() const
+{
+  return this->dataPtr->compression;
+}
+
+//////////////////////////////////////////////////
+void AdvertiseMessageOptions::SetCompression(const Compression_t _codec)
+{
+  this->dataPtr->compression = _codec;
+}
+
+//////////////////////////////////////////////////
+uint64_t AdvertiseMessageOptions::CompressionThreshold() const
+{
+  return this->dataPtr->compressionThreshold;
+}
+
+//////////////////////////////////////////////////
+void AdvertiseMessageOptions::SetCompressionThreshold(const uint64_t _bytes)
+{
+  this->dataPtr->compressionThreshold = _bytes;
+}
+
+//////////////////////////////////////////////////
+Priority_t AdvertiseMessageOptions::Priority() const
+{
+  return this->dataPtr->priority;
+}
+
+//////////////////////////////////////////////////
+void AdvertiseMessageOptions::SetPriority(const Priority_t _priority)
+{
+  this->dataPtr->priority = _priority;
+}
+
 //////////////////////////////////////////////////
 AdvertiseServiceOptions::AdvertiseServiceOptions()
   : AdvertiseOptions(),
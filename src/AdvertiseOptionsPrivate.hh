@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2015 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_TRANSPORT_ADVERTISEOPTIONSPRIVATE_HH_
+#define GZ_TRANSPORT_ADVERTISEOPTIONSPRIVATE_HH_
+
+#include <chrono>
+#include <cstdint>
+
+#include "gz/transport/AdvertiseOptions.hh"
+#include "gz/transport/Helpers.hh"
+#include "gz/transport/OverflowPolicy.hh"
+
+namespace gz
+{
+  namespace transport
+  {
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE
+    {
+    /// \internal
+    /// \brief Private data for AdvertiseOptions class.
+    class AdvertiseOptionsPrivate
+    {
+      /// \brief Constructor.
+      public: AdvertiseOptionsPrivate() = default;
+
+      /// \brief Destructor.
+      public: virtual ~AdvertiseOptionsPrivate() = default;
+
+      /// \brief Default scope value.
+      public: Scope_t scope = Scope_t::ALL;
+    };
+
+    /// \internal
+    /// \brief Private data for AdvertiseMessageOptions class.
+    class AdvertiseMessageOptionsPrivate
+    {
+      /// \brief Constructor.
+      public: AdvertiseMessageOptionsPrivate() = default;
+
+      /// \brief Destructor.
+      public: virtual ~AdvertiseMessageOptionsPrivate() = default;
+
+      /// \brief Default message publication rate.
+      public: uint64_t msgsPerSec = kUnthrottled;
+
+      /// \brief Depth of the queue of local publications (0 means
+      /// unbounded).
+      public: uint64_t localQueueDepth = 0;
+
+      /// \brief Overflow policy.
+      public: OverflowPolicy overflow = OverflowPolicy::DROP_NEWEST;
+
+      /// \brief Timeout used with OverflowPolicy::BLOCK.
+      public: std::chrono::milliseconds blockTimeout{100};
+
+      /// \brief Codec used for the remote publications.
+      public: Compression_t compression = Compression_t::NONE;
+
+      /// \brief Minimum size of a compressed message (bytes).
+      public: uint64_t compressionThreshold = 64u * 1024u;
+
+      /// \brief Priority class of the remote publications.
+      public: Priority_t priority = Priority_t::NORMAL;
+
+      /// \brief Compact topic ID of a MessagePublisher or 0 if not
+      /// supported. It is not an option, the MessagePublisher keeps it here
+      /// because its own layout can't change.
+      public: uint64_t topicId = 0;
+
+      /// \brief Bit mask of the compression codecs of a MessagePublisher.
+      /// \sa topicId
+      public: uint32_t codecs = 0;
+    };
+
+    /// \internal
+    /// \brief Private data for AdvertiseServiceOptions class.
+    class AdvertiseServiceOptionsPrivate
+    {
+      /// \brief Constructor.
+      public: AdvertiseServiceOptionsPrivate() = default;
+
+      /// \brief Destructor.
+      public: virtual ~AdvertiseServiceOptionsPrivate() = default;
+    };
+    }
+  }
+}
+#endif
@@ -15,6 +15,7 @@
  *
 */
 
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -111,6 +112,8 @@ TEST(AdvertiseOptionsTest, msgCopyConstructor)
   AdvertiseMessageOptions opts1;
   opts1.SetScope(Scope_t::HOST);
   opts1.SetMsgsPerSec(10u);
+  opts1.SetLocalQueueDepth(3u);
+  opts1.SetOverflow(OverflowPolicy::DROP_OLDEST);
   AdvertiseMessageOptions opts2(opts1);
   EXPECT_EQ(opts1, opts2);
 }
@@ -141,6 +144,22 @@ TEST(AdvertiseOptionsTest, msgEqualityOp)
   opts2.SetMsgsPerSec(10u);
   EXPECT_TRUE(opts1 == opts2);
   EXPECT_FALSE(opts1 != opts2);
+  opts1.SetLocalQueueDepth(2u);
+  EXPECT_FALSE(opts1 == opts2);
+  opts2.SetLocalQueueDepth(2u);
+  EXPECT_TRUE(opts1 == opts2);
+  opts1.SetOverflow(OverflowPolicy::BLOCK);
+  EXPECT_FALSE(opts1 == opts2);
+  opts2.SetOverflow(OverflowPolicy::BLOCK);
+  EXPECT_TRUE(opts1 == opts2);
+  opts1.SetCompression(Compression_t::LZ4);
+  EXPECT_FALSE(opts1 == opts2);
+  opts2.SetCompression(Compression_t::LZ4);
+  EXPECT_TRUE(opts1 == opts2);
+  opts1.SetPriority(Priority_t::BULK);
+  EXPECT_FALSE(opts1 == opts2);
+  opts2.SetPriority(Priority_t::BULK);
+  EXPECT_TRUE(opts1 == opts2);
 }
 
 //////////////////////////////////////////////////
@@ -184,6 +203,30 @@ TEST(AdvertiseOptionsTest, msgAccessors)
   opts.SetMsgsPerSec(10u);
   EXPECT_EQ(opts.MsgsPerSec(), 10u);
   EXPECT_TRUE(opts.Throttled());
+
+  // Queue depth and overflow policy.
+  EXPECT_EQ(opts.LocalQueueDepth(), 0u);
+  EXPECT_EQ(opts.Overflow(), OverflowPolicy::DROP_NEWEST);
+  EXPECT_EQ(opts.BlockTimeout(), std::chrono::milliseconds(100));
+  opts.SetLocalQueueDepth(8u);
+  EXPECT_EQ(opts.LocalQueueDepth(), 8u);
+  opts.SetOverflow(OverflowPolicy::BLOCK);
+  EXPECT_EQ(opts.Overflow(), OverflowPolicy::BLOCK);
+  opts.SetBlockTimeout(std::chrono::milliseconds(5));
+  EXPECT_EQ(opts.BlockTimeout(), std::chrono::milliseconds(5));
+
+  // Compression.
+  EXPECT_EQ(opts.Compression(), Compression_t::NONE);
+  EXPECT_EQ(opts.CompressionThreshold(), 64u * 1024u);
+  opts.SetCompression(Compression_t::ZSTD);
+  EXPECT_EQ(opts.Compression(), Compression_t::ZSTD);
+  opts.SetCompressionThreshold(1000u);
+  EXPECT_EQ(opts.CompressionThreshold(), 1000u);
+
+  // Priority.
+  EXPECT_EQ(opts.Priority(), Priority_t::NORMAL);
+  opts.SetPriority(Priority_t::REALTIME);
+  EXPECT_EQ(opts.Priority(), Priority_t::REALTIME);
 }
 
 //////////////////////////////////////////////////
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "gz/transport/ArenaPool.hh"
+
+using namespace gz;
+using namespace transport;
+
+namespace gz
+{
+  namespace transport
+  {
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE
+    {
+    /// \internal
+    /// \brief Private data for ArenaPool class.
+    class ArenaPoolPrivate
+    {
+      /// \brief An arena and the initial block that it reuses.
+      public: struct Entry
+              {
+                /// \brief Constructor.
+                /// \param[in] _blockSize Size of the initial block (bytes).
+                public: explicit Entry(const std::size_t _blockSize)
+                  : block(new char[_blockSize])
+                {
+                  google::protobuf::ArenaOptions options;
+                  options.initial_block = this->block.get();
+                  options.initial_block_size = _blockSize;
+                  this->arena.reset(new google::protobuf::Arena(options));
+                }
+
+                /// \brief Initial block of the arena. It must outlive the
+                /// arena.
+                public: std::unique_ptr<char[]> block;
+
+                /// \brief The arena.
+                public: std::unique_ptr<google::protobuf::Arena> arena;
+              };
+
+      /// \brief Return an arena to the pool or free it.
+      /// \param[in] _entry The arena.
+      public: void Release(std::unique_ptr<Entry> _entry)
+      {
+        _entry->arena->Reset();
+
+        std::lock_guard<std::mutex> lk(this->mutex);
+        if (this->idle.size() < this->maxIdle)
+          this->idle.push_back(std::move(_entry));
+      }
+
+      /// \brief Protects idle and maxIdle.
+      public: std::mutex mutex;
+
+      /// \brief Arenas ready to be reused.
+      public: std::vector<std::unique_ptr<Entry>> idle;
+
+      /// \brief Maximum number of idle arenas.
+      public: std::size_t maxIdle = ArenaPool::kDefaultMaxIdle;
+
+      /// \brief Size of the initial block of each arena.
+      public: std::size_t blockSize = ArenaPool::kDefaultBlockSize;
+
+      /// \brief Number of requests served from an idle arena.
+      public: std::atomic<uint64_t> hits{0};
+
+      /// \brief Number of requests that created an arena.
+      public: std::atomic<uint64_t> misses{0};
+    };
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+ArenaPool::ArenaPool(const std::size_t _blockSize, const std::size_t _maxIdle)
+  : dataPtr(std::make_shared<ArenaPoolPrivate>())
+{
+  this->dataPtr->blockSize = _blockSize;
+  this->dataPtr->maxIdle = _maxIdle;
+}
+
+//////////////////////////////////////////////////
+ArenaPool::~ArenaPool()
+{
+  // Arenas still in use are freed when they are released.
+  std::lock_guard<std::mutex> lk(this->dataPtr->mutex);
+  this->dataPtr->maxIdle = 0;
+  this->dataPtr->idle.clear();
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<google::protobuf::Arena> ArenaPool::Acquire()
+{
+  std::unique_ptr<ArenaPoolPrivate::Entry> entry;
+  {
+    std::lock_guard<std::mutex> lk(this->dataPtr->mutex);
+    if (!this->dataPtr->idle.empty())
+    {
+      entry = std::move(this->dataPtr->idle.back());
+      this->dataPtr->idle.pop_back();
+    }
+  }
+
+  if (entry)
+  {
+    this->dataPtr->hits++;
+  }
+  else
+  {
+    this->dataPtr->misses++;
+    entry.reset(new ArenaPoolPrivate::Entry(this->dataPtr->blockSize));
+  }
+
+  ArenaPoolPrivate::Entry *raw = entry.release();
+  std::shared_ptr<ArenaPoolPrivate> pool = this->dataPtr;
+  return std::shared_ptr<google::protobuf::Arena>(raw->arena.get(),
+    [pool, raw](google::protobuf::Arena *)
+    {
+      pool->Release(std::unique_ptr<ArenaPoolPrivate::Entry>(raw));
+    });
+}
+
+//////////////////////////////////////////////////
+uint64_t ArenaPool::Hits() const
+{
+  return this->dataPtr->hits;
+}
+
+//////////////////////////////////////////////////
+uint64_t ArenaPool::Misses() const
+{
+  return this->dataPtr->misses;
+}
+
+//////////////////////////////////////////////////
+std::size_t ArenaPool::Idle() const
+{
+  std::lock_guard<std::mutex> lk(this->dataPtr->mutex);
+  return this->dataPtr->idle.size();
+}
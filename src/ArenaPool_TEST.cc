@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gz/msgs/stringmsg.pb.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gz/transport/ArenaPool.hh"
+
+using namespace gz;
+using namespace transport;
+
+//////////////////////////////////////////////////
+/// \brief Check that released arenas are reset and reused.
+TEST(ArenaPoolTest, Recycle)
+{
+  ArenaPool pool(1024u, 1u);
+  EXPECT_EQ(0u, pool.Hits());
+  EXPECT_EQ(0u, pool.Misses());
+  EXPECT_EQ(0u, pool.Idle());
+
+  auto arena = pool.Acquire();
+  ASSERT_NE(nullptr, arena);
+  EXPECT_EQ(1u, pool.Misses());
+
+  auto *msg = google::protobuf::Arena::CreateMessage<msgs::StringMsg>(
+    arena.get());
+  msg->set_data(std::string(100, 'a'));
+  EXPECT_GT(arena->SpaceUsed(), 0u);
+
+  google::protobuf::Arena *raw = arena.get();
+  arena.reset();
+  EXPECT_EQ(1u, pool.Idle());
+
+  // The same arena comes back empty.
+  auto arena2 = pool.Acquire();
+  EXPECT_EQ(raw, arena2.get());
+  EXPECT_EQ(0u, arena2->SpaceUsed());
+  EXPECT_EQ(1u, pool.Hits());
+  EXPECT_EQ(0u, pool.Idle());
+
+  // Only one idle arena is retained.
+  auto arena3 = pool.Acquire();
+  EXPECT_NE(arena2.get(), arena3.get());
+  EXPECT_EQ(2u, pool.Misses());
+  arena2.reset();
+  arena3.reset();
+  EXPECT_EQ(1u, pool.Idle());
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that an arena can outlive its pool.
+TEST(ArenaPoolTest, OutlivePool)
+{
+  std::shared_ptr<msgs::StringMsg> msg;
+  {
+    ArenaPool pool;
+    auto arena = pool.Acquire();
+    msg = std::shared_ptr<msgs::StringMsg>(arena,
+      google::protobuf::Arena::CreateMessage<msgs::StringMsg>(arena.get()));
+    msg->set_data("data");
+  }
+  EXPECT_EQ("data", msg->data());
+  msg.reset();
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that the pool can be used from multiple threads.
+TEST(ArenaPoolTest, Concurrency)
+{
+  ArenaPool pool;
+  const int kThreads = 4;
+  const int kIterations = 1000;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i)
+  {
+    threads.emplace_back([&pool]()
+    {
+      for (int j = 0; j < kIterations; ++j)
+      {
+        auto arena = pool.Acquire();
+        auto *msg = google::protobuf::Arena::CreateMessage<msgs::StringMsg>(
+          arena.get());
+        msg->set_data(std::to_string(j));
+      }
+    });
+  }
+
+  for (auto &t : threads)
+    t.join();
+
+  EXPECT_EQ(static_cast<uint64_t>(kThreads * kIterations),
+            pool.Hits() + pool.Misses());
+  EXPECT_LE(pool.Idle(), ArenaPool::kDefaultMaxIdle);
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "gz/transport/BufferPool.hh"
+
+using namespace gz;
+using namespace transport;
+
+namespace
+{
+  /// \brief Number of size classes between kMinBlockSize and kMaxBlockSize.
+  const std::size_t kNumSizeClasses = 19;
+
+  /// \brief Size class index used for buffers that are not pooled.
+  const std::size_t kUnpooled = kNumSizeClasses;
+
+  /// \brief Header stored in front of every buffer handed out by the pool.
+  /// It is padded to the strictest fundamental alignment so the payload
+  /// keeps the alignment guaranteed by operator new[].
+  struct alignas(std::max_align_t) BlockHeader
+  {
+    /// \brief Index of the size class or kUnpooled.
+    std::size_t sizeClass;
+  };
+
+  //////////////////////////////////////////////////
+  /// \brief Get the size class index for a requested size.
+  /// \param[in] _size Requested size (bytes).
+  /// \return The size class index or kUnpooled.
+  std::size_t SizeClass(const std::size_t _size)
+  {
+    if (_size > BufferPool::kMaxBlockSize)
+      return kUnpooled;
+
+    std::size_t index = 0;
+    std::size_t capacity = BufferPool::kMinBlockSize;
+    while (capacity < _size)
+    {
+      capacity <<= 1;
+      ++index;
+    }
+    return index;
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Get the capacity of a size class.
+  /// \param[in] _sizeClass Size class index (not kUnpooled).
+  /// \return Capacity in bytes.
+  std::size_t Capacity(const std::size_t _sizeClass)
+  {
+    return BufferPool::kMinBlockSize << _sizeClass;
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Allocate a buffer from the heap, including its header.
+  /// \param[in] _sizeClass Size class index or kUnpooled.
+  /// \param[in] _capacity Payload capacity (bytes).
+  /// \return Pointer to the payload.
+  char *Allocate(const std::size_t _sizeClass, const std::size_t _capacity)
+  {
+    char *raw = new char[sizeof(BlockHeader) + _capacity];
+    new (raw) BlockHeader{_sizeClass};
+    return raw + sizeof(BlockHeader);
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Get the header of a buffer.
+  /// \param[in] _buffer Payload pointer returned by Allocate().
+  /// \return Pointer to the header.
+  BlockHeader *Header(char *_buffer)
+  {
+    return reinterpret_cast<BlockHeader *>(_buffer - sizeof(BlockHeader));
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Free a buffer created with Allocate().
+  /// \param[in] _buffer Payload pointer returned by Allocate().
+  void Free(char *_buffer)
+  {
+    delete[] (_buffer - sizeof(BlockHeader));
+  }
+}
+
+namespace gz
+{
+  namespace transport
+  {
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE
+    {
+    /// \internal
+    /// \brief Private data for BufferPool class.
+    class BufferPoolPrivate
+    {
+      /// \brief Idle buffers of a single size class.
+      public: struct FreeList
+              {
+                /// \brief Protects blocks.
+                public: std::mutex mutex;
+
+                /// \brief Idle buffers ready to be reused.
+                public: std::vector<char *> blocks;
+              };
+
+      /// \brief One free list per size class.
+      public: std::array<FreeList, kNumSizeClasses> freeLists;
+
+      /// \brief Number of requests served from an idle buffer.
+      public: std::atomic<uint64_t> hits{0};
+
+      /// \brief Number of requests that needed a heap allocation.
+      public: std::atomic<uint64_t> misses{0};
+
+      /// \brief Bytes currently held in idle buffers.
+      public: std::atomic<std::size_t> bytesHeld{0};
+
+      /// \brief Limit of bytes held in idle buffers.
+      public: std::size_t maxBytesHeld = BufferPool::kDefaultMaxBytesHeld;
+    };
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+BufferPool::BufferPool(const std::size_t _maxBytesHeld)
+  : dataPtr(new BufferPoolPrivate())
+{
+  this->dataPtr->maxBytesHeld = _maxBytesHeld;
+}
+
+//////////////////////////////////////////////////
+BufferPool::~BufferPool()
+{
+  for (auto &freeList : this->dataPtr->freeLists)
+  {
+    std::lock_guard<std::mutex> lk(freeList.mutex);
+    for (char *block : freeList.blocks)
+      Free(block);
+    freeList.blocks.clear();
+  }
+}
+
+//////////////////////////////////////////////////
+char *BufferPool::Acquire(const std::size_t _size)
+{
+  const std::size_t sizeClass = SizeClass(_size);
+  if (sizeClass == kUnpooled)
+  {
+    this->dataPtr->misses++;
+    return Allocate(kUnpooled, _size);
+  }
+
+  auto &freeList = this->dataPtr->freeLists[sizeClass];
+  {
+    std::lock_guard<std::mutex> lk(freeList.mutex);
+    if (!freeList.blocks.empty())
+    {
+      char *block = freeList.blocks.back();
+      freeList.blocks.pop_back();
+      this->dataPtr->bytesHeld -= Capacity(sizeClass);
+      this->dataPtr->hits++;
+      return block;
+    }
+  }
+
+  this->dataPtr->misses++;
+  return Allocate(sizeClass, Capacity(sizeClass));
+}
+
+//////////////////////////////////////////////////
+void BufferPool::Release(char *_buffer)
+{
+  if (!_buffer)
+    return;
+
+  const std::size_t sizeClass = Header(_buffer)->sizeClass;
+  if (sizeClass == kUnpooled)
+  {
+    Free(_buffer);
+    return;
+  }
+
+  // Reserve room for this block. Give the reservation back and free the
+  // block if the pool is already holding its limit.
+  const std::size_t capacity = Capacity(sizeClass);
+  if (this->dataPtr->bytesHeld.fetch_add(capacity) + capacity >
+      this->dataPtr->maxBytesHeld)
+  {
+    this->dataPtr->bytesHeld -= capacity;
+    Free(_buffer);
+    return;
+  }
+
+  auto &freeList = this->dataPtr->freeLists[sizeClass];
+  std::lock_guard<std::mutex> lk(freeList.mutex);
+  freeList.blocks.push_back(_buffer);
+}
+
+//////////////////////////////////////////////////
+void BufferPool::Deallocate(void *_buffer, void *_hint)
+{
+  char *buffer = static_cast<char *>(_buffer);
+  if (_hint)
+    static_cast<BufferPool *>(_hint)->Release(buffer);
+  else if (buffer)
+    Free(buffer);
+}
+
+//////////////////////////////////////////////////
+uint64_t BufferPool::Hits() const
+{
+  return this->dataPtr->hits;
+}
+
+//////////////////////////////////////////////////
+uint64_t BufferPool::Misses() const
+{
+  return this->dataPtr->misses;
+}
+
+//////////////////////////////////////////////////
+std::size_t BufferPool::BytesHeld() const
+{
+  return this->dataPtr->bytesHeld;
+}
+
+//////////////////////////////////////////////////
+std::size_t BufferPool::MaxBytesHeld() const
+{
+  return this->dataPtr->maxBytesHeld;
+}
+
+//////////////////////////////////////////////////
+std::size_t BufferPool::SizeClassCapacity(const std::size_t _size)
+{
+  const std::size_t sizeClass = SizeClass(_size);
+  return sizeClass == kUnpooled ? 0u : Capacity(sizeClass);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gz/transport/BufferPool.hh"
+
+using namespace gz;
+using namespace transport;
+
+//////////////////////////////////////////////////
+/// \brief Check the size classes.
+TEST(BufferPoolTest, SizeClasses)
+{
+  EXPECT_EQ(BufferPool::kMinBlockSize, BufferPool::SizeClassCapacity(0u));
+  EXPECT_EQ(BufferPool::kMinBlockSize, BufferPool::SizeClassCapacity(1u));
+  EXPECT_EQ(64u, BufferPool::SizeClassCapacity(64u));
+  EXPECT_EQ(128u, BufferPool::SizeClassCapacity(65u));
+  EXPECT_EQ(4096u, BufferPool::SizeClassCapacity(3000u));
+  EXPECT_EQ(BufferPool::kMaxBlockSize,
+    BufferPool::SizeClassCapacity(BufferPool::kMaxBlockSize));
+  EXPECT_EQ(0u, BufferPool::SizeClassCapacity(BufferPool::kMaxBlockSize + 1));
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that released buffers are reused and counted.
+TEST(BufferPoolTest, HitsAndMisses)
+{
+  BufferPool pool;
+  EXPECT_EQ(0u, pool.Hits());
+  EXPECT_EQ(0u, pool.Misses());
+  EXPECT_EQ(0u, pool.BytesHeld());
+
+  char *buffer = pool.Acquire(100u);
+  ASSERT_NE(nullptr, buffer);
+  memset(buffer, 1, 100u);
+  EXPECT_EQ(0u, pool.Hits());
+  EXPECT_EQ(1u, pool.Misses());
+
+  pool.Release(buffer);
+  EXPECT_EQ(128u, pool.BytesHeld());
+
+  // Same size class, so the buffer is reused.
+  char *buffer2 = pool.Acquire(120u);
+  EXPECT_EQ(buffer, buffer2);
+  EXPECT_EQ(1u, pool.Hits());
+  EXPECT_EQ(1u, pool.Misses());
+  EXPECT_EQ(0u, pool.BytesHeld());
+
+  // Different size class.
+  char *buffer3 = pool.Acquire(1000u);
+  EXPECT_NE(buffer2, buffer3);
+  EXPECT_EQ(2u, pool.Misses());
+
+  // Release through the ZMQ compatible deallocation function.
+  BufferPool::Deallocate(buffer2, &pool);
+  BufferPool::Deallocate(buffer3, &pool);
+  EXPECT_EQ(128u + 1024u, pool.BytesHeld());
+
+  // A nullptr is ignored.
+  pool.Release(nullptr);
+  EXPECT_EQ(128u + 1024u, pool.BytesHeld());
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that buffers above the limits are not retained.
+TEST(BufferPoolTest, Limits)
+{
+  BufferPool pool(256u);
+  EXPECT_EQ(256u, pool.MaxBytesHeld());
+
+  char *buffer1 = pool.Acquire(200u);
+  char *buffer2 = pool.Acquire(200u);
+  pool.Release(buffer1);
+  EXPECT_EQ(256u, pool.BytesHeld());
+
+  // The pool is full, so this buffer is freed.
+  pool.Release(buffer2);
+  EXPECT_EQ(256u, pool.BytesHeld());
+
+  // Buffers bigger than the largest size class are never pooled.
+  char *big = pool.Acquire(BufferPool::kMaxBlockSize + 1);
+  ASSERT_NE(nullptr, big);
+  big[BufferPool::kMaxBlockSize] = 'a';
+  pool.Release(big);
+  EXPECT_EQ(256u, pool.BytesHeld());
+
+  // A buffer can be freed without a pool.
+  char *orphan = pool.Acquire(10u);
+  BufferPool::Deallocate(orphan, nullptr);
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that the pool can be used from multiple threads.
+TEST(BufferPoolTest, Concurrency)
+{
+  BufferPool pool;
+  const int kThreads = 4;
+  const int kIterations = 1000;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i)
+  {
+    threads.emplace_back([&pool, i]()
+    {
+      for (int j = 0; j < kIterations; ++j)
+      {
+        const std::size_t size = static_cast<std::size_t>(64 * (i + 1));
+        char *buffer = pool.Acquire(size);
+        memset(buffer, i, size);
+        pool.Release(buffer);
+      }
+    });
+  }
+
+  for (auto &t : threads)
+    t.join();
+
+  EXPECT_EQ(static_cast<uint64_t>(kThreads * kIterations),
+            pool.Hits() + pool.Misses());
+  EXPECT_LE(pool.Misses(), static_cast<uint64_t>(kThreads * kThreads));
+}
@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "CallbackExecutor.hh"
+
+using namespace gz;
+using namespace transport;
+
+namespace gz
+{
+  namespace transport
+  {
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE
+    {
+    /// \internal
+    /// \brief Private data for CallbackExecutor class.
+    class CallbackExecutorPrivate
+    {
+      /// \brief Tasks of a strand.
+      public: struct Strand
+              {
+                /// \brief Name of the strand.
+                public: std::string name;
+
+                /// \brief Tasks waiting to run, in order.
+                public: std::deque<std::function<void()>> tasks;
+
+                /// \brief True while the strand is in the ready queue or one
+                /// of its tasks is running.
+                public: bool scheduled = false;
+              };
+
+      /// \brief Function executed by each worker thread.
+      public: void Worker();
+
+      /// \brief Protects all the members below.
+      public: mutable std::mutex mutex;
+
+      /// \brief Signaled when a strand is ready or on stop.
+      public: std::condition_variable signalReady;
+
+      /// \brief Signaled when a pending task is taken or on stop.
+      public: std::condition_variable signalSpace;
+
+      /// \brief Strands with pending or running tasks.
+      public: std::unordered_map<std::string, Strand> strands;
+
+      /// \brief Strands with pending tasks and no task running.
+      public: std::deque<Strand *> ready;
+
+      /// \brief Number of tasks waiting to run.
+      public: std::size_t pending = 0;
+
+      /// \brief Maximum number of tasks waiting to run, 0 for no limit.
+      public: std::size_t maxPending = 0;
+
+      /// \brief True when the executor is stopped.
+      public: bool exit = false;
+
+      /// \brief Worker threads.
+      public: std::vector<std::thread> threads;
+    };
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void CallbackExecutorPrivate::Worker()
+{
+  std::unique_lock<std::mutex> lk(this->mutex);
+  while (true)
+  {
+    this->signalReady.wait(lk, [this]
+    {
+      return this->exit || !this->ready.empty();
+    });
+
+    if (this->exit)
+      return;
+
+    // Take the oldest task of the next strand. The strand stays scheduled,
+    // so no other worker runs its tasks meanwhile.
+    Strand *strand = this->ready.front();
+    this->ready.pop_front();
+
+    // All the tasks of the strand were discarded while it was waiting.
+    if (strand->tasks.empty())
+    {
+      this->strands.erase(this->strands.find(strand->name));
+      continue;
+    }
+
+    std::function<void()> task = std::move(strand->tasks.front());
+    strand->tasks.pop_front();
+    --this->pending;
+
+    // Posters may wait for room in the executor or in a given strand.
+    this->signalSpace.notify_all();
+
+    lk.unlock();
+    try
+    {
+      task();
+    }
+    catch (...)
+    {
+      std::cerr << "Exception occurred in a callback of strand ["
+                << strand->name << "]" << std::endl;
+    }
+    task = nullptr;
+    lk.lock();
+
+    // Requeue the strand at the back for fairness or forget it.
+    if (!strand->tasks.empty())
+    {
+      this->ready.push_back(strand);
+      this->signalReady.notify_one();
+    }
+    else
+    {
+      this->strands.erase(this->strands.find(strand->name));
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+CallbackExecutor::CallbackExecutor(const unsigned int _threads,
+    const std::size_t _maxPending)
+  : dataPtr(new CallbackExecutorPrivate())
+{
+  this->dataPtr->maxPending = _maxPending;
+
+  const unsigned int threads = std::max(1u, _threads);
+  for (unsigned int i = 0; i < threads; ++i)
+  {
+    this->dataPtr->threads.emplace_back(
+      &CallbackExecutorPrivate::Worker, this->dataPtr.get());
+  }
+}
+
+//////////////////////////////////////////////////
+CallbackExecutor::~CallbackExecutor()
+{
+  this->Stop();
+}
+
+//////////////////////////////////////////////////
+bool CallbackExecutor::Post(const std::string &_strand,
+    std::function<void()> _task)
+{
+  std::size_t dropped = 0;
+  return this->Post(_strand, std::move(_task), 0, OverflowPolicy::DROP_NEWEST,
+    std::chrono::milliseconds(0), dropped);
+}
+
+//////////////////////////////////////////////////
+bool CallbackExecutor::Post(const std::string &_strand,
+    std::function<void()> _task, const std::size_t _maxStrandPending,
+    const OverflowPolicy _overflow, const std::chrono::milliseconds &_timeout,
+    std::size_t &_dropped)
+{
+  _dropped = 0;
+  const auto deadline = std::chrono::steady_clock::now() + _timeout;
+
+  std::unique_lock<std::mutex> lk(this->dataPtr->mutex);
+  while (true)
+  {
+    if (this->dataPtr->exit)
+      return false;
+
+    // Honor the limit of the strand first.
+    auto it = this->dataPtr->strands.find(_strand);
+    if (_maxStrandPending > 0 && it != this->dataPtr->strands.end() &&
+        it->second.tasks.size() >= _maxStrandPending)
+    {
+      auto &tasks = it->second.tasks;
+      if (_overflow == OverflowPolicy::DROP_OLDEST)
+      {
+        while (tasks.size() >= _maxStrandPending)
+        {
+          tasks.pop_front();
+          --this->dataPtr->pending;
+          ++_dropped;
+        }
+        continue;
+      }
+
+      if (_overflow == OverflowPolicy::BLOCK &&
+          std::chrono::steady_clock::now() < deadline)
+      {
+        this->dataPtr->signalSpace.wait_until(lk, deadline);
+        continue;
+      }
+
+      ++_dropped;
+      return false;
+    }
+
+    // Then the limit of the executor.
+    if (this->dataPtr->maxPending > 0 &&
+        this->dataPtr->pending >= this->dataPtr->maxPending)
+    {
+      this->dataPtr->signalSpace.wait(lk);
+      continue;
+    }
+
+    break;
+  }
+
+  auto &strand = this->dataPtr->strands[_strand];
+  if (strand.name.empty())
+    strand.name = _strand;
+
+  strand.tasks.push_back(std::move(_task));
+  ++this->dataPtr->pending;
+
+  if (!strand.scheduled)
+  {
+    strand.scheduled = true;
+    this->dataPtr->ready.push_back(&strand);
+    this->dataPtr->signalReady.notify_one();
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::size_t CallbackExecutor::Discard(const std::string &_prefix)
+{
+  std::size_t discarded = 0;
+  std::vector<std::function<void()>> tasks;
+  {
+    std::lock_guard<std::mutex> lk(this->dataPtr->mutex);
+    for (auto &strand : this->dataPtr->strands)
+    {
+      if (strand.first.compare(0, _prefix.size(), _prefix) != 0)
+        continue;
+
+      // The strand itself is released by the worker that takes it.
+      for (auto &task : strand.second.tasks)
+        tasks.push_back(std::move(task));
+      discarded += strand.second.tasks.size();
+      strand.second.tasks.clear();
+    }
+    this->dataPtr->pending -= discarded;
+    if (discarded > 0)
+      this->dataPtr->signalSpace.notify_all();
+  }
+
+  // The tasks are destroyed without holding the lock.
+  tasks.clear();
+  return discarded;
+}
+
+//////////////////////////////////////////////////
+void CallbackExecutor::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lk(this->dataPtr->mutex);
+    this->dataPtr->exit = true;
+    this->dataPtr->signalReady.notify_all();
+    this->dataPtr->signalSpace.notify_all();
+  }
+
+  for (auto &thread : this->dataPtr->threads)
+  {
+    if (thread.joinable())
+      thread.join();
+  }
+
+  std::lock_guard<std::mutex> lk(this->dataPtr->mutex);
+  this->dataPtr->ready.clear();
+  this->dataPtr->strands.clear();
+  this->dataPtr->pending = 0;
+}
+
+//////////////////////////////////////////////////
+unsigned int CallbackExecutor::Threads() const
+{
+  return static_cast<unsigned int>(this->dataPtr->threads.size());
+}
+
+//////////////////////////////////////////////////
+std::size_t CallbackExecutor::Pending() const
+{
+  std::lock_guard<std::mutex> lk(this->dataPtr->mutex);
+  return this->dataPtr->pending;
+}
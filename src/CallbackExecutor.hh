@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_TRANSPORT_CALLBACKEXECUTOR_HH_
+#define GZ_TRANSPORT_CALLBACKEXECUTOR_HH_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "gz/transport/config.hh"
+#include "gz/transport/OverflowPolicy.hh"
+
+namespace gz
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE {
+    //
+    // Forward declarations.
+    class CallbackExecutorPrivate;
+
+    /// \class CallbackExecutor CallbackExecutor.hh
+    /// \brief A pool of threads that runs tasks grouped in strands. Tasks
+    /// posted to the same strand run one at a time and in the order they
+    /// were posted, while tasks of different strands may run in parallel.
+    ///
+    /// NodeShared uses it to run the callbacks of the messages received
+    /// from other processes, with one strand per topic, and optionally the
+    /// callbacks of the messages published from this process, with one
+    /// strand per subscription.
+    class CallbackExecutor
+    {
+      /// \brief Constructor. Starts the worker threads.
+      /// \param[in] _threads Number of worker threads. At least one thread
+      /// is always created.
+      /// \param[in] _maxPending Maximum number of tasks waiting to run.
+      /// Post() blocks while the limit is reached. A value of 0 means no
+      /// limit.
+      public: explicit CallbackExecutor(unsigned int _threads,
+                                        std::size_t _maxPending = 0);
+
+      /// \brief Destructor. Calls Stop().
+      public: ~CallbackExecutor();
+
+      /// \brief Queue a task in a strand.
+      /// \param[in] _strand Name of the strand.
+      /// \param[in] _task The task.
+      /// \return True if the task was queued or false if the executor is
+      /// stopped.
+      public: bool Post(const std::string &_strand,
+                        std::function<void()> _task);
+
+      /// \brief Queue a task in a strand with a bounded number of pending
+      /// tasks per strand. The executor-wide limit passed to the constructor
+      /// still applies.
+      /// \param[in] _strand Name of the strand.
+      /// \param[in] _task The task.
+      /// \param[in] _maxStrandPending Maximum number of tasks of this strand
+      /// waiting to run. A value of 0 means no limit.
+      /// \param[in] _overflow What to do when the strand is full.
+      /// \param[in] _timeout Maximum time to wait for room in the strand
+      /// with OverflowPolicy::BLOCK.
+      /// \param[out] _dropped Number of tasks discarded to honor the limit,
+      /// either the new task or the oldest pending one.
+      /// \return True if the task was queued or false if it was discarded or
+      /// the executor is stopped.
+      public: bool Post(const std::string &_strand,
+                        std::function<void()> _task,
+                        const std::size_t _maxStrandPending,
+                        const OverflowPolicy _overflow,
+                        const std::chrono::milliseconds &_timeout,
+                        std::size_t &_dropped);
+
+      /// \brief Discard the tasks waiting to run in all the strands whose
+      /// name starts with a given prefix. The tasks already running are not
+      /// affected.
+      /// \param[in] _prefix Prefix of the strand names.
+      /// \return Number of tasks discarded.
+      public: std::size_t Discard(const std::string &_prefix);
+
+      /// \brief Stop the executor. The tasks already running are completed,
+      /// the tasks waiting to run are discarded and the worker threads are
+      /// joined. It must not be called from a task.
+      public: void Stop();
+
+      /// \brief Get the number of worker threads.
+      /// \return Number of worker threads.
+      public: unsigned int Threads() const;
+
+      /// \brief Get the number of tasks waiting to run.
+      /// \return Number of pending tasks.
+      public: std::size_t Pending() const;
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<CallbackExecutorPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "CallbackExecutor.hh"
+
+using namespace gz;
+using namespace transport;
+
+//////////////////////////////////////////////////
+/// \brief Wait until a condition holds or a timeout expires.
+/// \param[in] _cond The condition.
+/// \return The last value of the condition.
+static bool waitFor(const std::function<bool()> &_cond)
+{
+  for (int i = 0; i < 500 && !_cond(); ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  return _cond();
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that the tasks of a strand run in order and never
+/// concurrently.
+TEST(CallbackExecutorTest, StrandOrdering)
+{
+  const int kStrands = 4;
+  const int kTasks = 500;
+
+  CallbackExecutor executor(4);
+  EXPECT_EQ(4u, executor.Threads());
+
+  std::mutex mutex;
+  std::map<std::string, std::vector<int>> executed;
+  std::map<std::string, std::atomic<int>> running;
+  std::atomic<bool> overlap{false};
+  std::atomic<int> done{0};
+
+  for (int s = 0; s < kStrands; ++s)
+    running["strand" + std::to_string(s)] = 0;
+
+  for (int i = 0; i < kTasks; ++i)
+  {
+    for (int s = 0; s < kStrands; ++s)
+    {
+      const std::string name = "strand" + std::to_string(s);
+      EXPECT_TRUE(executor.Post(name, [&, name, i]()
+      {
+        if (running[name]++ != 0)
+          overlap = true;
+        {
+          std::lock_guard<std::mutex> lk(mutex);
+          executed[name].push_back(i);
+        }
+        --running[name];
+        ++done;
+      }));
+    }
+  }
+
+  EXPECT_TRUE(waitFor([&]{return done == kStrands * kTasks;}));
+  EXPECT_FALSE(overlap);
+  EXPECT_EQ(0u, executor.Pending());
+
+  std::lock_guard<std::mutex> lk(mutex);
+  for (const auto &strand : executed)
+  {
+    ASSERT_EQ(static_cast<std::size_t>(kTasks), strand.second.size());
+    for (int i = 0; i < kTasks; ++i)
+      EXPECT_EQ(i, strand.second[i]);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that a slow strand does not block the others.
+TEST(CallbackExecutorTest, Parallelism)
+{
+  CallbackExecutor executor(2);
+
+  std::atomic<bool> release{false};
+  std::atomic<bool> fastDone{false};
+
+  EXPECT_TRUE(executor.Post("slow", [&]()
+  {
+    while (!release)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }));
+  EXPECT_TRUE(executor.Post("fast", [&]() {fastDone = true;}));
+
+  EXPECT_TRUE(waitFor([&]{return fastDone.load();}));
+  release = true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Check the limit of pending tasks, exceptions and stopping.
+TEST(CallbackExecutorTest, LimitsAndStop)
+{
+  // At least one thread is created.
+  CallbackExecutor executor(0, 2);
+  EXPECT_EQ(1u, executor.Threads());
+
+  std::atomic<bool> release{false};
+  std::atomic<int> done{0};
+
+  // An exception does not kill the worker.
+  EXPECT_TRUE(executor.Post("a", []() {throw std::runtime_error("test");}));
+
+  EXPECT_TRUE(executor.Post("a", [&]()
+  {
+    while (!release)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ++done;
+  }));
+  EXPECT_TRUE(waitFor([&]{return executor.Pending() == 0u;}));
+
+  // Two tasks fill the queue while the first one is blocked.
+  EXPECT_TRUE(executor.Post("a", [&]() {++done;}));
+  EXPECT_TRUE(executor.Post("b", [&]() {++done;}));
+  EXPECT_EQ(2u, executor.Pending());
+
+  // The third task waits for space.
+  std::atomic<bool> posted{false};
+  std::thread poster([&]()
+  {
+    EXPECT_TRUE(executor.Post("c", [&]() {++done;}));
+    posted = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(posted);
+
+  release = true;
+  poster.join();
+  EXPECT_TRUE(waitFor([&]{return done == 4;}));
+
+  executor.Stop();
+  EXPECT_FALSE(executor.Post("a", [&]() {++done;}));
+  EXPECT_EQ(4, done);
+}
+
+//////////////////////////////////////////////////
+/// \brief Check the overflow policies of a bounded strand.
+TEST(CallbackExecutorTest, StrandLimits)
+{
+  CallbackExecutor executor(1);
+
+  std::atomic<bool> release{false};
+  std::mutex mutex;
+  std::vector<int> executed;
+  std::size_t dropped = 0;
+
+  auto record = [&](int _i)
+  {
+    return [&, _i]()
+    {
+      std::lock_guard<std::mutex> lk(mutex);
+      executed.push_back(_i);
+    };
+  };
+
+  // Keep the only worker busy.
+  EXPECT_TRUE(executor.Post("block", [&]()
+  {
+    while (!release)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }));
+  EXPECT_TRUE(waitFor([&]{return executor.Pending() == 0u;}));
+
+  const auto timeout = std::chrono::milliseconds(20);
+
+  // Drop newest.
+  EXPECT_TRUE(executor.Post("s", record(1), 2, OverflowPolicy::DROP_NEWEST,
+    timeout, dropped));
+  EXPECT_EQ(0u, dropped);
+  EXPECT_TRUE(executor.Post("s", record(2), 2, OverflowPolicy::DROP_NEWEST,
+    timeout, dropped));
+  EXPECT_FALSE(executor.Post("s", record(3), 2, OverflowPolicy::DROP_NEWEST,
+    timeout, dropped));
+  EXPECT_EQ(1u, dropped);
+
+  // Drop oldest.
+  EXPECT_TRUE(executor.Post("s", record(4), 2, OverflowPolicy::DROP_OLDEST,
+    timeout, dropped));
+  EXPECT_EQ(1u, dropped);
+  EXPECT_EQ(2u, executor.Pending());
+
+  // Block until the timeout expires.
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(executor.Post("s", record(5), 2, OverflowPolicy::BLOCK,
+    timeout, dropped));
+  EXPECT_GE(std::chrono::steady_clock::now() - start, timeout);
+  EXPECT_EQ(1u, dropped);
+
+  // Other strands are not affected by the limit.
+  EXPECT_TRUE(executor.Post("t", record(6), 2, OverflowPolicy::DROP_NEWEST,
+    timeout, dropped));
+  EXPECT_EQ(0u, dropped);
+
+  // Block until there is room.
+  std::thread poster([&]()
+  {
+    std::size_t blockDropped = 0;
+    EXPECT_TRUE(executor.Post("s", record(7), 2, OverflowPolicy::BLOCK,
+      std::chrono::milliseconds(5000), blockDropped));
+    EXPECT_EQ(0u, blockDropped);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  release = true;
+  poster.join();
+
+  EXPECT_TRUE(waitFor([&]
+  {
+    std::lock_guard<std::mutex> lk(mutex);
+    return executed.size() == 4u;
+  }));
+
+  std::lock_guard<std::mutex> lk(mutex);
+  std::vector<int> strandS;
+  for (int i : executed)
+  {
+    if (i != 6)
+      strandS.push_back(i);
+  }
+  EXPECT_EQ((std::vector<int>{2, 4, 7}), strandS);
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that the pending tasks of some strands can be discarded.
+TEST(CallbackExecutorTest, Discard)
+{
+  CallbackExecutor executor(1);
+
+  std::atomic<bool> release{false};
+  std::atomic<int> doneA{0};
+  std::atomic<int> doneB{0};
+
+  EXPECT_TRUE(executor.Post("a#1", [&]()
+  {
+    while (!release)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ++doneA;
+  }));
+  EXPECT_TRUE(waitFor([&]{return executor.Pending() == 0u;}));
+
+  for (int i = 0; i < 3; ++i)
+  {
+    EXPECT_TRUE(executor.Post("a#1", [&]() {++doneA;}));
+    EXPECT_TRUE(executor.Post("a#2", [&]() {++doneA;}));
+    EXPECT_TRUE(executor.Post("b#1", [&]() {++doneB;}));
+  }
+  EXPECT_EQ(9u, executor.Pending());
+
+  // The running task is not affected.
+  EXPECT_EQ(6u, executor.Discard("a#"));
+  EXPECT_EQ(3u, executor.Pending());
+  EXPECT_EQ(0u, executor.Discard("c#"));
+
+  release = true;
+  EXPECT_TRUE(waitFor([&]{return doneB == 3;}));
+  EXPECT_EQ(1, doneA);
+
+  // The strands can be used again.
+  EXPECT_TRUE(executor.Post("a#2", [&]() {++doneA;}));
+  EXPECT_TRUE(waitFor([&]{return doneA == 2;}));
+}
@@ -0,0 +1,281 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "gz/transport/Compression.hh"
+#include "gz/transport/config.hh"
+
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace gz
+{
+namespace transport
+{
+inline namespace GZ_TRANSPORT_VERSION_NAMESPACE
+{
+namespace
+{
+  /// \brief First byte of a compressed message. Field number 0 is invalid
+  /// in protobuf, so no serialized message starts with this byte.
+  const char kMarker = '\0';
+
+  /// \brief Largest message accepted by decompress(). Protobuf can't parse
+  /// bigger messages anyway.
+  const uint64_t kMaxUncompressedSize =
+    static_cast<uint64_t>(std::numeric_limits<int>::max());
+
+  /// \brief Maximum compression ratio of LZ4. A literal run of length N
+  /// costs at least N / 255 bytes.
+  const uint64_t kLz4MaxRatio = 255;
+
+  /// \brief Maximum size of a Zstandard block (bytes). A block compressed
+  /// with run length encoding takes at least 4 bytes.
+  const uint64_t kZstdMaxBlockSize = 128 * 1024;
+
+  /// \brief Zstandard compression level. Low levels keep the CPU cost close
+  /// to LZ4 while still getting most of the ratio.
+#ifdef HAVE_ZSTD
+  const int kZstdLevel = 1;
+#endif
+
+  //////////////////////////////////////////////////
+  /// \brief Write the compression header.
+  /// \param[in] _codec The codec.
+  /// \param[in] _size Uncompressed size (bytes).
+  /// \param[out] _out Buffer of at least kCompressionHeaderSize bytes.
+  void WriteHeader(const Compression_t _codec, const uint64_t _size,
+    char *_out)
+  {
+    _out[0] = kMarker;
+    _out[1] = static_cast<char>(_codec);
+    for (int i = 0; i < 8; ++i)
+      _out[2 + i] = static_cast<char>((_size >> (8 * i)) & 0xff);
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Read the uncompressed size from the compression header.
+  /// \param[in] _data Buffer of at least kCompressionHeaderSize bytes.
+  /// \return The uncompressed size (bytes).
+  uint64_t ReadSize(const char *_data)
+  {
+    uint64_t size = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+      size |= static_cast<uint64_t>(
+        static_cast<unsigned char>(_data[2 + i])) << (8 * i);
+    }
+    return size;
+  }
+}
+
+//////////////////////////////////////////////////
+uint32_t supportedCodecs()
+{
+  uint32_t codecs = 0;
+#ifdef HAVE_LZ4
+  codecs |= codecMask(Compression_t::LZ4);
+#endif
+#ifdef HAVE_ZSTD
+  codecs |= codecMask(Compression_t::ZSTD);
+#endif
+  return codecs;
+}
+
+//////////////////////////////////////////////////
+std::size_t maxCompressedSize(const Compression_t _codec,
+  const std::size_t _size)
+{
+  // Unused when no codec is available.
+  (void)_size;
+
+  switch (_codec)
+  {
+#ifdef HAVE_LZ4
+    case Compression_t::LZ4:
+    {
+      if (_size > static_cast<std::size_t>(LZ4_MAX_INPUT_SIZE))
+        return 0;
+      return kCompressionHeaderSize +
+        static_cast<std::size_t>(LZ4_compressBound(static_cast<int>(_size)));
+    }
+#endif
+#ifdef HAVE_ZSTD
+    case Compression_t::ZSTD:
+      return kCompressionHeaderSize + ZSTD_compressBound(_size);
+#endif
+    default:
+      return 0;
+  }
+}
+
+//////////////////////////////////////////////////
+std::size_t compress(const Compression_t _codec,
+  const char *_data, const std::size_t _size, char *_out,
+  const std::size_t _capacity)
+{
+  if (_capacity <= kCompressionHeaderSize)
+    return 0;
+
+  // Unused when no codec is available.
+  (void)_data;
+
+  char *dst = _out + kCompressionHeaderSize;
+  const std::size_t dstCapacity = _capacity - kCompressionHeaderSize;
+  std::size_t compressedSize = 0;
+
+  switch (_codec)
+  {
+#ifdef HAVE_LZ4
+    case Compression_t::LZ4:
+    {
+      if (_size > static_cast<std::size_t>(LZ4_MAX_INPUT_SIZE))
+        return 0;
+      const int dstLimit = static_cast<int>(std::min(dstCapacity,
+        static_cast<std::size_t>(std::numeric_limits<int>::max())));
+      const int result = LZ4_compress_default(_data, dst,
+        static_cast<int>(_size), dstLimit);
+      if (result <= 0)
+        return 0;
+      compressedSize = static_cast<std::size_t>(result);
+      break;
+    }
+#endif
+#ifdef HAVE_ZSTD
+    case Compression_t::ZSTD:
+    {
+      const std::size_t result = ZSTD_compress(dst, dstCapacity, _data,
+        _size, kZstdLevel);
+      if (ZSTD_isError(result))
+        return 0;
+      compressedSize = result;
+      break;
+    }
+#endif
+    default:
+      (void)dst;
+      (void)dstCapacity;
+      return 0;
+  }
+
+  // Not worth it, the message is sent uncompressed.
+  if (kCompressionHeaderSize + compressedSize >= _size)
+    return 0;
+
+  WriteHeader(_codec, _size, _out);
+  return kCompressionHeaderSize + compressedSize;
+}
+
+//////////////////////////////////////////////////
+bool isCompressed(const char *_data, const std::size_t _size)
+{
+  return _size >= kCompressionHeaderSize && _data[0] == kMarker;
+}
+
+//////////////////////////////////////////////////
+bool decompress(const char *_data, const std::size_t _size,
+  std::string &_out, const std::size_t _maxSize)
+{
+  if (!isCompressed(_data, _size))
+    return false;
+
+  const uint64_t uncompressedSize = ReadSize(_data);
+  const char *src = _data + kCompressionHeaderSize;
+  const std::size_t srcSize = _size - kCompressionHeaderSize;
+
+  // Reject the sizes that the input can't possibly expand to, so a corrupt
+  // or malicious header can't make us allocate memory.
+  uint64_t maxSize = std::min(kMaxUncompressedSize,
+    static_cast<uint64_t>(_maxSize));
+  switch (static_cast<Compression_t>(_data[1]))
+  {
+#ifdef HAVE_LZ4
+    case Compression_t::LZ4:
+      maxSize = std::min(maxSize, srcSize * kLz4MaxRatio);
+      break;
+#endif
+#ifdef HAVE_ZSTD
+    case Compression_t::ZSTD:
+    {
+      const unsigned long long frameSize =  // NOLINT
+        ZSTD_getFrameContentSize(src, srcSize);
+      if (frameSize == ZSTD_CONTENTSIZE_UNKNOWN ||
+          frameSize == ZSTD_CONTENTSIZE_ERROR ||
+          frameSize != uncompressedSize)
+      {
+        return false;
+      }
+      maxSize = std::min(maxSize,
+        (srcSize / 4 + 1) * kZstdMaxBlockSize);
+      break;
+    }
+#endif
+    default:
+      return false;
+  }
+
+  if (uncompressedSize > maxSize)
+  {
+    if (uncompressedSize > _maxSize)
+    {
+      std::cerr << "Rejected a compressed message of " << uncompressedSize
+                << " bytes. The limit is " << _maxSize << " bytes."
+                << std::endl;
+    }
+    return false;
+  }
+
+  _out.resize(static_cast<std::size_t>(uncompressedSize));
+
+  switch (static_cast<Compression_t>(_data[1]))
+  {
+#ifdef HAVE_LZ4
+    case Compression_t::LZ4:
+    {
+      if (srcSize > static_cast<std::size_t>(LZ4_MAX_INPUT_SIZE))
+        return false;
+      const int result = LZ4_decompress_safe(src, &_out[0],
+        static_cast<int>(srcSize), static_cast<int>(uncompressedSize));
+      return result >= 0 && static_cast<uint64_t>(result) == uncompressedSize;
+    }
+#endif
+#ifdef HAVE_ZSTD
+    case Compression_t::ZSTD:
+    {
+      const std::size_t result = ZSTD_decompress(&_out[0], _out.size(),
+        src, srcSize);
+      return !ZSTD_isError(result) && result == uncompressedSize;
+    }
+#endif
+    default:
+      (void)src;
+      (void)srcSize;
+      return false;
+  }
+}
+}
+}
+}
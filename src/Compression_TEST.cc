@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gz/transport/Compression.hh"
+
+using namespace gz;
+using namespace transport;
+
+namespace
+{
+  /// \brief Codecs that can be built.
+  const std::vector<Compression_t> kCodecs =
+    {Compression_t::LZ4, Compression_t::ZSTD};
+}
+
+//////////////////////////////////////////////////
+/// \brief Check the codec masks.
+TEST(CompressionTest, CodecMask)
+{
+  EXPECT_EQ(1u, codecMask(Compression_t::NONE));
+  EXPECT_EQ(2u, codecMask(Compression_t::LZ4));
+  EXPECT_EQ(4u, codecMask(Compression_t::ZSTD));
+  EXPECT_EQ(0u, supportedCodecs() & codecMask(Compression_t::NONE));
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that NONE never compresses.
+TEST(CompressionTest, None)
+{
+  const std::string data(1000, 'a');
+  std::vector<char> out(2000);
+  EXPECT_EQ(0u, maxCompressedSize(Compression_t::NONE, data.size()));
+  EXPECT_EQ(0u, compress(Compression_t::NONE, data.data(), data.size(),
+    out.data(), out.size()));
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that serialized messages are not taken as compressed.
+TEST(CompressionTest, IsCompressed)
+{
+  // A protobuf message starts with a non-zero field tag.
+  const std::string msg("\x08\x96\x01\x12\x04test", 9);
+  EXPECT_FALSE(isCompressed(msg.data(), msg.size()));
+  EXPECT_FALSE(isCompressed(nullptr, 0));
+
+  std::string out;
+  EXPECT_FALSE(decompress(msg.data(), msg.size(), out));
+}
+
+//////////////////////////////////////////////////
+/// \brief Compress and decompress with every supported codec.
+TEST(CompressionTest, RoundTrip)
+{
+  std::string data;
+  for (int i = 0; i < 10000; ++i)
+    data += "pose " + std::to_string(i % 100) + ";";
+
+  for (const Compression_t codec : kCodecs)
+  {
+    if (!(supportedCodecs() & codecMask(codec)))
+      continue;
+
+    std::vector<char> out(maxCompressedSize(codec, data.size()));
+    ASSERT_GT(out.size(), kCompressionHeaderSize);
+
+    const std::size_t size = compress(codec, data.data(), data.size(),
+      out.data(), out.size());
+    EXPECT_GT(size, 0u);
+    EXPECT_LT(size, data.size());
+    EXPECT_TRUE(isCompressed(out.data(), size));
+
+    std::string result;
+    EXPECT_TRUE(decompress(out.data(), size, result));
+    EXPECT_EQ(data, result);
+
+    // A truncated message is rejected.
+    EXPECT_FALSE(decompress(out.data(), size / 2, result));
+
+    // Tiny messages are not worth compressing.
+    const std::string tiny("ab");
+    std::vector<char> tinyOut(maxCompressedSize(codec, tiny.size()));
+    EXPECT_EQ(0u, compress(codec, tiny.data(), tiny.size(), tinyOut.data(),
+      tinyOut.size()));
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that the uncompressed size of the header is validated
+/// before any memory is allocated.
+TEST(CompressionTest, SizeLimits)
+{
+  const std::string data(100000, 'a');
+
+  for (const Compression_t codec : kCodecs)
+  {
+    if (!(supportedCodecs() & codecMask(codec)))
+      continue;
+
+    std::vector<char> out(maxCompressedSize(codec, data.size()));
+    const std::size_t size = compress(codec, data.data(), data.size(),
+      out.data(), out.size());
+    ASSERT_GT(size, 0u);
+
+    // Messages bigger than the limit are rejected.
+    std::string result;
+    EXPECT_FALSE(decompress(out.data(), size, result, data.size() - 1));
+    EXPECT_TRUE(decompress(out.data(), size, result, data.size()));
+    EXPECT_EQ(data, result);
+
+    // A header claiming a size that the input can't expand to is rejected,
+    // 1 GiB here.
+    std::vector<char> forged(out.begin(), out.begin() + size);
+    for (std::size_t i = 2; i < kCompressionHeaderSize; ++i)
+      forged[i] = 0;
+    forged[5] = static_cast<char>(0x40);
+    result.clear();
+    EXPECT_FALSE(decompress(forged.data(), forged.size(), result,
+      static_cast<std::size_t>(-1)));
+    EXPECT_TRUE(result.empty());
+  }
+}
@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <zmq.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ConnectionMonitor.hh"
+
+namespace gz
+{
+  namespace transport
+  {
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE
+    {
+    /// \internal
+    /// \brief Private data for ConnectionMonitor.
+    class ConnectionMonitorPrivate
+    {
+      /// \brief Event reporting that a peer is ready. The handshake event
+      /// is only available in recent versions of ZMQ. Otherwise, the TCP
+      /// connection is the best approximation.
+#ifdef ZMQ_EVENT_HANDSHAKE_SUCCEEDED
+      public: static constexpr int kReadyEvent =
+        ZMQ_EVENT_HANDSHAKE_SUCCEEDED;
+#else
+      public: static constexpr int kReadyEvent = ZMQ_EVENT_CONNECTED;
+#endif
+
+      /// \brief The monitored socket.
+      public: void *socket = nullptr;
+
+      /// \brief Socket receiving the monitor events, or nullptr if the
+      /// monitor is not enabled.
+      public: void *pair = nullptr;
+
+      /// \brief State of a tracked endpoint.
+      public: struct Endpoint
+              {
+                /// \brief True once the handshake succeeded.
+                public: bool ready = false;
+
+                /// \brief When the endpoint started being tracked.
+                public: std::chrono::steady_clock::time_point added;
+              };
+
+      /// \brief Tracked endpoints.
+      public: std::unordered_map<std::string, Endpoint> endpoints;
+
+      /// \brief Number of tracked endpoints that are not ready.
+      public: std::size_t pending = 0;
+    };
+    }
+  }
+}
+
+using namespace gz;
+using namespace transport;
+
+//////////////////////////////////////////////////
+ConnectionMonitor::ConnectionMonitor(void *_context, void *_socket)
+  : dataPtr(new ConnectionMonitorPrivate())
+{
+  this->dataPtr->socket = _socket;
+
+  // The address of the socket makes the endpoint unique in the context.
+  std::ostringstream endpoint;
+  endpoint << "inproc://gz-transport-monitor-" << _socket;
+
+  if (zmq_socket_monitor(_socket, endpoint.str().c_str(),
+        ConnectionMonitorPrivate::kReadyEvent) != 0)
+  {
+    std::cerr << "ConnectionMonitor() error: " << zmq_strerror(zmq_errno())
+              << std::endl;
+    return;
+  }
+
+  void *pair = zmq_socket(_context, ZMQ_PAIR);
+  const int kZero = 0;
+  if (!pair ||
+      zmq_setsockopt(pair, ZMQ_LINGER, &kZero, sizeof(kZero)) != 0 ||
+      zmq_connect(pair, endpoint.str().c_str()) != 0)
+  {
+    std::cerr << "ConnectionMonitor() error: " << zmq_strerror(zmq_errno())
+              << std::endl;
+    if (pair)
+      zmq_close(pair);
+    zmq_socket_monitor(_socket, nullptr, 0);
+    return;
+  }
+
+  this->dataPtr->pair = pair;
+}
+
+//////////////////////////////////////////////////
+ConnectionMonitor::~ConnectionMonitor()
+{
+  if (!this->dataPtr->pair)
+    return;
+
+  zmq_socket_monitor(this->dataPtr->socket, nullptr, 0);
+  zmq_close(this->dataPtr->pair);
+}
+
+//////////////////////////////////////////////////
+bool ConnectionMonitor::Enabled() const
+{
+  return this->dataPtr->pair != nullptr;
+}
+
+//////////////////////////////////////////////////
+bool ConnectionMonitor::Add(const std::string &_endpoint)
+{
+  ConnectionMonitorPrivate::Endpoint entry;
+  entry.added = std::chrono::steady_clock::now();
+  if (!this->dataPtr->endpoints.emplace(_endpoint, entry).second)
+    return false;
+
+  ++this->dataPtr->pending;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ConnectionMonitor::Remove(const std::string &_endpoint)
+{
+  auto it = this->dataPtr->endpoints.find(_endpoint);
+  if (it == this->dataPtr->endpoints.end())
+    return;
+
+  if (!it->second.ready)
+    --this->dataPtr->pending;
+  this->dataPtr->endpoints.erase(it);
+}
+
+//////////////////////////////////////////////////
+bool ConnectionMonitor::Ready(const std::string &_endpoint) const
+{
+  auto it = this->dataPtr->endpoints.find(_endpoint);
+  return it != this->dataPtr->endpoints.end() && it->second.ready;
+}
+
+//////////////////////////////////////////////////
+bool ConnectionMonitor::HasPending() const
+{
+  return this->dataPtr->pending > 0;
+}
+
+//////////////////////////////////////////////////
+std::vector<std::string> ConnectionMonitor::ProcessEvents()
+{
+  std::vector<std::string> ready;
+  if (!this->dataPtr->pair)
+    return ready;
+
+  // Each event has two frames: the event number and value, followed by
+  // the endpoint.
+  while (true)
+  {
+    zmq_msg_t event;
+    zmq_msg_init(&event);
+    if (zmq_msg_recv(&event, this->dataPtr->pair, ZMQ_DONTWAIT) < 0)
+    {
+      zmq_msg_close(&event);
+      break;
+    }
+
+    uint16_t eventId = 0;
+    if (zmq_msg_size(&event) >= sizeof(eventId))
+      memcpy(&eventId, zmq_msg_data(&event), sizeof(eventId));
+    const bool more = zmq_msg_more(&event);
+    zmq_msg_close(&event);
+
+    if (!more)
+      continue;
+
+    zmq_msg_t address;
+    zmq_msg_init(&address);
+    if (zmq_msg_recv(&address, this->dataPtr->pair, 0) < 0)
+    {
+      zmq_msg_close(&address);
+      break;
+    }
+    const std::string endpoint(static_cast<char *>(zmq_msg_data(&address)),
+      zmq_msg_size(&address));
+    zmq_msg_close(&address);
+
+    if (eventId != ConnectionMonitorPrivate::kReadyEvent)
+      continue;
+
+    auto it = this->dataPtr->endpoints.find(endpoint);
+    if (it != this->dataPtr->endpoints.end() && !it->second.ready)
+    {
+      it->second.ready = true;
+      --this->dataPtr->pending;
+      ready.push_back(endpoint);
+    }
+  }
+
+  return ready;
+}
+
+//////////////////////////////////////////////////
+std::vector<std::string> ConnectionMonitor::ProcessTimeouts(
+  const std::chrono::milliseconds &_timeout)
+{
+  std::vector<std::string> ready;
+  if (this->dataPtr->pending == 0)
+    return ready;
+
+  const auto now = std::chrono::steady_clock::now();
+  for (auto &entry : this->dataPtr->endpoints)
+  {
+    if (!entry.second.ready && now - entry.second.added >= _timeout)
+    {
+      entry.second.ready = true;
+      --this->dataPtr->pending;
+      ready.push_back(entry.first);
+    }
+  }
+
+  return ready;
+}
+
+//////////////////////////////////////////////////
+void *ConnectionMonitor::Socket() const
+{
+  return this->dataPtr->pair;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_TRANSPORT_CONNECTIONMONITOR_HH_
+#define GZ_TRANSPORT_CONNECTIONMONITOR_HH_
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gz/transport/config.hh"
+
+namespace gz
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE {
+    //
+    // Forward declarations.
+    class ConnectionMonitorPrivate;
+
+    /// \class ConnectionMonitor ConnectionMonitor.hh
+    /// \brief Internal tracker of the endpoints that a ZMQ socket connects
+    /// to. It listens to the socket monitor events, so the caller knows
+    /// when the handshake with a peer succeeded and messages can be routed
+    /// to it, instead of waiting an arbitrary time after connecting.
+    ///
+    /// The polling thread adds Socket() to the items that it polls and
+    /// calls ProcessEvents() when the socket is readable. As a safety net
+    /// for peers whose events are missed, it also calls ProcessTimeouts()
+    /// periodically while HasPending() is true. The class is not
+    /// thread-safe: all the calls must be serialized by the caller.
+    class ConnectionMonitor
+    {
+      /// \brief Constructor. Starts monitoring a socket.
+      /// \param[in] _context ZMQ context of the socket.
+      /// \param[in] _socket The ZMQ socket to monitor.
+      public: ConnectionMonitor(void *_context, void *_socket);
+
+      /// \brief Destructor. Stops monitoring the socket.
+      public: ~ConnectionMonitor();
+
+      /// \brief Whether the monitor is working. Otherwise, the endpoints
+      /// only become ready through ProcessTimeouts().
+      /// \return True if the socket is monitored.
+      public: bool Enabled() const;
+
+      /// \brief Start tracking an endpoint. It is not ready until the
+      /// handshake succeeds.
+      /// \param[in] _endpoint The endpoint.
+      /// \return True if the endpoint was not tracked yet, meaning that the
+      /// caller should connect to it.
+      public: bool Add(const std::string &_endpoint);
+
+      /// \brief Stop tracking an endpoint.
+      /// \param[in] _endpoint The endpoint.
+      public: void Remove(const std::string &_endpoint);
+
+      /// \brief Check if the handshake with an endpoint succeeded.
+      /// \param[in] _endpoint The endpoint.
+      /// \return True if messages can be sent to the endpoint.
+      public: bool Ready(const std::string &_endpoint) const;
+
+      /// \brief Check if any tracked endpoint is waiting for its handshake.
+      /// \return True if there is at least one endpoint not ready.
+      public: bool HasPending() const;
+
+      /// \brief Consume the pending monitor events.
+      /// \return The tracked endpoints that became ready.
+      public: std::vector<std::string> ProcessEvents();
+
+      /// \brief Consider ready the endpoints that have been waiting for
+      /// their handshake for too long.
+      /// \param[in] _timeout Maximum waiting time.
+      /// \return The tracked endpoints that became ready.
+      public: std::vector<std::string> ProcessTimeouts(
+        const std::chrono::milliseconds &_timeout);
+
+      /// \brief Get the ZMQ socket to poll. It becomes readable when there
+      /// are monitor events.
+      /// \return Pointer to the underlying ZMQ socket or nullptr if the
+      /// monitor is not enabled.
+      public: void *Socket() const;
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<ConnectionMonitorPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <zmq.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ConnectionMonitor.hh"
+
+using namespace gz;
+using namespace transport;
+
+//////////////////////////////////////////////////
+/// \brief Wait until an endpoint becomes ready.
+/// \param[in] _monitor The monitor.
+/// \param[in] _endpoint The endpoint.
+/// \return True if the endpoint became ready before a timeout.
+static bool waitReady(ConnectionMonitor &_monitor,
+  const std::string &_endpoint)
+{
+  const auto deadline =
+    std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (std::chrono::steady_clock::now() < deadline)
+  {
+    zmq::pollitem_t items[] =
+    {
+      {_monitor.Socket(), 0, ZMQ_POLLIN, 0},
+    };
+    zmq::poll(&items[0], 1, std::chrono::milliseconds(100));
+
+    for (const auto &endpoint : _monitor.ProcessEvents())
+    {
+      if (endpoint == _endpoint)
+        return true;
+    }
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that an endpoint becomes ready after the handshake.
+TEST(ConnectionMonitorTest, Handshake)
+{
+  zmq::context_t context(1);
+  zmq::socket_t server(context, ZMQ_ROUTER);
+  zmq::socket_t client(context, ZMQ_ROUTER);
+  const int kZero = 0;
+  zmq_setsockopt(static_cast<void *>(server), ZMQ_LINGER, &kZero,
+    sizeof(kZero));
+  zmq_setsockopt(static_cast<void *>(client), ZMQ_LINGER, &kZero,
+    sizeof(kZero));
+
+  server.bind("tcp://127.0.0.1:*");
+  char buffer[256];
+  size_t size = sizeof(buffer);
+  ASSERT_EQ(0, zmq_getsockopt(static_cast<void *>(server),
+    ZMQ_LAST_ENDPOINT, buffer, &size));
+  const std::string endpoint = buffer;
+
+  {
+    ConnectionMonitor monitor(static_cast<void *>(context),
+      static_cast<void *>(client));
+    ASSERT_TRUE(monitor.Enabled());
+    ASSERT_NE(nullptr, monitor.Socket());
+
+    EXPECT_FALSE(monitor.HasPending());
+    EXPECT_TRUE(monitor.Add(endpoint));
+    EXPECT_FALSE(monitor.Add(endpoint));
+    EXPECT_FALSE(monitor.Ready(endpoint));
+    EXPECT_TRUE(monitor.HasPending());
+
+    client.connect(endpoint);
+    EXPECT_TRUE(waitReady(monitor, endpoint));
+    EXPECT_TRUE(monitor.Ready(endpoint));
+    EXPECT_FALSE(monitor.HasPending());
+
+    monitor.Remove(endpoint);
+    EXPECT_FALSE(monitor.Ready(endpoint));
+    EXPECT_TRUE(monitor.Add(endpoint));
+  }
+
+  // The socket is usable after the monitor is destroyed.
+  ConnectionMonitor monitor(static_cast<void *>(context),
+    static_cast<void *>(client));
+  EXPECT_TRUE(monitor.Enabled());
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that the endpoints without handshake events become ready
+/// after a timeout.
+TEST(ConnectionMonitorTest, Timeouts)
+{
+  zmq::context_t context(1);
+  zmq::socket_t client(context, ZMQ_ROUTER);
+
+  ConnectionMonitor monitor(static_cast<void *>(context),
+    static_cast<void *>(client));
+
+  const std::string endpoint = "tcp://127.0.0.1:1";
+  EXPECT_TRUE(monitor.ProcessTimeouts(std::chrono::milliseconds(0)).empty());
+
+  EXPECT_TRUE(monitor.Add(endpoint));
+  EXPECT_TRUE(monitor.ProcessTimeouts(std::chrono::hours(1)).empty());
+  EXPECT_FALSE(monitor.Ready(endpoint));
+
+  std::vector<std::string> ready =
+    monitor.ProcessTimeouts(std::chrono::milliseconds(0));
+  ASSERT_EQ(1u, ready.size());
+  EXPECT_EQ(endpoint, ready.front());
+  EXPECT_TRUE(monitor.Ready(endpoint));
+  EXPECT_FALSE(monitor.HasPending());
+
+  // Removing a pending endpoint stops waiting for it.
+  EXPECT_TRUE(monitor.Add("tcp://127.0.0.1:2"));
+  EXPECT_TRUE(monitor.HasPending());
+  monitor.Remove("tcp://127.0.0.1:2");
+  EXPECT_FALSE(monitor.HasPending());
+  EXPECT_TRUE(monitor.ProcessTimeouts(std::chrono::milliseconds(0)).empty());
+}
@@ -65,6 +65,33 @@ inline namespace GZ_TRANSPORT_VERSION_NAMESPACE
     // Return if we got a reply.
     return items[0].revents & ZMQ_POLLIN;
   }
+
+  /////////////////////////////////////////////////
+  bool pollSockets(const std::vector<int> &_sockets, const int _timeout,
+    WakeupChannel &_wakeup)
+  {
+    zmq::pollitem_t items[] =
+    {
+      {0, static_cast<ZMQ_FD_T>(_sockets.at(0)), ZMQ_POLLIN, 0},
+      {_wakeup.Socket(), 0, ZMQ_POLLIN, 0},
+    };
+
+    try
+    {
+      zmq::poll(&items[0], sizeof(items) / sizeof(items[0]),
+          std::chrono::milliseconds(_timeout));
+    }
+    catch(...)
+    {
+      return false;
+    }
+
+    if (items[1].revents & ZMQ_POLLIN)
+      _wakeup.Drain();
+
+    // Return if we got a reply.
+    return items[0].revents & ZMQ_POLLIN;
+  }
 }
 }
 }
@@ -15,6 +15,7 @@
  *
 */
 
+#include <atomic>
 #include <chrono>
 #include <cstdlib>
 #include <memory>
@@ -193,6 +194,25 @@ TEST(DiscoveryTest, WithoutCallingStart)
   EXPECT_FALSE(discovery.Unadvertise(service, nUuid1));
 }
 
+//////////////////////////////////////////////////
+/// \brief Check that a running discovery stops without waiting for its
+/// next heartbeat.
+TEST(DiscoveryTest, ImmediateShutdown)
+{
+  auto discovery = std::make_unique<MsgDiscovery>(pUuid1, g_ip, g_msgPort);
+  discovery->SetHeartbeatInterval(10000);
+  discovery->SetActivityInterval(10000);
+  discovery->Start();
+
+  // Let the reception thread send its first heartbeat and block.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  auto start = std::chrono::steady_clock::now();
+  discovery.reset();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_LT(elapsed, std::chrono::milliseconds(200));
+}
+
 //////////////////////////////////////////////////
 /// \brief Advertise a topic without registering callbacks.
 TEST(DiscoveryTest, TestAdvertiseNoResponse)
@@ -501,6 +521,64 @@ TEST(DiscoveryTest, TestTwoPublishersSameTopic)
   EXPECT_EQ(g_counter, 2);
 }
 
+//////////////////////////////////////////////////
+/// \brief Check that the heartbeat announces all the topics advertised
+/// before a remote discovery node started. The advertisements don't fit in a
+/// single datagram.
+TEST(DiscoveryTest, TestHeartbeatAdvertisesAllTopics)
+{
+  const int kTopics = 300;
+  const std::string prefix = "/" + testing::getRandomNumber() + "/";
+  auto proc1Uuid = testing::getRandomNumber();
+  auto proc2Uuid = testing::getRandomNumber();
+  std::atomic<int> discovered(0);
+  std::atomic<bool> processScopeDiscovered(false);
+
+  MsgDiscovery discovery1(proc1Uuid, g_ip, g_msgPort);
+  discovery1.Start();
+
+  for (int i = 0; i < kTopics; ++i)
+  {
+    MessagePublisher publisher(prefix + "topic_" + std::to_string(i), addr1,
+      ctrl1, proc1Uuid, nUuid1, "type", AdvertiseMessageOptions());
+    EXPECT_TRUE(discovery1.Advertise(publisher));
+  }
+
+  AdvertiseMessageOptions opts;
+  opts.SetScope(Scope_t::PROCESS);
+  MessagePublisher processPublisher(prefix + "process", addr1, ctrl1,
+    proc1Uuid, nUuid1, "type", opts);
+  EXPECT_TRUE(discovery1.Advertise(processPublisher));
+
+  // The second node only learns about the topics from the heartbeats.
+  MsgDiscovery discovery2(proc2Uuid, g_ip, g_msgPort);
+  discovery2.ConnectionsCb(
+    [&](const MessagePublisher &_publisher)
+    {
+      if (_publisher.PUuid() != proc1Uuid ||
+          _publisher.Topic().find(prefix) != 0)
+      {
+        return;
+      }
+
+      if (_publisher.Topic() == processPublisher.Topic())
+        processScopeDiscovered = true;
+      else
+        ++discovered;
+    });
+  discovery2.Start();
+
+  int i = 0;
+  while (i < 3 * MaxIters && discovered < kTopics)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(Nap));
+    ++i;
+  }
+
+  EXPECT_EQ(kTopics, discovered);
+  EXPECT_FALSE(processScopeDiscovered);
+}
+
 //////////////////////////////////////////////////
 /// \brief Check that a discovery service sends messages if there are
 /// topics or services advertised in its process.
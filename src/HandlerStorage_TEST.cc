@@ -239,3 +239,64 @@ TEST(RepStorageTest, SubStorageNoCallbacks)
   EXPECT_EQ(handler->NodeUuid(), sub1HandlerPtr->NodeUuid());
   EXPECT_EQ(handler->HandlerUuid(), sub1HandlerPtr->HandlerUuid());
 }
+
+//////////////////////////////////////////////////
+/// \brief Check that the snapshots follow the changes of the storage and
+/// are not modified once returned.
+TEST(RepStorageTest, SubStorageSnapshot)
+{
+  transport::HandlerStorage<transport::ISubscriptionHandler> subs(true);
+  EXPECT_EQ(nullptr, subs.Snapshot(topic));
+
+  std::shared_ptr<transport::SubscriptionHandler<gz::msgs::Int32>> h1(
+    new transport::SubscriptionHandler<gz::msgs::Int32>(nUuid1));
+  std::shared_ptr<transport::SubscriptionHandler<gz::msgs::Int32>> h2(
+    new transport::SubscriptionHandler<gz::msgs::Int32>(nUuid2));
+
+  subs.AddHandler(topic, nUuid1, h1);
+  auto snapshot1 = subs.Snapshot(topic);
+  ASSERT_NE(nullptr, snapshot1);
+  ASSERT_EQ(1u, snapshot1->size());
+  EXPECT_EQ(h1, snapshot1->at(0));
+  EXPECT_EQ(nullptr, subs.Snapshot("bar"));
+
+  // The handlers are keyed by the interned topic.
+  const transport::InternedTopic *topicId =
+    transport::InternTable::FindTopic(topic);
+  ASSERT_NE(nullptr, topicId);
+  EXPECT_EQ(snapshot1, subs.Snapshot(topicId));
+  EXPECT_EQ(nullptr,
+    subs.Snapshot(static_cast<const transport::InternedTopic *>(nullptr)));
+
+  // A new handler produces a new list. The old one doesn't change.
+  subs.AddHandler(topic, nUuid2, h2);
+  auto snapshot2 = subs.Snapshot(topic);
+  ASSERT_NE(nullptr, snapshot2);
+  ASSERT_EQ(2u, snapshot2->size());
+  EXPECT_EQ(h1, snapshot2->at(0));
+  EXPECT_EQ(h2, snapshot2->at(1));
+  EXPECT_EQ(1u, snapshot1->size());
+
+  // Reading the same topic again doesn't copy the list.
+  EXPECT_EQ(snapshot2, subs.Snapshot(topic));
+
+  // Removing a handler that doesn't exist keeps the list.
+  EXPECT_FALSE(subs.RemoveHandler(topic, nUuid1, "unknown"));
+  EXPECT_EQ(snapshot2, subs.Snapshot(topic));
+
+  EXPECT_TRUE(subs.RemoveHandler(topic, nUuid1, h1->HandlerUuid()));
+  auto snapshot3 = subs.Snapshot(topic);
+  ASSERT_NE(nullptr, snapshot3);
+  ASSERT_EQ(1u, snapshot3->size());
+  EXPECT_EQ(h2, snapshot3->at(0));
+  EXPECT_EQ(2u, snapshot2->size());
+
+  EXPECT_TRUE(subs.RemoveHandlersForNode(topic, nUuid2));
+  EXPECT_EQ(nullptr, subs.Snapshot(topic));
+
+  // Without snapshots, only the maps are kept.
+  transport::HandlerStorage<transport::ISubscriptionHandler> noSnapshots;
+  noSnapshots.AddHandler(topic, nUuid1, h1);
+  EXPECT_TRUE(noSnapshots.HasHandlersForTopic(topic));
+  EXPECT_EQ(nullptr, noSnapshots.Snapshot(topic));
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <mutex>
+#include <shared_mutex>  //NOLINT
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "gz/transport/InternTable.hh"
+#include "gz/transport/TopicUtils.hh"
+
+using namespace gz;
+using namespace transport;
+
+namespace
+{
+  /// \brief Storage of the intern table. Elements of the node based
+  /// containers keep their address when the containers grow.
+  struct Table
+  {
+    /// \brief Protects strings and topics.
+    std::shared_mutex mutex;
+
+    /// \brief Interned strings.
+    std::unordered_set<std::string> strings;
+
+    /// \brief Interned fully qualified topics.
+    std::unordered_map<std::string, InternedTopic> topics;
+  };
+
+  //////////////////////////////////////////////////
+  /// \brief Get the table. It is never destroyed, so interned addresses
+  /// are valid even while other static objects are destroyed.
+  /// \return The table.
+  Table &table()
+  {
+    static Table *instance = new Table();
+    return *instance;
+  }
+}
+
+//////////////////////////////////////////////////
+const std::string *InternTable::String(const std::string &_str)
+{
+  Table &t = table();
+  {
+    std::shared_lock<std::shared_mutex> lk(t.mutex);
+    auto it = t.strings.find(_str);
+    if (it != t.strings.end())
+      return &(*it);
+  }
+
+  std::unique_lock<std::shared_mutex> lk(t.mutex);
+  return &(*t.strings.insert(_str).first);
+}
+
+//////////////////////////////////////////////////
+const std::string *InternTable::Find(const std::string &_str)
+{
+  Table &t = table();
+  std::shared_lock<std::shared_mutex> lk(t.mutex);
+  auto it = t.strings.find(_str);
+  return it != t.strings.end() ? &(*it) : nullptr;
+}
+
+//////////////////////////////////////////////////
+const InternedTopic *InternTable::Topic(
+  const std::string &_fullyQualifiedName)
+{
+  Table &t = table();
+  {
+    std::shared_lock<std::shared_mutex> lk(t.mutex);
+    auto it = t.topics.find(_fullyQualifiedName);
+    if (it != t.topics.end())
+      return &it->second;
+  }
+
+  // Decompose the name outside of the lock.
+  InternedTopic entry;
+  entry.fullyQualified = _fullyQualifiedName;
+  entry.valid = TopicUtils::DecomposeFullyQualifiedTopic(
+    _fullyQualifiedName, entry.partition, entry.topic);
+
+  std::unique_lock<std::shared_mutex> lk(t.mutex);
+  return &t.topics.emplace(_fullyQualifiedName, std::move(entry))
+    .first->second;
+}
+
+//////////////////////////////////////////////////
+const InternedTopic *InternTable::FindTopic(
+  const std::string &_fullyQualifiedName)
+{
+  Table &t = table();
+  std::shared_lock<std::shared_mutex> lk(t.mutex);
+  auto it = t.topics.find(_fullyQualifiedName);
+  return it != t.topics.end() ? &it->second : nullptr;
+}
+
+//////////////////////////////////////////////////
+std::size_t InternTable::Size()
+{
+  Table &t = table();
+  std::shared_lock<std::shared_mutex> lk(t.mutex);
+  return t.strings.size() + t.topics.size();
+}
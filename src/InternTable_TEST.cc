@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gz/transport/InternTable.hh"
+
+using namespace gz;
+using namespace transport;
+
+//////////////////////////////////////////////////
+/// \brief Check that equal strings are interned to the same address.
+TEST(InternTableTest, String)
+{
+  const std::string a = "gz.msgs.StringMsg";
+  const std::string b = std::string("gz.msgs.") + "StringMsg";
+
+  const std::string *idA = InternTable::String(a);
+  const std::string *idB = InternTable::String(b);
+  ASSERT_NE(nullptr, idA);
+  EXPECT_EQ(idA, idB);
+  EXPECT_EQ(a, *idA);
+
+  const std::string *idC = InternTable::String("gz.msgs.Int32");
+  EXPECT_NE(idA, idC);
+
+  // Interning again does not grow the table.
+  const std::size_t size = InternTable::Size();
+  EXPECT_EQ(idA, InternTable::String(a));
+  EXPECT_EQ(size, InternTable::Size());
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that fully qualified topics are decomposed once.
+TEST(InternTableTest, Topic)
+{
+  const std::string fq = "@/partition@/topic";
+  const InternedTopic *topic = InternTable::Topic(fq);
+  ASSERT_NE(nullptr, topic);
+  EXPECT_TRUE(topic->valid);
+  EXPECT_EQ(fq, topic->fullyQualified);
+  EXPECT_EQ("/partition", topic->partition);
+  EXPECT_EQ("/topic", topic->topic);
+  EXPECT_EQ(topic, InternTable::Topic(fq));
+
+  const InternedTopic *invalid = InternTable::Topic("not a topic");
+  ASSERT_NE(nullptr, invalid);
+  EXPECT_FALSE(invalid->valid);
+  EXPECT_TRUE(invalid->partition.empty());
+  EXPECT_TRUE(invalid->topic.empty());
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that the lookups never add entries.
+TEST(InternTableTest, Find)
+{
+  const std::size_t size = InternTable::Size();
+  EXPECT_EQ(nullptr, InternTable::Find("gz.msgs.NotInterned"));
+  EXPECT_EQ(nullptr, InternTable::FindTopic("@/partition@/not_interned"));
+  EXPECT_EQ(size, InternTable::Size());
+
+  const std::string *id = InternTable::String("gz.msgs.Interned");
+  EXPECT_EQ(id, InternTable::Find("gz.msgs.Interned"));
+
+  const InternedTopic *topic = InternTable::Topic("@/partition@/interned");
+  EXPECT_EQ(topic, InternTable::FindTopic("@/partition@/interned"));
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that the table can be used from multiple threads.
+TEST(InternTableTest, Concurrency)
+{
+  const int kThreads = 4;
+  const int kNames = 100;
+
+  std::vector<std::vector<const std::string *>> ids(kThreads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i)
+  {
+    threads.emplace_back([&ids, i]()
+    {
+      for (int j = 0; j < kNames; ++j)
+        ids[i].push_back(InternTable::String("name" + std::to_string(j)));
+    });
+  }
+
+  for (auto &t : threads)
+    t.join();
+
+  for (int i = 1; i < kThreads; ++i)
+    EXPECT_EQ(ids[0], ids[i]);
+}
@@ -15,8 +15,11 @@
  *
 */
 
+#include <memory>
 #include <string>
+#include <utility>
 
+#include "gz/transport/InternTable.hh"
 #include "gz/transport/MessageInfo.hh"
 #include "gz/transport/TopicUtils.hh"
 
@@ -29,6 +32,91 @@ namespace gz
   {
     inline namespace GZ_TRANSPORT_VERSION_NAMESPACE
     {
+    /// \internal
+    /// \brief A name that references its interned instance, so copying it
+    /// does not allocate. Names that were never interned, such as the ones
+    /// received from unknown peers, are copied instead of interned, so they
+    /// don't grow the InternTable.
+    class MessageInfoName
+    {
+      /// \brief Default constructor. The name is empty.
+      public: MessageInfoName() = default;
+
+      /// \brief Copy constructor.
+      /// \param[in] _other Name to copy.
+      public: MessageInfoName(const MessageInfoName &_other)
+      {
+        *this = _other;
+      }
+
+      /// \brief Assignment operator.
+      /// \param[in] _other Name to copy.
+      /// \return Reference to this name.
+      public: MessageInfoName &operator=(const MessageInfoName &_other)
+      {
+        if (this != &_other)
+        {
+          if (_other.name == &_other.copy)
+            this->Own(_other.copy);
+          else
+            this->name = _other.name;
+        }
+        return *this;
+      }
+
+      /// \brief Set the name.
+      /// \param[in] _name The new name.
+      public: void Set(const std::string &_name)
+      {
+        this->name = InternTable::Find(_name);
+        if (!this->name)
+          this->Own(_name);
+      }
+
+      /// \brief Set the name to an interned string.
+      /// \param[in] _name The interned name.
+      public: void Set(const std::string *_name)
+      {
+        this->name = _name;
+      }
+
+      /// \brief Get the name.
+      /// \return The name.
+      public: const std::string &Get() const
+      {
+        return *this->name;
+      }
+
+      /// \brief Get the interned instance of the name.
+      /// \return The interned name, or nullptr if the name is a copy.
+      public: const std::string *Interned() const
+      {
+        return this->name == &this->copy ? nullptr : this->name;
+      }
+
+      /// \brief Store a copy of a name.
+      /// \param[in] _name The name.
+      private: void Own(const std::string &_name)
+      {
+        this->copy = _name;
+        this->name = &this->copy;
+      }
+
+      /// \brief Interned empty string.
+      /// \return The empty string.
+      private: static const std::string *Empty()
+      {
+        static const std::string *empty = InternTable::String("");
+        return empty;
+      }
+
+      /// \brief The name, either interned or pointing to copy.
+      private: const std::string *name = Empty();
+
+      /// \brief Copy of a name that is not interned.
+      private: std::string copy;
+    };
+
     /// \internal
     /// \brief Private data for MessageInfo class.
     class MessageInfoPrivate
@@ -40,13 +128,13 @@ namespace gz
       public: virtual ~MessageInfoPrivate() = default;
 
       /// \brief Topic name.
-      public: std::string topic = "";
+      public: MessageInfoName topic;
 
       /// \brief Message type name.
-      public: std::string type = "";
+      public: MessageInfoName type;
 
       /// \brief Partition name.
-      public: std::string partition = "";
+      public: MessageInfoName partition;
 
       /// \brief Was the message sent via intra-process?
       public: bool isIntraProcess = false;
@@ -55,6 +143,31 @@ namespace gz
   }
 }
 
+//////////////////////////////////////////////////
+/// \brief Private data to read, which is empty if the MessageInfo was
+/// moved from.
+/// \param[in] _dataPtr Pointer to the private data, or nullptr.
+/// \return The private data, or the empty data.
+static const MessageInfoPrivate &ReadData(
+    const std::unique_ptr<MessageInfoPrivate> &_dataPtr)
+{
+  static const MessageInfoPrivate empty;
+  return _dataPtr ? *_dataPtr : empty;
+}
+
+//////////////////////////////////////////////////
+/// \brief Private data to modify, created if the MessageInfo was moved
+/// from.
+/// \param[in, out] _dataPtr Pointer to the private data.
+/// \return The private data.
+static MessageInfoPrivate &WriteData(
+    std::unique_ptr<MessageInfoPrivate> &_dataPtr)
+{
+  if (!_dataPtr)
+    _dataPtr.reset(new MessageInfoPrivate());
+  return *_dataPtr;
+}
+
 //////////////////////////////////////////////////
 MessageInfo::MessageInfo()
   : dataPtr(new MessageInfoPrivate())
@@ -63,15 +176,16 @@ MessageInfo::MessageInfo()
 
 //////////////////////////////////////////////////
 MessageInfo::MessageInfo(const MessageInfo &_other)
-  : dataPtr(new MessageInfoPrivate())
+  : dataPtr(new MessageInfoPrivate(ReadData(_other.dataPtr)))
 {
-  *this->dataPtr = *_other.dataPtr;
 }
 
 //////////////////////////////////////////////////
 MessageInfo::MessageInfo(MessageInfo &&_other)  // NOLINT
   : dataPtr(std::move(_other.dataPtr))
 {
+  // The moved from object is left without data and reads as empty until it
+  // is modified.
 }
 
 //////////////////////////////////////////////////
@@ -79,59 +193,113 @@ MessageInfo::~MessageInfo()
 {
 }
 
+//////////////////////////////////////////////////
+MessageInfo &MessageInfo::operator=(const MessageInfo &_other)
+{
+  if (this != &_other)
+    WriteData(this->dataPtr) = ReadData(_other.dataPtr);
+  return *this;
+}
+
+//////////////////////////////////////////////////
+MessageInfo &MessageInfo::operator=(MessageInfo &&_other)  // NOLINT
+{
+  if (this != &_other)
+    this->dataPtr = std::move(_other.dataPtr);
+  return *this;
+}
+
 //////////////////////////////////////////////////
 const std::string &MessageInfo::Topic() const
 {
-  return this->dataPtr->topic;
+  return ReadData(this->dataPtr).topic.Get();
 }
 
 //////////////////////////////////////////////////
 void MessageInfo::SetTopic(const std::string &_topic)
 {
-  this->dataPtr->topic = _topic;
+  WriteData(this->dataPtr).topic.Set(_topic);
 }
 
 //////////////////////////////////////////////////
 const std::string &MessageInfo::Type() const
 {
-  return this->dataPtr->type;
+  return ReadData(this->dataPtr).type.Get();
 }
 
 //////////////////////////////////////////////////
 void MessageInfo::SetType(const std::string &_type)
 {
-  this->dataPtr->type = _type;
+  WriteData(this->dataPtr).type.Set(_type);
 }
 
 //////////////////////////////////////////////////
 const std::string &MessageInfo::Partition() const
 {
-  return this->dataPtr->partition;
+  return ReadData(this->dataPtr).partition.Get();
 }
 
 //////////////////////////////////////////////////
 void MessageInfo::SetPartition(const std::string &_partition)
 {
-  this->dataPtr->partition = _partition;
+  WriteData(this->dataPtr).partition.Set(_partition);
 }
 
 //////////////////////////////////////////////////
 bool MessageInfo::SetTopicAndPartition(const std::string &_fullyQualifiedName)
 {
-  return TopicUtils::DecomposeFullyQualifiedTopic(
-        _fullyQualifiedName,
-        this->dataPtr->partition,
-        this->dataPtr->topic);
+  // The names of the local handlers and publishers are decomposed only
+  // once, when they are interned.
+  const InternedTopic *entry = InternTable::FindTopic(_fullyQualifiedName);
+  if (entry)
+    return this->SetTopicAndPartition(*entry);
+
+  std::string partition;
+  std::string topic;
+  if (!TopicUtils::DecomposeFullyQualifiedTopic(_fullyQualifiedName,
+        partition, topic))
+  {
+    return false;
+  }
+
+  MessageInfoPrivate &data = WriteData(this->dataPtr);
+  data.partition.Set(partition);
+  data.topic.Set(topic);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool MessageInfo::SetTopicAndPartition(const InternedTopic &_topic)
+{
+  if (!_topic.valid)
+    return false;
+
+  MessageInfoPrivate &data = WriteData(this->dataPtr);
+  data.partition.Set(&_topic.partition);
+  data.topic.Set(&_topic.topic);
+  return true;
+}
+
+//////////////////////////////////////////////////
+const std::string *MessageInfo::TypeId() const
+{
+  return ReadData(this->dataPtr).type.Interned();
+}
+
+//////////////////////////////////////////////////
+void MessageInfo::SetTypeId(const std::string *_typeId)
+{
+  WriteData(this->dataPtr).type.Set(_typeId);
 }
 
 //////////////////////////////////////////////////
 bool MessageInfo::IntraProcess() const
 {
-  return this->dataPtr->isIntraProcess;
+  return ReadData(this->dataPtr).isIntraProcess;
 }
 
 //////////////////////////////////////////////////
 void MessageInfo::SetIntraProcess(bool _value)
 {
-  this->dataPtr->isIntraProcess = _value;
+  WriteData(this->dataPtr).isIntraProcess = _value;
 }
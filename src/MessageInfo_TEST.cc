@@ -16,7 +16,9 @@
 */
 
 #include <string>
+#include <utility>
 
+#include "gz/transport/InternTable.hh"
 #include "gz/transport/MessageInfo.hh"
 #include "gtest/gtest.h"
 
@@ -126,3 +128,100 @@ TEST(MessageInfoTest, CopyConstructor)
   EXPECT_EQ("/b_topic", infoCopy.Topic());
   EXPECT_TRUE(infoCopy.IntraProcess());
 }
+
+//////////////////////////////////////////////////
+/// \brief Check the assignment operators.
+TEST(MessageInfoTest, Assignment)
+{
+  transport::MessageInfo info;
+  info.SetTopicAndPartition("@/a_partition@/b_topic");
+  info.SetIntraProcess(true);
+
+  transport::MessageInfo infoCopy;
+  infoCopy = info;
+  EXPECT_EQ("/a_partition", info.Partition());
+  EXPECT_EQ("/b_topic", info.Topic());
+  EXPECT_EQ("/a_partition", infoCopy.Partition());
+  EXPECT_EQ("/b_topic", infoCopy.Topic());
+  EXPECT_TRUE(infoCopy.IntraProcess());
+
+  transport::MessageInfo infoMoved;
+  infoMoved = std::move(infoCopy);
+  EXPECT_EQ("/b_topic", infoMoved.Topic());
+
+  // A moved from object can be assigned again.
+  infoCopy = infoMoved;
+  EXPECT_EQ("/b_topic", infoCopy.Topic());
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that a moved from object can still be used.
+TEST(MessageInfoTest, MovedFrom)
+{
+  transport::MessageInfo info;
+  info.SetTopicAndPartition("@/a_partition@/b_topic");
+
+  transport::MessageInfo infoMoved(std::move(info));
+  EXPECT_EQ("/b_topic", infoMoved.Topic());
+
+  EXPECT_TRUE(info.Topic().empty());
+  EXPECT_TRUE(info.Type().empty());
+  transport::MessageInfo infoCopy(info);
+  EXPECT_TRUE(infoCopy.Partition().empty());
+  info.SetTopic("/c_topic");
+  EXPECT_EQ("/c_topic", info.Topic());
+
+  transport::MessageInfo infoAssigned;
+  infoAssigned = std::move(infoMoved);
+  EXPECT_EQ("/b_topic", infoAssigned.Topic());
+  EXPECT_TRUE(infoMoved.Topic().empty());
+  transport::MessageInfo infoCopy2(infoMoved);
+  EXPECT_TRUE(infoCopy2.Topic().empty());
+  EXPECT_FALSE(infoMoved.IntraProcess());
+  infoMoved.SetIntraProcess(true);
+  EXPECT_TRUE(infoMoved.IntraProcess());
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that names received from the network are not interned.
+TEST(MessageInfoTest, NotInterned)
+{
+  const auto size = transport::InternTable::Size();
+
+  transport::MessageInfo info;
+  info.SetType(".msg.not_interned");
+  EXPECT_TRUE(info.SetTopicAndPartition("@/a_partition@/not_interned"));
+  EXPECT_EQ(size, transport::InternTable::Size());
+
+  transport::MessageInfo infoCopy(info);
+  EXPECT_EQ(".msg.not_interned", infoCopy.Type());
+  EXPECT_EQ("/a_partition", infoCopy.Partition());
+  EXPECT_EQ("/not_interned", infoCopy.Topic());
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that the interned names are used without looking them up.
+TEST(MessageInfoTest, InternedIds)
+{
+  const transport::InternedTopic *topic =
+    transport::InternTable::Topic("@/a_partition@/interned_id");
+  const std::string *typeId =
+    transport::InternTable::String(".msg.interned_id");
+
+  transport::MessageInfo info;
+  EXPECT_TRUE(info.SetTopicAndPartition(*topic));
+  info.SetTypeId(typeId);
+  EXPECT_EQ("/a_partition", info.Partition());
+  EXPECT_EQ("/interned_id", info.Topic());
+  EXPECT_EQ(".msg.interned_id", info.Type());
+  EXPECT_EQ(typeId, info.TypeId());
+
+  transport::MessageInfo infoCopy(info);
+  EXPECT_EQ(typeId, infoCopy.TypeId());
+
+  info.SetType(".msg.not_interned_id");
+  EXPECT_EQ(nullptr, info.TypeId());
+
+  EXPECT_FALSE(info.SetTopicAndPartition(
+    *transport::InternTable::Topic("invalid topic")));
+}
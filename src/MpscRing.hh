@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_TRANSPORT_MPSCRING_HH_
+#define GZ_TRANSPORT_MPSCRING_HH_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "gz/transport/config.hh"
+
+namespace gz
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE {
+    //
+    /// \class MpscRing MpscRing.hh
+    /// \brief Bounded lock-free queue with any number of producers and a
+    /// single consumer.
+    ///
+    /// The items live in preallocated slots, which are reused: TryPush()
+    /// move-assigns the item into its slot and TryPop() move-assigns it out.
+    /// Each slot carries a sequence number that tells whether it is free
+    /// or holds an item for a given position, so producers only contend on
+    /// the compare-and-swap of the write position.
+    /// \tparam T Default constructible and move assignable item type.
+    template<typename T>
+    class MpscRing
+    {
+      /// \brief Constructor.
+      /// \param[in] _capacity Minimum number of items. It is rounded up to a
+      /// power of two.
+      public: explicit MpscRing(const std::size_t _capacity)
+      {
+        std::size_t capacity = 1;
+        while (capacity < _capacity)
+          capacity <<= 1;
+
+        this->mask = capacity - 1;
+        this->slots.reset(new Slot[capacity]);
+        for (std::size_t i = 0; i < capacity; ++i)
+          this->slots[i].sequence.store(i, std::memory_order_relaxed);
+      }
+
+      /// \brief Add an item. It can be called from any thread.
+      /// \param[in, out] _item The item. It is only moved from on success.
+      /// \return True on success or false if the ring is full.
+      public: bool TryPush(T &&_item)
+      {
+        std::size_t pos = this->head.load(std::memory_order_relaxed);
+        Slot *slot;
+        while (true)
+        {
+          slot = &this->slots[pos & this->mask];
+          const std::size_t seq =
+            slot->sequence.load(std::memory_order_acquire);
+          const auto diff =
+            static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+          if (diff == 0)
+          {
+            // The slot is free for this position, try to claim it.
+            if (this->head.compare_exchange_weak(pos, pos + 1,
+                  std::memory_order_relaxed))
+            {
+              break;
+            }
+          }
+          else if (diff < 0)
+          {
+            // The slot still holds the item of the previous lap.
+            return false;
+          }
+          else
+          {
+            // Another producer claimed the position.
+            pos = this->head.load(std::memory_order_relaxed);
+          }
+        }
+
+        slot->item = std::move(_item);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+
+      /// \brief Remove the oldest item. It must only be called from the
+      /// consumer thread.
+      /// \param[out] _item The item.
+      /// \return True on success or false if the ring is empty or the
+      /// oldest item is still being written.
+      public: bool TryPop(T &_item)
+      {
+        const std::size_t pos = this->tail.load(std::memory_order_relaxed);
+        Slot &slot = this->slots[pos & this->mask];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+          return false;
+
+        _item = std::move(slot.item);
+        slot.sequence.store(pos + this->mask + 1, std::memory_order_release);
+        this->tail.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+
+      /// \brief Get the number of items in the ring, including the ones
+      /// still being written. It can be called from any thread, and the
+      /// result may be outdated.
+      /// \return The number of items.
+      public: std::size_t Size() const
+      {
+        const std::size_t t = this->tail.load(std::memory_order_acquire);
+        const std::size_t h = this->head.load(std::memory_order_acquire);
+        return h > t ? h - t : 0;
+      }
+
+      /// \brief Check if the ring is empty. See Size().
+      /// \return True if the ring is empty.
+      public: bool Empty() const
+      {
+        return this->Size() == 0;
+      }
+
+      /// \brief Get the number of slots.
+      /// \return The capacity.
+      public: std::size_t Capacity() const
+      {
+        return this->mask + 1;
+      }
+
+      /// \brief A slot of the ring.
+      private: struct Slot
+      {
+        /// \brief Position of the item that the slot holds (plus one) or
+        /// expects next.
+        std::atomic<std::size_t> sequence{0};
+
+        /// \brief The item.
+        T item;
+      };
+
+      /// \brief The slots.
+      private: std::unique_ptr<Slot[]> slots;
+
+      /// \brief Capacity minus one.
+      private: std::size_t mask = 0;
+
+      /// \brief Next position to write. Padded so the producers don't
+      /// share a cache line with the consumer.
+      private: alignas(64) std::atomic<std::size_t> head{0};
+
+      /// \brief Next position to read.
+      private: alignas(64) std::atomic<std::size_t> tail{0};
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "MpscRing.hh"
+
+using namespace gz;
+using namespace transport;
+
+//////////////////////////////////////////////////
+/// \brief Check the capacity, the order of the items and a full ring.
+TEST(MpscRingTest, PushPop)
+{
+  MpscRing<std::string> ring(3);
+  EXPECT_EQ(4u, ring.Capacity());
+  EXPECT_TRUE(ring.Empty());
+
+  std::string item;
+  EXPECT_FALSE(ring.TryPop(item));
+
+  for (int i = 0; i < 4; ++i)
+  {
+    std::string value = std::to_string(i);
+    EXPECT_TRUE(ring.TryPush(std::move(value)));
+  }
+  EXPECT_EQ(4u, ring.Size());
+
+  // A failed push doesn't move from the item.
+  std::string extra = "extra";
+  EXPECT_FALSE(ring.TryPush(std::move(extra)));
+  EXPECT_EQ("extra", extra);
+
+  for (int i = 0; i < 4; ++i)
+  {
+    ASSERT_TRUE(ring.TryPop(item));
+    EXPECT_EQ(std::to_string(i), item);
+  }
+  EXPECT_FALSE(ring.TryPop(item));
+  EXPECT_TRUE(ring.Empty());
+
+  // The slots are reused after wrapping around.
+  EXPECT_TRUE(ring.TryPush(std::move(extra)));
+  ASSERT_TRUE(ring.TryPop(item));
+  EXPECT_EQ("extra", item);
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that every item pushed by several producers is popped once,
+/// in the order in which each producer pushed it.
+TEST(MpscRingTest, MultipleProducers)
+{
+  const int kProducers = 4;
+  const int kItems = 10000;
+  MpscRing<std::pair<int, int>> ring(64);
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p)
+  {
+    producers.emplace_back([&ring, p]()
+    {
+      for (int i = 0; i < kItems; ++i)
+      {
+        while (!ring.TryPush({p, i}))
+          std::this_thread::yield();
+      }
+    });
+  }
+
+  std::vector<int> next(kProducers, 0);
+  int popped = 0;
+  std::pair<int, int> item;
+  while (popped < kProducers * kItems)
+  {
+    if (!ring.TryPop(item))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    EXPECT_EQ(next[item.first], item.second);
+    next[item.first] = item.second + 1;
+    ++popped;
+  }
+
+  for (auto &producer : producers)
+    producer.join();
+
+  EXPECT_TRUE(ring.Empty());
+}
@@ -21,6 +21,7 @@
 #include <cassert>
 #include <csignal>
 #include <condition_variable>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -29,7 +30,10 @@
 #include <unordered_set>
 #include <vector>
 
+#include "gz/transport/BufferPool.hh"
+#include "gz/transport/Compression.hh"
 #include "gz/transport/Helpers.hh"
+#include "gz/transport/InternTable.hh"
 #include "gz/transport/MessageInfo.hh"
 #include "gz/transport/Node.hh"
 #include "gz/transport/NodeOptions.hh"
@@ -86,6 +90,18 @@ namespace gz
       return NodeShared::Instance()->SndHwm();
     }
 
+    //////////////////////////////////////////////////
+    uint64_t publishQueueDepth()
+    {
+      return NodeShared::Instance()->PublishQueueDepth();
+    }
+
+    //////////////////////////////////////////////////
+    uint64_t publishQueueHighWater()
+    {
+      return NodeShared::Instance()->PublishQueueHighWater();
+    }
+
     //////////////////////////////////////////////////
     void waitForShutdown()
     {
@@ -112,7 +128,9 @@ namespace gz
       /// \param[in] _publisher The message publisher.
       public: explicit PublisherPrivate(const MessagePublisher &_publisher)
         : shared(NodeShared::Instance()),
-          publisher(_publisher)
+          publisher(_publisher),
+          topicId(InternTable::Topic(_publisher.Topic())),
+          typeId(InternTable::String(_publisher.MsgTypeName()))
       {
       }
 
@@ -160,6 +178,142 @@ namespace gz
         return !this->publisher.Topic().empty();
       }
 
+      /// \brief Compress a serialized message for the remote subscribers if
+      /// the advertise options and the remote subscribers that accept
+      /// compressed messages allow it.
+      /// \param[in] _subscribers Subscribers of the topic.
+      /// \param[in] _data The serialized message.
+      /// \param[in] _size Size of _data (bytes).
+      /// \param[out] _compressedSize Size of the compressed message.
+      /// \return Buffer from the serialization buffer pool holding the
+      /// compressed message, or nullptr to send the message only
+      /// uncompressed.
+      public: char *Compress(
+        const NodeSharedPrivate::SubscriberSnapshot &_subscribers,
+        const char *_data, const std::size_t _size,
+        std::size_t &_compressedSize)
+      {
+        const AdvertiseMessageOptions &opts = this->publisher.Options();
+        const Compression_t codec = opts.Compression();
+        if (codec == Compression_t::NONE ||
+            _size < opts.CompressionThreshold() ||
+            !(_subscribers.remoteCodecs & codecMask(codec)))
+        {
+          return nullptr;
+        }
+
+        const std::size_t capacity = maxCompressedSize(codec, _size);
+        if (capacity == 0)
+          return nullptr;
+
+        BufferPool &pool = this->shared->SerializationBufferPool();
+        char *buffer = pool.Acquire(capacity);
+        _compressedSize = compress(codec, _data, _size, buffer, capacity);
+        if (_compressedSize == 0)
+        {
+          pool.Release(buffer);
+          return nullptr;
+        }
+        return buffer;
+      }
+
+      /// \brief Immutable snapshot of the subscribers of this publisher.
+      public: struct SubscribersSnapshot
+              {
+                /// \brief Subscriber set generation when the snapshot was
+                /// taken.
+                public: uint64_t generation = 0;
+
+                /// \brief Subscribers of the topic.
+                public: NodeSharedPrivate::SubscriberSnapshot info;
+              };
+
+      /// \brief Get the subscribers of this publisher. The cached snapshot
+      /// is reused while the subscriber set does not change, so the common
+      /// case does not take the NodeShared mutex.
+      /// \param[in] _msgType Type of the published messages. Only the
+      /// advertised type is cached.
+      /// \return The snapshot of the subscribers.
+      public: std::shared_ptr<const SubscribersSnapshot> Subscribers(
+        const std::string &_msgType)
+      {
+        if (_msgType != this->publisher.MsgTypeName())
+        {
+          auto uncached = std::make_shared<SubscribersSnapshot>();
+          uncached->info = this->shared->dataPtr->CheckSubscriberSnapshot(
+            *this->shared, *this->topicId, _msgType);
+          return uncached;
+        }
+
+        auto snapshot = std::atomic_load(&this->subscribers);
+        if (snapshot && snapshot->generation ==
+            this->shared->dataPtr->subscribersGeneration.load(
+              std::memory_order_acquire))
+        {
+          return snapshot;
+        }
+
+        auto newSnapshot = std::make_shared<SubscribersSnapshot>();
+        {
+          std::lock_guard<std::recursive_mutex> lk(this->shared->mutex);
+          newSnapshot->generation =
+            this->shared->dataPtr->subscribersGeneration.load();
+          newSnapshot->info = this->shared->dataPtr->CheckSubscriberSnapshot(
+            *this->shared, *this->topicId, this->publisher.MsgTypeName());
+        }
+
+        snapshot = newSnapshot;
+        std::atomic_store(&this->subscribers, snapshot);
+        return snapshot;
+      }
+
+      /// \brief Run a callback inline, marking its subscription as active
+      /// on this thread while it runs.
+      /// \param[in] _handler The subscription.
+      /// \param[in] _info Information about the message.
+      /// \param[in] _cb Function that runs the callback.
+      public: static void RunInline(const SubscriptionHandlerBase &_handler,
+        const MessageInfo &_info, const std::function<void()> &_cb)
+      {
+        auto &active = NodeSharedPrivate::activeHandlers;
+        active.push_back(&_handler);
+        try
+        {
+          _cb();
+        }
+        catch (...)
+        {
+          std::cerr << "Exception occurred in an inline callback on topic ["
+                    << _info.Topic() << "]" << std::endl;
+        }
+        active.pop_back();
+      }
+
+      /// \brief Publish one or more messages. The subscribers are looked
+      /// up once for all of them.
+      /// \param[in] _msgs Array of _count messages.
+      /// \param[in] _sharedMsgs Array of _count shared pointers to the same
+      /// messages if they can be shared with the local subscribers without
+      /// copying them, or nullptr otherwise.
+      /// \param[in] _count Number of messages.
+      /// \return true when success.
+      public: bool Publish(const ProtoMsg *const *_msgs,
+                           const std::shared_ptr<const ProtoMsg> *_sharedMsgs,
+                           std::size_t _count);
+
+      /// \brief Publish a raw pre-serialized message.
+      /// \param[in] _data The serialized message.
+      /// \param[in] _size Size of _data (bytes).
+      /// \param[in] _ffn Function that releases _data if the buffer is
+      /// owned by the publisher, or nullptr if _data is borrowed and has to
+      /// be copied before sending it to the remote subscribers.
+      /// \param[in] _hint Opaque pointer passed to _ffn.
+      /// \param[in] _msgType Message type name.
+      /// \return true when success.
+      public: bool PublishRaw(const char *_data, const std::size_t _size,
+                              DeallocFunc *_ffn, void *_hint,
+                              const std::string &_msgType);
+
       /// \brief Destructor.
       public: virtual ~PublisherPrivate()
       {
@@ -179,10 +333,10 @@ namespace gz
         MessageInfo info;
 
         // Set the topic and the partition at the same time
-        info.SetTopicAndPartition(this->publisher.Topic());
+        info.SetTopicAndPartition(*this->topicId);
 
         // Set the message type name
-        info.SetType(this->publisher.MsgTypeName());
+        info.SetTypeId(this->typeId);
 
         return info;
       }
@@ -194,6 +348,13 @@ namespace gz
       /// \brief The message publisher.
       public: MessagePublisher publisher;
 
+      /// \brief Interned topic of the publisher. The local subscribers get
+      /// the decomposed topic name from here.
+      public: const InternedTopic *topicId = nullptr;
+
+      /// \brief Interned message type of the publisher.
+      public: const std::string *typeId = nullptr;
+
       /// \brief Timestamp of the last callback executed.
       public: Timestamp lastCbTimestamp;
 
@@ -203,6 +364,10 @@ namespace gz
 
       /// \brief Mutex to protect the node::publisher from race conditions.
       public: mutable std::mutex mutex;
+
+      /// \brief Cached subscribers. Access it only with std::atomic_load()
+      /// and std::atomic_store().
+      public: std::shared_ptr<const SubscribersSnapshot> subscribers;
     };
     }
   }
@@ -268,172 +433,445 @@ bool Node::Publisher::HasConnections() const
 }
 
 //////////////////////////////////////////////////
-bool Node::Publisher::Publish(const ProtoMsg &_msg)
+bool Node::PublisherPrivate::Publish(const ProtoMsg *const *_msgs,
+    const std::shared_ptr<const ProtoMsg> *_sharedMsgs,
+    const std::size_t _count)
 {
   if (!this->Valid())
     return false;
 
-  const std::string &publisherMsgType = this->dataPtr->publisher.MsgTypeName();
+  const std::string &publisherMsgType = this->publisher.MsgTypeName();
+  const std::string *publisherTypeId = this->typeId;
 
-  // Check that the msg type matches the topic type previously advertised.
-  if (publisherMsgType != _msg.GetTypeName())
+  // Check that the msg types match the topic type previously advertised.
+  // The descriptor name is compared to avoid building a string per message.
+  for (std::size_t i = 0; i < _count; ++i)
   {
-    std::cerr << "Node::Publisher::Publish() Type mismatch.\n"
-              << "\t* Type advertised: "
-              << this->dataPtr->publisher.MsgTypeName()
-              << "\n\t* Type published: " << _msg.GetTypeName() << std::endl;
-    return false;
+    if (publisherMsgType != _msgs[i]->GetDescriptor()->full_name())
+    {
+      std::cerr << "Node::Publisher::Publish() Type mismatch.\n"
+                << "\t* Type advertised: "
+                << this->publisher.MsgTypeName()
+                << "\n\t* Type published: " << _msgs[i]->GetTypeName()
+                << std::endl;
+      return false;
+    }
   }
 
   // Check the publication throttling option.
   if (!this->UpdateThrottling())
     return true;
 
-  const std::string &publisherTopic = this->dataPtr->publisher.Topic();
+  const std::string &publisherTopic = this->publisher.Topic();
 
-  const NodeShared::SubscriberInfo &subscribers =
-      this->dataPtr->shared->CheckSubscriberInfo(
-        publisherTopic, publisherMsgType);
+  const auto snapshot = this->Subscribers(publisherMsgType);
+  const NodeSharedPrivate::SubscriberSnapshot &subscribers =
+    snapshot->info;
 
-  // The serialized message size and buffer.
-#if GOOGLE_PROTOBUF_VERSION >= 3004000
-  const std::size_t msgSize = static_cast<std::size_t>(_msg.ByteSizeLong());
-#else
-  const std::size_t msgSize = static_cast<std::size_t>(_msg.ByteSize());
-#endif
-  char *msgBuffer = nullptr;
+  // The serialized messages. The serialized data is shared by the raw
+  // handlers and the ZMQ frames sent to the remote subscribers, and goes
+  // back to the pool when the last of them is done with it.
+  std::vector<NodeSharedPrivate::SharedPayload> payloads;
+  std::vector<std::size_t> msgSizes;
 
-  // Only serialize the message if we have a raw subscriber or a remote
+  // Only serialize the messages if we have a raw subscriber or a remote
   // subscriber.
   if (subscribers.haveRaw || subscribers.haveRemote)
   {
-    // Allocate the buffer to store the serialized data.
-    msgBuffer = static_cast<char *>(new char[msgSize]);
-
-    // Fail out early if we are unable to serialize the message. We do not
-    // want to send a corrupt/bad message to some subscribers and not others.
-    if (!_msg.SerializeToArray(msgBuffer, msgSize))
+    payloads.reserve(_count);
+    msgSizes.reserve(_count);
+    for (std::size_t i = 0; i < _count; ++i)
     {
-      delete[] msgBuffer;
-      std::cerr << "Node::Publisher::Publish(): Error serializing data"
-                << std::endl;
-      return false;
+#if GOOGLE_PROTOBUF_VERSION >= 3004000
+      const std::size_t msgSize =
+        static_cast<std::size_t>(_msgs[i]->ByteSizeLong());
+#else
+      const std::size_t msgSize =
+        static_cast<std::size_t>(_msgs[i]->ByteSize());
+#endif
+      payloads.push_back(this->shared->dataPtr->MakeSharedPayload(msgSize));
+      msgSizes.push_back(msgSize);
+
+      // Fail out early if we are unable to serialize a message. We do not
+      // want to send a corrupt/bad message to some subscribers and not
+      // others.
+      if (!_msgs[i]->SerializeToArray(payloads.back().get(), msgSize))
+      {
+        std::cerr << "Node::Publisher::Publish(): Error serializing data"
+                  << std::endl;
+        return false;
+      }
     }
   }
 
   // Local and raw subscribers.
   if (subscribers.haveLocal || subscribers.haveRaw)
   {
-    std::unique_ptr<NodeSharedPrivate::PublishMsgDetails> pubMsgDetails(
-      new NodeSharedPrivate::PublishMsgDetails);
+    NodeSharedPrivate::PublishMsgDetails pubMsgDetails;
 
     // Create and populate the message information object.
     // This must be a shared pointer so that we can pass it to
     // multiple threads below, and then allow this function to go
     // out of scope.
-    pubMsgDetails->info.SetTopicAndPartition(this->dataPtr->publisher.Topic());
-    pubMsgDetails->info.SetType(this->dataPtr->publisher.MsgTypeName());
-    pubMsgDetails->info.SetIntraProcess(true);
+    pubMsgDetails.info.SetTopicAndPartition(*this->topicId);
+    pubMsgDetails.info.SetTypeId(this->typeId);
+    pubMsgDetails.info.SetIntraProcess(true);
 
-    pubMsgDetails->msgCopy.reset(_msg.New());
-    pubMsgDetails->msgCopy->CopyFrom(_msg);
+    // Subscriptions running their callbacks on this thread.
+    std::vector<ISubscriptionHandlerPtr> inlineHandlers;
+    std::vector<RawSubscriptionHandlerPtr> inlineRawHandlers;
 
     if (subscribers.haveLocal)
     {
-      for (const auto &node : subscribers.localHandlers)
+      for (const ISubscriptionHandlerPtr &handler :
+           *subscribers.localHandlers)
       {
-        for (const auto &handler : node.second)
+        if (!handler)
+        {
+          std::cerr << "Node::Publisher::Publish(): "
+                    << "NULL local subscription handler" << std::endl;
+          continue;
+        }
+
+        if (!handler->AcceptsType(publisherTypeId))
         {
-          if (!handler.second)
-          {
-            std::cerr << "Node::Publisher::Publish(): "
-                      << "NULL local subscription handler" << std::endl;
-            continue;
-          }
-
-          if (handler.second->TypeName() != kGenericMessageType &&
-              handler.second->TypeName() != _msg.GetTypeName())
-          {
-            continue;
-          }
-
-          pubMsgDetails->localHandlers.push_back(handler.second);
+          continue;
         }
+
+        if (NodeSharedPrivate::RunsInline(*handler))
+          inlineHandlers.push_back(handler);
+        else
+          pubMsgDetails.localHandlers.push_back(handler);
       }
     }
 
     if (subscribers.haveRaw)
     {
-      for (auto &node : subscribers.rawHandlers)
+      for (const RawSubscriptionHandlerPtr &rawHandler :
+           *subscribers.rawHandlers)
       {
-        for (auto &handler : node.second)
+        if (!rawHandler)
+        {
+          std::cerr << "Node::Publisher::Publish(): "
+                    << "NULL raw subscription handler" << std::endl;
+          continue;
+        }
+
+        if (!rawHandler->AcceptsType(publisherTypeId))
         {
-          const RawSubscriptionHandlerPtr &rawHandler = handler.second;
-
-          if (!rawHandler)
-          {
-            std::cerr << "Node::Publisher::Publish(): "
-                      << "NULL raw subscription handler" << std::endl;
-            continue;
-          }
-
-          if (rawHandler->TypeName() != kGenericMessageType &&
-              rawHandler->TypeName() != _msg.GetTypeName())
-          {
-            continue;
-          }
-
-          if (!pubMsgDetails->sharedBuffer)
-          {
-            pubMsgDetails->msgSize = msgSize;
-            // If the sharedBuffer has not been created, do so now.
-            pubMsgDetails->sharedBuffer.reset(new char[msgSize]);
-            memcpy(pubMsgDetails->sharedBuffer.get(), msgBuffer, msgSize);
-          }
-          pubMsgDetails->rawHandlers.push_back(rawHandler);
+          continue;
         }
+
+        if (NodeSharedPrivate::RunsInline(*rawHandler))
+          inlineRawHandlers.push_back(rawHandler);
+        else
+          pubMsgDetails.rawHandlers.push_back(rawHandler);
       }
     }
 
-    // Add the publish message details to the publish queue. The message
+    // Keep the information for the inline callbacks.
+    const MessageInfo info = pubMsgDetails.info;
+
+    const bool queued = !pubMsgDetails.localHandlers.empty() ||
+      !pubMsgDetails.rawHandlers.empty();
+
+    if (queued)
+      pubMsgDetails.samples.resize(_count);
+    for (std::size_t i = 0; queued && i < _count; ++i)
+    {
+      auto &sample = pubMsgDetails.samples[i];
+
+      // Local subscribers share the caller's message when it is available.
+      // Otherwise they get a copy, because the message may change or go
+      // away before the callbacks are executed.
+      if (!pubMsgDetails.localHandlers.empty())
+      {
+        if (_sharedMsgs)
+        {
+          sample.msgCopy = _sharedMsgs[i];
+        }
+        else
+        {
+          std::shared_ptr<ProtoMsg> msgCopy(_msgs[i]->New());
+          msgCopy->CopyFrom(*_msgs[i]);
+          sample.msgCopy = std::move(msgCopy);
+        }
+      }
+
+      if (!pubMsgDetails.rawHandlers.empty())
+      {
+        sample.msgSize = msgSizes[i];
+        sample.sharedBuffer = payloads[i];
+      }
+    }
+
+    // Add the publish message details to the publish queue. The messages
     // will be published asynchronously to the local and raw callbacks.
+    if (queued)
     {
-      std::unique_lock<std::mutex> queueLock(
-          this->dataPtr->shared->dataPtr->pubThreadMutex);
-      this->dataPtr->shared->dataPtr->pubQueue.push(std::move(pubMsgDetails));
+      pubMsgDetails.topic = publisherTopic;
+      this->shared->dataPtr->EnqueuePublication(std::move(pubMsgDetails),
+        this->publisher.Options());
     }
 
-    this->dataPtr->shared->dataPtr->signalNewPub.notify_one();
+    // The inline callbacks run before this function returns, so they use
+    // the caller's message without copying it.
+    for (std::size_t i = 0; i < _count; ++i)
+    {
+      for (const auto &handler : inlineRawHandlers)
+      {
+        RunInline(*handler, info, [&]()
+        {
+          handler->RunRawCallback(payloads[i].get(), msgSizes[i], info);
+        });
+      }
+
+      for (const auto &handler : inlineHandlers)
+      {
+        RunInline(*handler, info, [&]()
+        {
+          if (_sharedMsgs)
+            handler->RunLocalCallback(_sharedMsgs[i], info);
+          else
+            handler->RunLocalCallback(*_msgs[i], info);
+        });
+      }
+    }
   }
 
   // Handle remote subscribers.
   if (subscribers.haveRemote)
   {
-    // Zmq will call this lambda when the message is published.
-    // We use it to deallocate the buffer.
-    auto myDeallocator = [](void *_buffer, void *)
+    // Zmq holds a reference to each payload until the message is published.
+    // Compressed copies use their own buffer, they are only sent to the
+    // subscribers that decode them.
+    std::vector<NodeShared::PublishData> batch(_count);
+    bool compressed = false;
+    for (std::size_t i = 0; i < _count; ++i)
     {
-      delete[] reinterpret_cast<char*>(_buffer);
-    };
+      batch[i].compressed = this->Compress(subscribers, payloads[i].get(),
+        msgSizes[i], batch[i].compressedSize);
+      compressed = compressed || batch[i].compressed;
+
+      batch[i].data = payloads[i].get();
+      batch[i].size = msgSizes[i];
+      batch[i].ffn = &NodeSharedPrivate::ReleaseSharedPayload;
+      batch[i].hint = new NodeSharedPrivate::SharedPayload(
+        std::move(payloads[i]));
+    }
 
-    if (!this->dataPtr->shared->Publish(this->dataPtr->publisher.Topic(),
-          msgBuffer, msgSize, myDeallocator, _msg.GetTypeName()))
+    if (_count == 1 && !compressed)
     {
+      return this->shared->Publish(publisherTopic, batch[0].data,
+        batch[0].size, batch[0].ffn, batch[0].hint, publisherMsgType,
+        this->publisher.Options().Priority());
+    }
+
+    return this->shared->PublishBatch(publisherTopic, batch,
+      publisherMsgType, this->publisher.Options().Priority());
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Node::Publisher::Publish(const ProtoMsg &_msg)
+{
+  const ProtoMsg *msg = &_msg;
+  return this->dataPtr->Publish(&msg, nullptr, 1u);
+}
+
+//////////////////////////////////////////////////
+bool Node::Publisher::Publish(std::shared_ptr<const ProtoMsg> _msg)
+{
+  if (!_msg)
+  {
+    std::cerr << "Node::Publisher::Publish(): NULL message" << std::endl;
+    return false;
+  }
+
+  const ProtoMsg *msg = _msg.get();
+  return this->dataPtr->Publish(&msg, &_msg, 1u);
+}
+
+//////////////////////////////////////////////////
+bool Node::Publisher::PublishBatch(const std::vector<const ProtoMsg *> &_msgs)
+{
+  for (const ProtoMsg *msg : _msgs)
+  {
+    if (!msg)
+    {
+      std::cerr << "Node::Publisher::PublishBatch(): NULL message"
+                << std::endl;
       return false;
     }
   }
+
+  if (_msgs.empty())
+    return this->Valid();
+
+  return this->dataPtr->Publish(_msgs.data(), nullptr, _msgs.size());
+}
+
+//////////////////////////////////////////////////
+bool Node::Publisher::PublishBatch(
+    const std::vector<std::shared_ptr<const ProtoMsg>> &_msgs)
+{
+  std::vector<const ProtoMsg *> msgs;
+  msgs.reserve(_msgs.size());
+  for (const auto &msg : _msgs)
+  {
+    if (!msg)
+    {
+      std::cerr << "Node::Publisher::PublishBatch(): NULL message"
+                << std::endl;
+      return false;
+    }
+    msgs.push_back(msg.get());
+  }
+
+  if (msgs.empty())
+    return this->Valid();
+
+  return this->dataPtr->Publish(msgs.data(), _msgs.data(), msgs.size());
+}
+
+//////////////////////////////////////////////////
+bool Node::PublisherPrivate::PublishRaw(const char *_data,
+    const std::size_t _size, DeallocFunc *_ffn, void *_hint,
+    const std::string &_msgType)
+{
+  // An owned buffer returns to its creator on every path that does not hand
+  // it over to ZeroMQ, including exceptions.
+  NodeSharedPrivate::OwnedBuffer owned(const_cast<char *>(_data), _ffn,
+    _hint);
+
+  if (!this->Valid())
+    return false;
+
+  const std::string &publisherMsgType = this->publisher.MsgTypeName();
+
+  if (publisherMsgType  != _msgType && publisherMsgType != kGenericMessageType)
+  {
+    std::cerr << "Node::Publisher::PublishRaw() type mismatch.\n"
+              << "\t* Type advertised: "
+              << this->publisher.MsgTypeName()
+              << "\n\t* Type published: " << _msgType << std::endl;
+    return false;
+  }
+
+  if (!this->UpdateThrottling())
+    return true;
+
+  const std::string &topic = this->publisher.Topic();
+
+  const auto snapshot = this->Subscribers(_msgType);
+  const NodeSharedPrivate::SubscriberSnapshot &subscribers =
+    snapshot->info;
+
+  // The advertised names are interned. A generic publisher might publish
+  // other types.
+  MessageInfo info;
+  info.SetTopicAndPartition(*this->topicId);
+  if (_msgType == publisherMsgType)
+    info.SetTypeId(this->typeId);
   else
+    info.SetType(_msgType);
+  info.SetIntraProcess(true);
+
+  // Trigger local subscribers.
+  this->shared->dataPtr->TriggerCallbacks(info, _data, _size, subscribers,
+    nullptr);
+
+  if (!subscribers.haveRemote)
+    return true;
+
+  // Remote subscribers. Note that the data is already presumed to be
+  // serialized, so we just pass it along for publication.
+  BufferPool &pool = this->shared->SerializationBufferPool();
+  const Priority_t priority = this->publisher.Options().Priority();
+
+  // An owned buffer goes to ZeroMQ as is (zero copy). A borrowed buffer has
+  // to outlive the call, so it is copied.
+  NodeShared::PublishData item;
+  item.size = _size;
+  item.compressed = this->Compress(subscribers, _data, _size,
+    item.compressedSize);
+  if (owned.Owned())
   {
-    delete[] msgBuffer;
+    item.data = owned.Release();
+    item.ffn = _ffn;
+    item.hint = _hint;
+  }
+  else
+  {
+    item.data = pool.Acquire(_size);
+    item.ffn = &BufferPool::Deallocate;
+    item.hint = &pool;
+    memcpy(item.data, _data, _size);
   }
 
-  return true;
+  if (item.compressed)
+    return this->shared->PublishBatch(topic, {item}, _msgType, priority);
+
+  return this->shared->Publish(topic, item.data, item.size, item.ffn,
+    item.hint, _msgType, priority);
 }
 
 //////////////////////////////////////////////////
 bool Node::Publisher::PublishRaw(
     const std::string &_msgData,
     const std::string &_msgType)
+{
+  return this->dataPtr->PublishRaw(_msgData.data(), _msgData.size(),
+    nullptr, nullptr, _msgType);
+}
+
+//////////////////////////////////////////////////
+bool Node::Publisher::PublishRaw(
+    const void *_data,
+    const std::size_t _size,
+    const std::string &_msgType)
+{
+  if (!_data && _size > 0)
+  {
+    std::cerr << "Node::Publisher::PublishRaw(): NULL data" << std::endl;
+    return false;
+  }
+
+  return this->dataPtr->PublishRaw(static_cast<const char *>(_data), _size,
+    nullptr, nullptr, _msgType);
+}
+
+//////////////////////////////////////////////////
+bool Node::Publisher::PublishRaw(
+    char *_data,
+    const std::size_t _size,
+    DeallocFunc *_ffn,
+    void *_hint,
+    const std::string &_msgType)
+{
+  if (!_ffn)
+  {
+    std::cerr << "Node::Publisher::PublishRaw(): NULL deallocation function"
+              << std::endl;
+    return false;
+  }
+
+  if (!_data && _size > 0)
+  {
+    std::cerr << "Node::Publisher::PublishRaw(): NULL data" << std::endl;
+    _ffn(_data, _hint);
+    return false;
+  }
+
+  return this->dataPtr->PublishRaw(_data, _size, _ffn, _hint, _msgType);
+}
+
+//////////////////////////////////////////////////
+bool Node::Publisher::PublishRawBatch(
+    const std::vector<std::string> &_msgData,
+    const std::string &_msgType)
 {
   if (!this->dataPtr->Valid())
     return false;
@@ -442,48 +880,62 @@ bool Node::Publisher::PublishRaw(
 
   if (publisherMsgType  != _msgType && publisherMsgType != kGenericMessageType)
   {
-    std::cerr << "Node::Publisher::PublishRaw() type mismatch.\n"
+    std::cerr << "Node::Publisher::PublishRawBatch() type mismatch.\n"
               << "\t* Type advertised: "
               << this->dataPtr->publisher.MsgTypeName()
               << "\n\t* Type published: " << _msgType << std::endl;
     return false;
   }
 
+  if (_msgData.empty())
+    return true;
+
   if (!this->dataPtr->UpdateThrottling())
     return true;
 
   const std::string &topic = this->dataPtr->publisher.Topic();
 
-  const NodeShared::SubscriberInfo &subscribers =
-      this->dataPtr->shared->CheckSubscriberInfo(topic, _msgType);
+  const auto snapshot = this->dataPtr->Subscribers(_msgType);
+  const NodeSharedPrivate::SubscriberSnapshot &subscribers =
+    snapshot->info;
 
+  // The advertised names are interned. A generic publisher might publish
+  // other types.
   MessageInfo info;
-  info.SetTopicAndPartition(topic);
-  info.SetType(_msgType);
+  info.SetTopicAndPartition(*this->dataPtr->topicId);
+  if (_msgType == publisherMsgType)
+    info.SetTypeId(this->dataPtr->typeId);
+  else
+    info.SetType(_msgType);
   info.SetIntraProcess(true);
 
   // Trigger local subscribers.
-  this->dataPtr->shared->TriggerCallbacks(info, _msgData, subscribers);
+  for (const std::string &msgData : _msgData)
+  {
+    this->dataPtr->shared->dataPtr->TriggerCallbacks(info, msgData.data(),
+      msgData.size(), subscribers, nullptr);
+  }
 
-  // Remote subscribers. Note that the data is already presumed to be
-  // serialized, so we just pass it along for publication.
+  // Remote subscribers. All the messages are sent under a single lock.
   if (subscribers.haveRemote)
   {
-    const std::size_t msgSize = _msgData.size();
-    char *msgBuffer = static_cast<char *>(new char[msgSize]);
-    memcpy(msgBuffer, _msgData.c_str(), msgSize);
-    auto myDeallocator = [](void *_buffer, void * /*_hint*/)
+    BufferPool &pool = this->dataPtr->shared->SerializationBufferPool();
+    std::vector<NodeShared::PublishData> batch(_msgData.size());
+    for (std::size_t i = 0; i < _msgData.size(); ++i)
     {
-      delete[] reinterpret_cast<char*>(_buffer);
-    };
+      batch[i].compressed = this->dataPtr->Compress(subscribers,
+        _msgData[i].c_str(), _msgData[i].size(), batch[i].compressedSize);
+
+      batch[i].ffn = &BufferPool::Deallocate;
+      batch[i].hint = &pool;
+      batch[i].size = _msgData[i].size();
+      batch[i].data = pool.Acquire(batch[i].size);
+      memcpy(batch[i].data, _msgData[i].c_str(), batch[i].size);
+    }
 
-    // Note: This will copy _msgData (i.e. not zero copy)
-    if (!this->dataPtr->shared->Publish(
-          this->dataPtr->publisher.Topic(),
-          msgBuffer, msgSize, myDeallocator, _msgType))
-    {
+    if (!this->dataPtr->shared->PublishBatch(topic, batch, _msgType,
+          this->dataPtr->publisher.Options().Priority()))
       return false;
-    }
   }
 
   return true;
@@ -603,45 +1055,42 @@ bool Node::Unsubscribe(const std::string &_topic)
 
   std::lock_guard<std::recursive_mutex> lk(this->dataPtr->shared->mutex);
 
+  // Unsubscribe from a pattern and from the topics matching it.
+  if (this->dataPtr->UnsubscribePatternHelper(fullyQualifiedTopic))
+    return true;
+
   // Remove the subscribers for the given topic that belong to this node.
   this->dataPtr->shared->localSubscribers.RemoveHandlersForNode(
         fullyQualifiedTopic, this->dataPtr->nUuid);
 
-  // Remove the topic from the list of subscribed topics in this node.
-  this->dataPtr->topicsSubscribed.erase(fullyQualifiedTopic);
-
-  // Remove the filter for this topic if I am the last subscriber.
-  if (!this->dataPtr->shared->localSubscribers
-      .HasSubscriber(fullyQualifiedTopic))
+  // Keep the handlers of the patterns of this node matching the topic.
+  std::vector<std::shared_ptr<NodeSharedPrivate::PatternSubscription>> subs;
+  this->dataPtr->shared->dataPtr->topicPatterns.Match(
+    fullyQualifiedTopic, subs);
+  for (const auto &sub : subs)
   {
-#ifdef GZ_CPPZMQ_POST_4_7_0
-    this->dataPtr->shared->dataPtr->subscriber->set(
-      zmq::sockopt::unsubscribe, fullyQualifiedTopic);
-#else
-    this->dataPtr->shared->dataPtr->subscriber->setsockopt(
-      ZMQ_UNSUBSCRIBE, fullyQualifiedTopic.data(), fullyQualifiedTopic.size());
-#endif
-  }
+    if (sub->nUuid != this->dataPtr->nUuid ||
+        sub->topics.count(fullyQualifiedTopic) == 0)
+    {
+      continue;
+    }
 
-  // Notify to the publishers that I am no longer interested in the topic.
-  MsgAddresses_M addresses;
-  if (!this->dataPtr->shared->dataPtr->msgDiscovery->Publishers(
-        fullyQualifiedTopic, addresses))
-  {
-    return false;
+    if (sub->handler)
+    {
+      this->dataPtr->shared->localSubscribers.normal.AddHandler(
+        fullyQualifiedTopic, sub->nUuid, sub->handler);
+    }
+    else
+    {
+      this->dataPtr->shared->localSubscribers.raw.AddHandler(
+        fullyQualifiedTopic, sub->nUuid, sub->rawHandler);
+    }
   }
 
-  for (auto &proc : addresses)
-  {
-    std::string dstPUuid = proc.first;
-    MessagePublisher pub(fullyQualifiedTopic, this->dataPtr->shared->myAddress,
-      dstPUuid, this->dataPtr->shared->pUuid, this->dataPtr->nUuid,
-      kGenericMessageType, AdvertiseMessageOptions());
-
-    this->Shared()->dataPtr->msgDiscovery->Unregister(pub);
-  }
+  // Remove the topic from the list of subscribed topics in this node.
+  this->dataPtr->topicsSubscribed.erase(fullyQualifiedTopic);
 
-  return true;
+  return this->dataPtr->UnsubscribeHelper(fullyQualifiedTopic);
 }
 
 //////////////////////////////////////////////////
@@ -771,12 +1220,19 @@ bool Node::SubscribeRaw(
 
   const std::shared_ptr<RawSubscriptionHandler> handlerPtr =
       std::make_shared<RawSubscriptionHandler>(
-        this->dataPtr->nUuid, _msgType, _opts);
+        this->dataPtr->nUuid, _msgType, this->SubscriptionOptions(_opts));
 
   handlerPtr->SetCallback(_callback);
 
   std::lock_guard<std::recursive_mutex> lk(this->dataPtr->shared->mutex);
 
+  // A pattern subscribes the handler to every matching topic.
+  if (_opts.TopicPattern())
+  {
+    return this->dataPtr->SubscribePatternHelper(
+      fullyQualifiedTopic, nullptr, handlerPtr);
+  }
+
   this->dataPtr->shared->localSubscribers.raw.AddHandler(
         fullyQualifiedTopic, this->dataPtr->nUuid, handlerPtr);
 
@@ -807,6 +1263,22 @@ std::optional<TopicStatistics> Node::TopicStats(
   return this->dataPtr->shared->TopicStats(fullyQualifiedTopic);
 }
 
+//////////////////////////////////////////////////
+uint64_t Node::DroppedMessages(const std::string &_topic) const
+{
+  std::string fullyQualifiedTopic;
+  std::string topic = _topic;
+  this->Options().TopicRemap(_topic, topic);
+
+  if (!TopicUtils::FullyQualifiedName(this->Options().Partition(),
+    this->Options().NameSpace(), topic, fullyQualifiedTopic))
+  {
+    return 0;
+  }
+
+  return this->dataPtr->shared->DroppedMessages(fullyQualifiedTopic);
+}
+
 //////////////////////////////////////////////////
 bool Node::EnableStats(const std::string &_topic, bool _enable,
     const std::string &_publicationTopic, uint64_t _publicationRate)
@@ -985,15 +1457,39 @@ Node::Publisher Node::Advertise(const std::string &_topic,
     return Publisher();
   }
 
+  if (_options.Compression() != Compression_t::NONE &&
+      !(supportedCodecs() & codecMask(_options.Compression())))
+  {
+    std::cerr << "The compression codec requested for topic [" << topic
+              << "] is not available. Messages will be sent uncompressed."
+              << std::endl;
+  }
+
   std::lock_guard<std::recursive_mutex> lk(this->Shared()->mutex);
 
+  // The priority lanes publish from their own socket.
+  auto *lane = this->Shared()->dataPtr->Lane(_options.Priority(),
+    this->Shared()->hostAddr);
+
   // Notify the discovery service to register and advertise my topic.
   MessagePublisher publisher(fullyQualifiedTopic,
-      this->Shared()->myAddress,
+      lane ? lane->address : this->Shared()->myAddress,
       // this->Shared()->myControlAddress,
       "unused",
       this->Shared()->pUuid, this->NodeUuid(), _msgTypeName, _options);
 
+  // Offer the compact header to the subscribers.
+  if (this->Shared()->dataPtr->compactHeaderEnabled)
+  {
+    publisher.SetTopicId(
+      CompactHeader::TopicId(fullyQualifiedTopic, _msgTypeName));
+  }
+
+  // Offer the codec route to the subscribers that decode compressed
+  // messages, even if this topic is not compressed. The other publishers of
+  // the process share the socket and might compress.
+  publisher.SetCodecs(supportedCodecs());
+
   if (!this->Shared()->dataPtr->msgDiscovery->Advertise(publisher))
   {
     std::cerr << "Node::Advertise(): Error advertising topic ["
@@ -1003,12 +1499,18 @@ Node::Publisher Node::Advertise(const std::string &_topic,
     return Publisher();
   }
 
+  // The local subscribers to a matching pattern receive the topic too.
+  this->Shared()->MatchTopicPatterns(fullyQualifiedTopic, _msgTypeName);
+
   return Publisher(publisher);
 }
 
 //////////////////////////////////////////////////
 bool NodePrivate::SubscribeHelper(const std::string &_fullyQualifiedTopic)
 {
+  // A new local handler has just been stored by the caller.
+  this->shared->dataPtr->SubscribersChanged();
+
   // Add the topic to the list of subscribed topics (if it was not before).
   this->topicsSubscribed.insert(_fullyQualifiedTopic);
 
@@ -1030,3 +1532,149 @@ bool Node::SubscribeHelper(const std::string &_fullyQualifiedTopic)
 {
   return this->dataPtr->SubscribeHelper(_fullyQualifiedTopic);
 }
+
+//////////////////////////////////////////////////
+bool NodePrivate::SubscribePatternHelper(
+  const std::string &_fullyQualifiedPattern,
+  const ISubscriptionHandlerPtr &_handler,
+  const RawSubscriptionHandlerPtr &_rawHandler)
+{
+  auto sub = std::make_shared<NodeSharedPrivate::PatternSubscription>();
+  sub->nUuid = this->nUuid;
+  sub->handler = _handler;
+  sub->rawHandler = _rawHandler;
+  this->shared->dataPtr->topicPatterns.Insert(_fullyQualifiedPattern, sub);
+
+  // The pattern is listed and unsubscribed like a topic.
+  this->topicsSubscribed.insert(_fullyQualifiedPattern);
+
+  // Subscribe to the known topics that match the pattern. The new ones are
+  // matched when they are discovered or advertised.
+  auto &discovery = this->shared->dataPtr->msgDiscovery;
+  std::vector<std::string> topics;
+  discovery->TopicList(topics);
+  for (const auto &topic : topics)
+  {
+    MsgAddresses_M addresses;
+    if (!discovery->Publishers(topic, addresses))
+      continue;
+
+    bool matched = false;
+    for (const auto &proc : addresses)
+    {
+      for (const auto &pub : proc.second)
+        matched |= this->shared->MatchTopicPatterns(topic, pub.MsgTypeName());
+    }
+
+    // Connect to the publishers of the topic.
+    if (matched && !discovery->Discover(topic))
+    {
+      std::cerr << "Node::Subscribe(): Error discovering topic ["
+                << topic
+                << "]. Did you forget to start the discovery service?"
+                << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool Node::SubscribePatternHelper(const std::string &_fullyQualifiedPattern,
+  const ISubscriptionHandlerPtr &_handler)
+{
+  return this->dataPtr->SubscribePatternHelper(
+    _fullyQualifiedPattern, _handler, nullptr);
+}
+
+//////////////////////////////////////////////////
+bool NodePrivate::UnsubscribeHelper(const std::string &_fullyQualifiedTopic)
+{
+  this->shared->dataPtr->SubscribersChanged();
+
+  // Remove the filter for this topic if I am the last subscriber.
+  if (!this->shared->localSubscribers.HasSubscriber(_fullyQualifiedTopic))
+    this->shared->dataPtr->RemoveTopicFilters(_fullyQualifiedTopic);
+
+  // The node is still subscribed to the topic with other handlers.
+  if (this->shared->localSubscribers.normal.HasHandlersForNode(
+        _fullyQualifiedTopic, this->nUuid) ||
+      this->shared->localSubscribers.raw.HasHandlersForNode(
+        _fullyQualifiedTopic, this->nUuid))
+  {
+    return true;
+  }
+
+  // Discard the messages still queued for this node.
+  this->shared->dataPtr->RemoveSubscriptionQueues(
+    _fullyQualifiedTopic, this->nUuid);
+
+  // Notify to the publishers that I am no longer interested in the topic.
+  MsgAddresses_M addresses;
+  if (!this->shared->dataPtr->msgDiscovery->Publishers(
+        _fullyQualifiedTopic, addresses))
+  {
+    return false;
+  }
+
+  for (auto &proc : addresses)
+  {
+    std::string dstPUuid = proc.first;
+    MessagePublisher pub(_fullyQualifiedTopic, this->shared->myAddress,
+      dstPUuid, this->shared->pUuid, this->nUuid,
+      kGenericMessageType, AdvertiseMessageOptions());
+
+    this->shared->dataPtr->msgDiscovery->Unregister(pub);
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool NodePrivate::UnsubscribePatternHelper(
+  const std::string &_fullyQualifiedPattern)
+{
+  auto removed = this->shared->dataPtr->topicPatterns.Remove(
+    _fullyQualifiedPattern,
+    [this](const std::shared_ptr<NodeSharedPrivate::PatternSubscription> &_s)
+    {
+      return _s->nUuid == this->nUuid;
+    });
+
+  if (removed.empty())
+    return false;
+
+  this->topicsSubscribed.erase(_fullyQualifiedPattern);
+
+  // Remove only the handlers of the pattern from the matching topics.
+  for (const auto &sub : removed)
+  {
+    for (const auto &topic : sub->topics)
+    {
+      if (sub->handler)
+      {
+        this->shared->localSubscribers.normal.RemoveHandler(
+          topic, this->nUuid, sub->handler->HandlerUuid());
+      }
+      else
+      {
+        this->shared->localSubscribers.raw.RemoveHandler(
+          topic, this->nUuid, sub->rawHandler->HandlerUuid());
+      }
+      this->UnsubscribeHelper(topic);
+    }
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+SubscribeOptions Node::SubscriptionOptions(
+    const SubscribeOptions &_opts) const
+{
+  SubscribeOptions opts(_opts);
+  if (this->Options().InlineDelivery())
+    opts.SetInlineDelivery(true);
+  return opts;
+}
@@ -64,6 +64,7 @@ NodeOptions &NodeOptions::operator=(const NodeOptions &_other)
   this->SetNameSpace(_other.NameSpace());
   this->SetPartition(_other.Partition());
   this->dataPtr->topicsRemap = _other.dataPtr->topicsRemap;
+  this->dataPtr->inlineDelivery = _other.dataPtr->inlineDelivery;
   return *this;
 }
 
@@ -143,3 +144,15 @@ bool NodeOptions::TopicRemap(const std::string &_fromTopic,
 
   return topicIt != this->dataPtr->topicsRemap.end();
 }
+
+//////////////////////////////////////////////////
+bool NodeOptions::InlineDelivery() const
+{
+  return this->dataPtr->inlineDelivery;
+}
+
+//////////////////////////////////////////////////
+void NodeOptions::SetInlineDelivery(const bool _inline)
+{
+  this->dataPtr->inlineDelivery = _inline;
+}
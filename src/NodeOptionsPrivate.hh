@@ -50,6 +50,10 @@ namespace gz
       /// \brief Table of remappings. The key is the original topic name and
       /// its value is the new topic name to be used instead.
       public: std::map<std::string, std::string> topicsRemap;
+
+      /// \brief Run the callbacks of the subscriptions on the publishing
+      /// thread.
+      public: bool inlineDelivery = false;
     };
     }
   }
@@ -72,4 +72,11 @@ TEST(NodeOptionsTest, accessors)
   EXPECT_EQ(opts.Partition(), defaultPartition);
   EXPECT_TRUE(opts.SetPartition(aPartition));
   EXPECT_EQ(opts.Partition(), aPartition);
+
+  // Inline delivery.
+  EXPECT_FALSE(opts.InlineDelivery());
+  opts.SetInlineDelivery(true);
+  EXPECT_TRUE(opts.InlineDelivery());
+  transport::NodeOptions opts2(opts);
+  EXPECT_TRUE(opts2.InlineDelivery());
 }
@@ -25,6 +25,7 @@
 #include "gz/transport/NodeOptions.hh"
 #include "gz/transport/Node.hh"
 #include "gz/transport/NodeShared.hh"
+#include "gz/transport/TransportTypes.hh"
 
 namespace gz
 {
@@ -50,6 +51,32 @@ namespace gz
       /// \sa TopicUtils::FullyQualifiedName
       public: bool SubscribeHelper(const std::string &_fullyQualifiedTopic);
 
+      /// \brief Helper function for Subscribe with a topic pattern. The
+      /// caller must hold the NodeShared mutex.
+      /// \param[in] _fullyQualifiedPattern Fully qualified topic pattern.
+      /// \param[in] _handler Handler of a typed subscription, or nullptr.
+      /// \param[in] _rawHandler Handler of a raw subscription, or nullptr.
+      /// \return True on success.
+      /// \sa TopicUtils::IsTopicPattern
+      public: bool SubscribePatternHelper(
+        const std::string &_fullyQualifiedPattern,
+        const ISubscriptionHandlerPtr &_handler,
+        const RawSubscriptionHandlerPtr &_rawHandler);
+
+      /// \brief Helper function for Unsubscribe, called after removing
+      /// handlers of this node from a topic. The caller must hold the
+      /// NodeShared mutex.
+      /// \param[in] _fullyQualifiedTopic Fully qualified topic name.
+      /// \return True on success.
+      public: bool UnsubscribeHelper(const std::string &_fullyQualifiedTopic);
+
+      /// \brief Helper function for Unsubscribe with a topic pattern. The
+      /// caller must hold the NodeShared mutex.
+      /// \param[in] _fullyQualifiedPattern Fully qualified topic pattern.
+      /// \return True if this node was subscribed to the pattern.
+      public: bool UnsubscribePatternHelper(
+        const std::string &_fullyQualifiedPattern);
+
       /// \brief The list of topics subscribed by this node.
       public: std::unordered_set<std::string> topicsSubscribed;
 
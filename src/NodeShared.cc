@@ -18,20 +18,26 @@
 
 #include <zmq.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <shared_mutex>  //NOLINT
 #include <string>
 #include <thread>
+#include <tuple>
 #include <vector>
 #include <unordered_map>
 
 #include "gz/transport/AdvertiseOptions.hh"
+#include "gz/transport/Compression.hh"
 #include "gz/transport/Discovery.hh"
 #include "gz/transport/Helpers.hh"
+#include "gz/transport/InternTable.hh"
 #include "gz/transport/NodeShared.hh"
 #include "gz/transport/RepHandler.hh"
 #include "gz/transport/ReqHandler.hh"
@@ -39,6 +45,7 @@
 #include "gz/transport/TransportTypes.hh"
 #include "gz/transport/Uuid.hh"
 
+#include "CallbackExecutor.hh"
 #include "NodeSharedPrivate.hh"
 
 using namespace std::chrono_literals;
@@ -130,6 +137,23 @@ int sendHelper(zmq::socket_t &_pub, const std::string &_data, int _type)
 #endif
 }
 
+//////////////////////////////////////////////////
+// Helper to send the frames of a multipart message
+void sendFramesHelper(zmq::socket_t &_socket,
+    const std::vector<std::string> &_frames)
+{
+  for (std::size_t i = 0; i < _frames.size(); ++i)
+  {
+    const bool last = i + 1 == _frames.size();
+#ifdef GZ_ZMQ_POST_4_3_1
+    sendHelper(_socket, _frames[i],
+      last ? zmq::send_flags::none : zmq::send_flags::sndmore);
+#else
+    sendHelper(_socket, _frames[i], last ? 0 : ZMQ_SNDMORE);
+#endif
+  }
+}
+
 //////////////////////////////////////////////////
 // Helper to receive messages
 std::string receiveHelper(zmq::socket_t &_socket)
@@ -146,6 +170,47 @@ std::string receiveHelper(zmq::socket_t &_socket)
   return std::string(reinterpret_cast<char *>(msg.data()), msg.size());
 }
 
+//////////////////////////////////////////////////
+// Helper to receive one frame of a message
+bool recvFrame(zmq::socket_t &_socket, zmq::message_t &_msg)
+{
+#ifdef GZ_ZMQ_POST_4_3_1
+  return static_cast<bool>(_socket.recv(_msg));
+#else
+  return _socket.recv(&_msg, 0);
+#endif
+}
+
+//////////////////////////////////////////////////
+// Helper to write a 64-bit integer in little-endian byte order, as used by
+// the wire formats.
+char *writeLittleEndian(char *_buffer, const uint64_t _value)
+{
+  for (std::size_t i = 0; i < sizeof(_value); ++i)
+    *_buffer++ = static_cast<char>((_value >> (8 * i)) & 0xff);
+  return _buffer;
+}
+
+//////////////////////////////////////////////////
+// Helper to read a 64-bit integer in little-endian byte order.
+const char *readLittleEndian(const char *_buffer, uint64_t &_value)
+{
+  _value = 0;
+  for (std::size_t i = 0; i < sizeof(_value); ++i)
+  {
+    _value |= static_cast<uint64_t>(
+      static_cast<unsigned char>(*_buffer++)) << (8 * i);
+  }
+  return _buffer;
+}
+
+//////////////////////////////////////////////////
+// Deallocation function for ZMQ frames that own a heap allocated string.
+void DeleteString(void * /*_data*/, void *_hint)
+{
+  delete static_cast<std::string *>(_hint);
+}
+
 //////////////////////////////////////////////////
 // Helper to send an authentication error. This is used by basic
 // authentication.
@@ -306,6 +371,20 @@ NodeShared::NodeShared()
     this->dataPtr->topicStatsEnabled = (gzStats == "1");
   }
 
+  // If GZ_TRANSPORT_COMPACT_HEADER=1 use the compact header with the peers
+  // that support it.
+  std::string gzCompactHeader;
+  if (env("GZ_TRANSPORT_COMPACT_HEADER", gzCompactHeader) &&
+      !gzCompactHeader.empty())
+  {
+    this->dataPtr->compactHeaderEnabled = (gzCompactHeader == "1");
+  }
+
+  // Limit the memory used to decompress a message.
+  this->dataPtr->maxDecompressedSize = static_cast<std::size_t>(
+    this->dataPtr->NonNegativeEnvVar("GZ_TRANSPORT_MAX_DECOMPRESSED_SIZE",
+      static_cast<int>(kDefaultMaxDecompressedSize)));
+
   // My process UUID.
   Uuid uuid;
   this->pUuid = uuid.ToString();
@@ -339,6 +418,14 @@ NodeShared::NodeShared()
   // Start the service thread.
   this->threadReception = std::thread(&NodeShared::RunReceptionTask, this);
 
+  // The first subscriber shard is received by the service thread, the
+  // other hashed shards get their own thread.
+  for (std::size_t i = 1; i < this->dataPtr->numHashedShards; ++i)
+  {
+    this->dataPtr->subscriberShards[i]->thread =
+      std::thread(&NodeShared::RunShardReceptionTask, this, i);
+  }
+
   // Set the callback to notify discovery updates (new topics).
   this->dataPtr->msgDiscovery->ConnectionsCb(
       std::bind(&NodeShared::OnNewConnection, this, std::placeholders::_1));
@@ -369,6 +456,7 @@ NodeShared::NodeShared()
   // Create the local publish thread.
   this->dataPtr->pubThread = std::thread(&NodeSharedPrivate::PublishThread,
       this->dataPtr.get());
+
 }
 
 //////////////////////////////////////////////////
@@ -377,14 +465,49 @@ NodeShared::~NodeShared()
   // Tell the service thread to terminate.
   this->dataPtr->exit = true;
 
-  // Notify the local pubthread and join.
-  this->dataPtr->signalNewPub.notify_all();
+  // The threads of the priority lanes are started while holding the mutex
+  // and only before exit, so none can start after this point.
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->mutex);
+  }
+
+  this->dataPtr->receptionWakeup.Notify();
+  this->dataPtr->accessControlWakeup.Notify();
+  for (auto &shard : this->dataPtr->subscriberShards)
+    shard->wakeup.Notify();
+
+  // Stop the local executor first, which may be blocking the pubthread.
+  if (this->dataPtr->localExecutor)
+    this->dataPtr->localExecutor->Stop();
+
+  // Notify the local pubthread and join. Take the mutex so the notification
+  // can't be missed by a thread about to wait.
+  {
+    std::lock_guard<std::mutex> lk(this->dataPtr->pubThreadMutex);
+    this->dataPtr->signalNewPub.notify_all();
+    this->dataPtr->signalPubQueueSpace.notify_all();
+  }
   this->dataPtr->pubThread.join();
 
+  // Stop the callback executor, which may be blocking the reception thread.
+  if (this->dataPtr->callbackExecutor)
+    this->dataPtr->callbackExecutor->Stop();
+
+  // Stop the executor of the queued subscriptions, which may be blocking
+  // the reception thread or the pubThread.
+  if (this->dataPtr->queueExecutorCreated)
+    this->dataPtr->queueExecutor->Stop();
+
   // Wait for the service thread before exit.
   if (this->threadReception.joinable())
     this->threadReception.join();
 
+  for (auto &shard : this->dataPtr->subscriberShards)
+  {
+    if (shard->thread.joinable())
+      shard->thread.join();
+  }
+
   // Wait for the authentication thread before exit.
   if (this->dataPtr->accessControlThread.joinable())
     this->dataPtr->accessControlThread.join();
@@ -395,23 +518,57 @@ void NodeShared::RunReceptionTask()
 {
   while (!this->dataPtr->exit)
   {
-    // Poll socket for a reply, with timeout.
-    zmq::pollitem_t items[] =
+    // Poll the sockets until one of them is readable. The wakeup channel
+    // interrupts the poll on exit.
+    std::vector<zmq::pollitem_t> items =
     {
-      {static_cast<void*>(*this->dataPtr->subscriber), 0, ZMQ_POLLIN, 0},
+      {static_cast<void*>(this->dataPtr->subscriberShards[0]->socket), 0,
+        ZMQ_POLLIN, 0},
       {static_cast<void*>(*this->dataPtr->replier), 0, ZMQ_POLLIN, 0},
-      {static_cast<void*>(*this->dataPtr->responseReceiver), 0, ZMQ_POLLIN, 0}
+      {static_cast<void*>(*this->dataPtr->responseReceiver), 0, ZMQ_POLLIN, 0},
+      {this->dataPtr->receptionWakeup.Socket(), 0, ZMQ_POLLIN, 0}
     };
+
+    // Also poll the handshake events of the service sockets, if available.
+    const std::size_t firstMonitorItem = items.size();
+    for (auto *monitor : {this->dataPtr->requesterMonitor.get(),
+                          this->dataPtr->replierMonitor.get()})
+    {
+      if (monitor->Socket())
+        items.push_back({monitor->Socket(), 0, ZMQ_POLLIN, 0});
+    }
+
+    // Wake up periodically while a handshake is pending, in case its event
+    // never arrives.
+    bool handshakePending;
+    {
+      std::lock_guard<std::recursive_mutex> lock(this->mutex);
+      handshakePending = this->dataPtr->requesterMonitor->HasPending() ||
+        this->dataPtr->replierMonitor->HasPending();
+    }
+    const std::chrono::milliseconds timeout = handshakePending ?
+      NodeSharedPrivate::kServiceHandshakePollPeriod :
+      std::chrono::milliseconds(-1);
+
     try
     {
-      zmq::poll(&items[0], sizeof(items) / sizeof(items[0]),
-          std::chrono::milliseconds(NodeSharedPrivate::Timeout));
+      zmq::poll(items.data(), items.size(), timeout);
     }
     catch(...)
     {
       continue;
     }
 
+    if (items[3].revents & ZMQ_POLLIN)
+      this->dataPtr->receptionWakeup.Drain();
+
+    bool handshakeEvents = false;
+    for (std::size_t i = firstMonitorItem; i < items.size(); ++i)
+      handshakeEvents |= (items[i].revents & ZMQ_POLLIN) != 0;
+
+    if (handshakeEvents || handshakePending)
+      this->ProcessServiceConnections();
+
     //  If we got a reply, process it.
     if (items[0].revents & ZMQ_POLLIN)
       this->RecvMsgUpdate();
@@ -422,6 +579,95 @@ void NodeShared::RunReceptionTask()
   }
 }
 
+//////////////////////////////////////////////////
+void NodeShared::ProcessServiceConnections()
+{
+  std::vector<std::tuple<std::string, std::string, std::string>> requests;
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->mutex);
+
+    // Collect the requests waiting for the responsers that became ready.
+    auto &requesterMonitor = *this->dataPtr->requesterMonitor;
+    auto responsers = requesterMonitor.ProcessEvents();
+    auto expired = requesterMonitor.ProcessTimeouts(
+      NodeSharedPrivate::kServiceHandshakeTimeout);
+    responsers.insert(responsers.end(), expired.begin(), expired.end());
+    for (const auto &addr : responsers)
+    {
+      auto it = this->dataPtr->pendingRequests.find(addr);
+      if (it == this->dataPtr->pendingRequests.end())
+        continue;
+
+      requests.insert(requests.end(), it->second.begin(), it->second.end());
+      this->dataPtr->pendingRequests.erase(it);
+    }
+
+    // Send the responses waiting for the requesters that became ready.
+    auto &replierMonitor = *this->dataPtr->replierMonitor;
+    auto requesters = replierMonitor.ProcessEvents();
+    expired = replierMonitor.ProcessTimeouts(
+      NodeSharedPrivate::kServiceHandshakeTimeout);
+    requesters.insert(requesters.end(), expired.begin(), expired.end());
+    for (const auto &addr : requesters)
+    {
+      auto it = this->dataPtr->pendingResponses.find(addr);
+      if (it == this->dataPtr->pendingResponses.end())
+        continue;
+
+      for (const auto &frames : it->second)
+      {
+        try
+        {
+          sendFramesHelper(*this->dataPtr->replier, frames);
+        }
+        catch(const zmq::error_t &_error)
+        {
+          std::cerr << "NodeShared::ProcessServiceConnections() error "
+                    << "sending response: " << _error.what() << std::endl;
+        }
+      }
+      this->dataPtr->pendingResponses.erase(it);
+    }
+  }
+
+  for (const auto &req : requests)
+  {
+    this->SendPendingRemoteReqs(
+      std::get<0>(req), std::get<1>(req), std::get<2>(req));
+  }
+}
+
+//////////////////////////////////////////////////
+void NodeShared::RunShardReceptionTask(const std::size_t _shard)
+{
+  NodeSharedPrivate::SubscriberShard &shard =
+    *this->dataPtr->subscriberShards[_shard];
+
+  while (!this->dataPtr->exit)
+  {
+    zmq::pollitem_t items[] =
+    {
+      {static_cast<void*>(shard.socket), 0, ZMQ_POLLIN, 0},
+      {shard.wakeup.Socket(), 0, ZMQ_POLLIN, 0}
+    };
+    try
+    {
+      zmq::poll(&items[0], sizeof(items) / sizeof(items[0]),
+          std::chrono::milliseconds(-1));
+    }
+    catch(...)
+    {
+      continue;
+    }
+
+    if (items[1].revents & ZMQ_POLLIN)
+      shard.wakeup.Drain();
+
+    if (items[0].revents & ZMQ_POLLIN)
+      this->RecvMsgUpdate(_shard);
+  }
+}
+
 //////////////////////////////////////////////////
 bool NodeShared::Publish(
     const std::string &_topic,
@@ -429,54 +675,39 @@ bool NodeShared::Publish(
     const size_t _dataSize, DeallocFunc *_ffn,
     const std::string &_msgType)
 {
+  return this->Publish(_topic, _data, _dataSize, _ffn, nullptr, _msgType);
+}
+
+//////////////////////////////////////////////////
+bool NodeShared::Publish(
+    const std::string &_topic,
+    char *_data,
+    const size_t _dataSize, DeallocFunc *_ffn,
+    void *_hint,
+    const std::string &_msgType,
+    const Priority_t _priority)
+{
+  // The buffer is released here until ZMQ takes ownership of it.
+  NodeSharedPrivate::OwnedBuffer owned(_data, _ffn, _hint);
+
   try
   {
-    // Create the messages.
-    // Note that we use zero copy for passing the message data (msg2).
-    zmq::message_t msg0(_topic.data(), _topic.size()),
-                   msg1(this->myAddress.data(), this->myAddress.size()),
-                   msg2(_data, _dataSize, _ffn, nullptr),
-                   msg3(_msgType.data(), _msgType.size());
+    // Note that we use zero copy for passing the message data.
+    zmq::message_t payload(owned.Get(), _dataSize, _ffn, _hint);
+    owned.Release();
 
     // Send the messages
     std::lock_guard<std::recursive_mutex> lock(this->mutex);
-
-#ifdef GZ_ZMQ_POST_4_3_1
-    this->dataPtr->publisher->send(msg0, zmq::send_flags::sndmore);
-    this->dataPtr->publisher->send(msg1, zmq::send_flags::sndmore);
-    this->dataPtr->publisher->send(msg2, zmq::send_flags::sndmore);
-#else
-    this->dataPtr->publisher->send(msg0, ZMQ_SNDMORE);
-    this->dataPtr->publisher->send(msg1, ZMQ_SNDMORE);
-    this->dataPtr->publisher->send(msg2, ZMQ_SNDMORE);
-#endif
-
-    if (this->dataPtr->topicStatsEnabled)
-    {
-      // Create publication metadata.
-      PublicationMetadata meta;
-      // Send the sequence number, which can be used to detect dropped
-      // messages.
-      meta.seq = this->dataPtr->topicPubSeq[_topic]++;
-      // Send the publication time.
-      meta.stamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-          std::chrono::steady_clock::now().time_since_epoch()).count();
-      zmq::message_t msg4(&meta, sizeof(meta));
-#ifdef GZ_ZMQ_POST_4_3_1
-      this->dataPtr->publisher->send(msg3, zmq::send_flags::sndmore);
-      this->dataPtr->publisher->send(msg4, zmq::send_flags::none);
-#else
-      this->dataPtr->publisher->send(msg3, ZMQ_SNDMORE);
-      this->dataPtr->publisher->send(msg4, 0);
-#endif
+    auto *lane = this->dataPtr->Lane(_priority, this->hostAddr);
+    if (lane)
+    {
+      this->dataPtr->SendMsgFrames(*lane->socket, _topic, lane->address,
+        payload, nullptr, _msgType);
     }
     else
     {
-#ifdef GZ_ZMQ_POST_4_3_1
-      this->dataPtr->publisher->send(msg3, zmq::send_flags::none);
-#else
-      this->dataPtr->publisher->send(msg3, 0);
-#endif
+      this->dataPtr->SendMsgFrames(*this->dataPtr->publisher, _topic,
+        this->myAddress, payload, nullptr, _msgType);
     }
   }
   catch(const zmq::error_t& ze)
@@ -488,74 +719,171 @@ bool NodeShared::Publish(
   return true;
 }
 
+//////////////////////////////////////////////////
+bool NodeShared::PublishBatch(
+    const std::string &_topic,
+    const std::vector<PublishData> &_batch,
+    const std::string &_msgType,
+    const Priority_t _priority)
+{
+  // Number of buffers taken from the batch.
+  std::size_t taken = 0;
+
+  try
+  {
+    // Send all the messages under a single lock.
+    std::lock_guard<std::recursive_mutex> lock(this->mutex);
+
+    zmq::socket_t *socket = this->dataPtr->publisher.get();
+    const std::string *address = &this->myAddress;
+    auto *lane = this->dataPtr->Lane(_priority, this->hostAddr);
+    if (lane)
+    {
+      socket = lane->socket.get();
+      address = &lane->address;
+    }
+
+    BufferPool *pool = &this->dataPtr->bufferPool;
+    while (taken < _batch.size())
+    {
+      const PublishData &item = _batch[taken++];
+
+      // The buffers are released here until ZMQ takes ownership of them.
+      NodeSharedPrivate::OwnedBuffer data(item.data, item.ffn, item.hint);
+      NodeSharedPrivate::OwnedBuffer compressedData(item.compressed,
+        item.compressed ? &BufferPool::Deallocate : nullptr, pool);
+
+      // Note that we use zero copy for passing the message data.
+      zmq::message_t payload(data.Get(), item.size, item.ffn, item.hint);
+      data.Release();
+
+      zmq::message_t compressed(0);
+      if (compressedData.Owned())
+      {
+        compressed.rebuild(compressedData.Get(), item.compressedSize,
+          &BufferPool::Deallocate, pool);
+        compressedData.Release();
+      }
+
+      this->dataPtr->SendMsgFrames(*socket, _topic, *address, payload,
+        item.compressed ? &compressed : nullptr, _msgType);
+    }
+  }
+  catch(const zmq::error_t& ze)
+  {
+    std::cerr << "NodeShared::PublishBatch() Error: " << ze.what()
+              << std::endl;
+
+    // Release the buffers that were not taken yet.
+    for (; taken < _batch.size(); ++taken)
+    {
+      const PublishData &item = _batch[taken];
+      if (item.ffn)
+        item.ffn(item.data, item.hint);
+      if (item.compressed)
+        this->dataPtr->bufferPool.Release(item.compressed);
+    }
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+BufferPool &NodeShared::SerializationBufferPool()
+{
+  return this->dataPtr->bufferPool;
+}
+
 //////////////////////////////////////////////////
 void NodeShared::RecvMsgUpdate()
 {
+  this->RecvMsgUpdate(0);
+}
+
+//////////////////////////////////////////////////
+void NodeShared::RecvMsgUpdate(const std::size_t _shard)
+{
+  NodeSharedPrivate::SubscriberShard &shard =
+    *this->dataPtr->subscriberShards[_shard];
+
   zmq::message_t msg(0);
+  zmq::message_t payload(0);
+  zmq::message_t metaMsg(0);
+  bool compact = false;
+  bool routed = false;
+  bool compressed = false;
+  bool duplicate = false;
+  CompactHeader header;
   std::string topic;
   std::string sender;
-  std::string data;
   std::string msgType;
-  HandlerInfo handlerInfo;
-
+  const InternedTopic *internedTopic = nullptr;
+  const std::string *typeId = nullptr;
+  NodeSharedPrivate::HandlerSnapshot handlerInfo;
+
+  // The callbacks of the REALTIME lane run in this thread, so they never
+  // wait behind the callbacks of other lanes.
+  CallbackExecutor *executor = shard.priority == Priority_t::REALTIME ?
+    nullptr : this->dataPtr->callbackExecutor.get();
+
+  // Only the lock of the shard is held while receiving the frames and
+  // resolving them with the tables of the shard, so the shards don't wait
+  // for each other.
   {
-    std::lock_guard<std::recursive_mutex> lock(this->mutex);
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+    zmq::socket_t &socket = shard.socket;
 
     try
     {
-#ifdef GZ_ZMQ_POST_4_3_1
-      if (!this->dataPtr->subscriber->recv(msg))
-#else
-      if (!this->dataPtr->subscriber->recv(&msg, 0))
-#endif
+      if (!recvFrame(socket, msg))
         return;
-      topic = std::string(reinterpret_cast<char *>(msg.data()), msg.size());
 
-      // TODO(caguero): Use this as extra metadata for the subscriber.
-#ifdef GZ_ZMQ_POST_4_3_1
-      if (!this->dataPtr->subscriber->recv(msg))
-#else
-      if (!this->dataPtr->subscriber->recv(&msg, 0))
-#endif
-        return;
-      sender = std::string(reinterpret_cast<char *>(msg.data()), msg.size());
+      // Messages with the compact header only have one more frame.
+      compact = CompactHeader::IsCompact(
+        reinterpret_cast<const char *>(msg.data()), msg.size());
+      if (compact)
+      {
+        if (!header.Parse(reinterpret_cast<const char *>(msg.data()),
+              msg.size()))
+        {
+          std::cerr << "Error: Unsupported compact header" << std::endl;
 
-#ifdef GZ_ZMQ_POST_4_3_1
-      if (!this->dataPtr->subscriber->recv(msg))
-#else
-      if (!this->dataPtr->subscriber->recv(&msg, 0))
-#endif
-        return;
-      data = std::string(reinterpret_cast<char *>(msg.data()), msg.size());
+          // Discard the rest of the message.
+          while (msg.more())
+          {
+            if (!recvFrame(socket, msg))
+              break;
+          }
+          return;
+        }
 
-#ifdef GZ_ZMQ_POST_4_3_1
-      if (!this->dataPtr->subscriber->recv(msg))
-#else
-      if (!this->dataPtr->subscriber->recv(&msg, 0))
-#endif
-        return;
-      msgType = std::string(reinterpret_cast<char *>(msg.data()), msg.size());
+        if (!recvFrame(socket, payload))
+          return;
 
-      if (this->dataPtr->topicStatsEnabled)
+        compressed = (header.flags & CompactHeader::kFlagCompressed) != 0;
+      }
+      else
       {
-#ifdef GZ_ZMQ_POST_4_3_1
-        if (!this->dataPtr->subscriber->recv(msg))
-#else
-        if (!this->dataPtr->subscriber->recv(&msg, 0))
-#endif
+        topic = std::string(reinterpret_cast<char *>(msg.data()), msg.size());
+        routed = CodecRoute::Parse(topic, compressed);
+
+        // TODO(caguero): Use this as extra metadata for the subscriber.
+        if (!recvFrame(socket, msg))
           return;
-        PublicationMetadata *meta =
-          reinterpret_cast<PublicationMetadata *>(msg.data());
+        sender =
+          std::string(reinterpret_cast<char *>(msg.data()), msg.size());
 
-        // Update topic statistics.
-        if (this->dataPtr->enabledTopicStatistics.find(topic) !=
-            this->dataPtr->enabledTopicStatistics.end())
-        {
-          this->dataPtr->topicStats[topic].Update(sender,
-              meta->stamp, meta->seq);
-          this->dataPtr->enabledTopicStatistics[topic](
-              this->dataPtr->topicStats[topic]);
-        }
+        if (!recvFrame(socket, payload))
+          return;
+
+        if (!recvFrame(socket, msg))
+          return;
+        msgType =
+          std::string(reinterpret_cast<char *>(msg.data()), msg.size());
+
+        if (this->dataPtr->topicStatsEnabled && !recvFrame(socket, metaMsg))
+          return;
       }
     }
     catch(const zmq::error_t &_error)
@@ -564,13 +892,117 @@ void NodeShared::RecvMsgUpdate()
       return;
     }
 
-    handlerInfo = this->CheckHandlerInfo(topic);
+    const NodeSharedPrivate::ReceiveTables &tables = shard.tables;
+    if (compact)
+    {
+      auto compactTopic = tables.compactTopics.find(header.topicId);
+      if (compactTopic == tables.compactTopics.end())
+        return;
+
+      topic = compactTopic->second.topic;
+      msgType = compactTopic->second.msgType;
+      internedTopic = compactTopic->second.internedTopic;
+      typeId = compactTopic->second.typeId;
+
+      auto compactSender = tables.compactSenders.find(header.senderId);
+      if (compactSender != tables.compactSenders.end())
+        sender = compactSender->second;
+    }
+    else
+    {
+      // ZMQ filters match prefixes, so the shard might receive topics that
+      // it didn't subscribe to.
+      auto received = tables.topics.find(topic);
+      if (received == tables.topics.end())
+        return;
+
+      internedTopic = received->second.internedTopic;
+      for (const std::string *receivedType : received->second.typeIds)
+      {
+        if (*receivedType == msgType)
+          typeId = receivedType;
+      }
+
+      // The publisher also sends this message with the compact header or
+      // on the codec route if it has other subscribers using the regular
+      // format.
+      duplicate = (!tables.compactSources.empty() &&
+        tables.compactSources.count(
+          {sender, CompactHeader::TopicId(topic, msgType)}) > 0) ||
+        (!routed && !tables.codecSources.empty() &&
+         tables.codecSources.count({sender, topic}) > 0);
+    }
+  }
+
+  // Update topic statistics.
+  if (this->dataPtr->topicStatsEnabled)
+  {
+    if (compact && (header.flags & CompactHeader::kFlagMetadata))
+    {
+      this->dataPtr->UpdateTopicStats(topic, sender, header.meta.stamp,
+        header.meta.seq);
+    }
+    else if (!compact && !duplicate)
+    {
+      PublicationMetadata *meta =
+        reinterpret_cast<PublicationMetadata *>(metaMsg.data());
+      this->dataPtr->UpdateTopicStats(topic, sender, meta->stamp, meta->seq);
+    }
+  }
+
+  if (duplicate)
+    return;
+
+  // With a callback executor, the handlers are checked when the callbacks
+  // run.
+  if (!executor)
+  {
+    handlerInfo =
+      NodeSharedPrivate::CheckHandlerSnapshot(*this, internedTopic);
+  }
+
+  // Decompress once for all the subscribers. The uncompressed message
+  // replaces the received frame, so it is handled the same way.
+  if (compressed)
+  {
+    auto uncompressed = std::make_unique<std::string>();
+    if (!decompress(static_cast<const char *>(payload.data()),
+          payload.size(), *uncompressed, this->dataPtr->maxDecompressedSize))
+    {
+      std::cerr << "Unable to decompress a message on topic [" << topic
+                << "]" << std::endl;
+      return;
+    }
+    payload.rebuild(uncompressed->data(), uncompressed->size(),
+      &DeleteString, uncompressed.get());
+    uncompressed.release();
   }
 
+  // The callbacks read the payload straight from the ZMQ frame.
   MessageInfo info;
-  info.SetTopicAndPartition(topic);
-  info.SetType(msgType);
-  this->TriggerCallbacks(info, data, handlerInfo);
+  info.SetTopicAndPartition(*internedTopic);
+  if (typeId)
+    info.SetTypeId(typeId);
+  else
+    info.SetType(msgType);
+
+  if (executor)
+  {
+    // One strand per topic keeps the messages of a topic in order.
+    auto frame = std::make_shared<zmq::message_t>(std::move(payload));
+    executor->Post(topic, [this, internedTopic, info, frame]()
+    {
+      this->dataPtr->TriggerCallbacks(info,
+        static_cast<const char *>(frame->data()), frame->size(),
+        NodeSharedPrivate::CheckHandlerSnapshot(*this, internedTopic),
+        frame.get());
+    });
+    return;
+  }
+
+  this->dataPtr->TriggerCallbacks(info,
+    static_cast<const char *>(payload.data()), payload.size(), handlerInfo,
+    &payload);
 }
 
 //////////////////////////////////////////////////
@@ -617,74 +1049,53 @@ void NodeShared::TriggerCallbacks(
     const std::string &_msgData,
     const HandlerInfo &_handlerInfo)
 {
-  if (!_handlerInfo.haveLocal && !_handlerInfo.haveRaw)
-    return;
+  this->TriggerCallbacks(_info, _msgData.data(), _msgData.size(),
+    _handlerInfo);
+}
 
-  if (_handlerInfo.haveRaw)
-  {
-    for (const auto &node : _handlerInfo.rawHandlers)
-    {
-      for (const auto &handler : node.second)
-      {
-        const RawSubscriptionHandlerPtr &rawHandler = handler.second;
-        if (rawHandler)
-        {
-          if (rawHandler->TypeName() == _info.Type() ||
-              rawHandler->TypeName() == kGenericMessageType)
-          {
-            rawHandler->RunRawCallback(_msgData.c_str(), _msgData.size(),
-                _info);
-          }
-        }
-        else
-          std::cerr << "Raw subscription handler is NULL" << std::endl;
-      }
-    }
+//////////////////////////////////////////////////
+/// \brief Flatten the handlers of a HandlerInfo into a list.
+/// \param[in] _handlers Handlers keyed by node UUID and handler UUID.
+/// \return The list of handlers or nullptr if there are none.
+template<typename HandlerT>
+static typename HandlerStorage<HandlerT>::HandlerListPtr FlattenHandlers(
+  const std::map<std::string, std::map<std::string,
+    std::shared_ptr<HandlerT>>> &_handlers)
+{
+  auto list = std::make_shared<
+    typename HandlerStorage<HandlerT>::HandlerList>();
+  for (const auto &node : _handlers)
+  {
+    for (const auto &handler : node.second)
+      list->push_back(handler.second);
   }
 
-  if (_handlerInfo.haveLocal)
-  {
-    // This will be instantiated by the first suitable handler that we
-    // encounter. If there is no suitable handler, then we can avoid
-    // deserializing the message altogether.
-    std::shared_ptr<ProtoMsg> msg;
+  if (list->empty())
+    return nullptr;
 
-    for (const auto &node : _handlerInfo.localHandlers)
-    {
-      for (const auto &handler : node.second)
-      {
-        const ISubscriptionHandlerPtr &localHandler = handler.second;
-        if (localHandler)
-        {
-          if (localHandler->TypeName() == _info.Type() ||
-              localHandler->TypeName() == kGenericMessageType)
-          {
-            if (!msg)
-            {
-              // If the message has not been deserialized yet, do it now since
-              // we have allegedly found a subscriber which should be able to
-              // do it.
-              msg = localHandler->CreateMsg(_msgData, _info.Type());
-
-              if (!msg)
-              {
-                // If the message could not be created, then none of the
-                // handlers in this process will be able to create it, because
-                // protobuf has access to all message types that the current
-                // process is linked to. If CreateMsg(~,~) fails, then we may
-                // as well quit.
-                return;
-              }
-            }
+  return list;
+}
 
-            localHandler->RunLocalCallback(*msg, _info);
-          }
-        }
-        else
-          std::cerr << "Local subscription handler is NULL" << std::endl;
-      }
-    }
+//////////////////////////////////////////////////
+void NodeShared::TriggerCallbacks(
+    const MessageInfo &_info,
+    const char *_msgData,
+    const std::size_t _size,
+    const HandlerInfo &_handlerInfo)
+{
+  NodeSharedPrivate::HandlerSnapshot handlers;
+  if (_handlerInfo.haveLocal)
+  {
+    handlers.localHandlers = FlattenHandlers(_handlerInfo.localHandlers);
+    handlers.haveLocal = handlers.localHandlers != nullptr;
+  }
+  if (_handlerInfo.haveRaw)
+  {
+    handlers.rawHandlers = FlattenHandlers(_handlerInfo.rawHandlers);
+    handlers.haveRaw = handlers.rawHandlers != nullptr;
   }
+
+  this->dataPtr->TriggerCallbacks(_info, _msgData, _size, handlers, nullptr);
 }
 
 //////////////////////////////////////////////////
@@ -818,77 +1229,35 @@ void NodeShared::RecvSrvRequest()
     else
       resultStr = "0";
 
+    std::vector<std::string> frames =
+      {dstId, topic, nodeUuid, reqUuid, rep, resultStr};
+
+    std::lock_guard<std::recursive_mutex> lock(this->mutex);
+
+    // I am still not connected to this address.
+    if (this->dataPtr->replierMonitor->Add(sender))
     {
-      std::lock_guard<std::recursive_mutex> lock(this->mutex);
-      // I am still not connected to this address.
-      if (std::find(this->srvConnections.begin(), this->srvConnections.end(),
-            sender) == this->srvConnections.end())
-      {
-        this->dataPtr->replier->connect(sender.c_str());
-        this->srvConnections.push_back(sender);
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      this->dataPtr->replier->connect(sender.c_str());
 
-        if (this->verbose)
-        {
-          std::cout << "\t* Connected to [" << sender
-                    << "] for sending a response" << std::endl;
-        }
+      if (this->verbose)
+      {
+        std::cout << "\t* Connected to [" << sender
+                  << "] for sending a response" << std::endl;
       }
     }
 
+    // The replier can't route the response until the handshake with the
+    // requester succeeds. Hold it until then.
+    if (!this->dataPtr->replierMonitor->Ready(sender))
+    {
+      this->dataPtr->pendingResponses[sender].push_back(std::move(frames));
+      return;
+    }
+
     // Send the reply.
     try
     {
-      std::lock_guard<std::recursive_mutex> lock(this->mutex);
-      zmq::message_t response;
-
-      response.rebuild(dstId.size());
-      memcpy(response.data(), dstId.data(), dstId.size());
-#ifdef GZ_ZMQ_POST_4_3_1
-      this->dataPtr->replier->send(response, zmq::send_flags::sndmore);
-#else
-      this->dataPtr->replier->send(response, ZMQ_SNDMORE);
-#endif
-
-      response.rebuild(topic.size());
-      memcpy(response.data(), topic.data(), topic.size());
-#ifdef GZ_ZMQ_POST_4_3_1
-      this->dataPtr->replier->send(response, zmq::send_flags::sndmore);
-#else
-      this->dataPtr->replier->send(response, ZMQ_SNDMORE);
-#endif
-
-      response.rebuild(nodeUuid.size());
-      memcpy(response.data(), nodeUuid.data(), nodeUuid.size());
-#ifdef GZ_ZMQ_POST_4_3_1
-      this->dataPtr->replier->send(response, zmq::send_flags::sndmore);
-#else
-      this->dataPtr->replier->send(response, ZMQ_SNDMORE);
-#endif
-
-      response.rebuild(reqUuid.size());
-      memcpy(response.data(), reqUuid.data(), reqUuid.size());
-#ifdef GZ_ZMQ_POST_4_3_1
-      this->dataPtr->replier->send(response, zmq::send_flags::sndmore);
-#else
-      this->dataPtr->replier->send(response, ZMQ_SNDMORE);
-#endif
-
-      response.rebuild(rep.size());
-      memcpy(response.data(), rep.data(), rep.size());
-#ifdef GZ_ZMQ_POST_4_3_1
-      this->dataPtr->replier->send(response, zmq::send_flags::sndmore);
-#else
-      this->dataPtr->replier->send(response, ZMQ_SNDMORE);
-#endif
-
-      response.rebuild(resultStr.size());
-      memcpy(response.data(), resultStr.data(), resultStr.size());
-#ifdef GZ_ZMQ_POST_4_3_1
-      this->dataPtr->replier->send(response, zmq::send_flags::none);
-#else
-      this->dataPtr->replier->send(response, 0);
-#endif
+      sendFramesHelper(*this->dataPtr->replier, frames);
     }
     catch(const zmq::error_t &_error)
     {
@@ -1048,17 +1417,26 @@ void NodeShared::SendPendingRemoteReqs(const std::string &_topic,
   std::lock_guard<std::recursive_mutex> lock(this->mutex);
 
   // I am still not connected to this address.
-  if (std::find(this->srvConnections.begin(), this->srvConnections.end(),
-        responserAddr) == this->srvConnections.end())
+  if (this->dataPtr->requesterMonitor->Add(responserAddr))
   {
     this->dataPtr->requester->connect(responserAddr.c_str());
-    this->srvConnections.push_back(responserAddr);
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
     if (this->verbose)
     {
       std::cout << "\t* Connected to [" << responserAddr
                 << "] for service requests" << std::endl;
     }
+
+    // Let the reception thread watch the handshake.
+    this->dataPtr->receptionWakeup.Notify();
+  }
+
+  // The requester can't route the requests until the handshake with the
+  // responser succeeds. ProcessServiceConnections() sends them afterwards.
+  if (!this->dataPtr->requesterMonitor->Ready(responserAddr))
+  {
+    this->dataPtr->pendingRequests[responserAddr].emplace(
+      _topic, _reqType, _repType);
+    return;
   }
 
   // Send all the pending REQs.
@@ -1185,6 +1563,45 @@ void NodeShared::SendPendingRemoteReqs(const std::string &_topic,
   }
 }
 
+//////////////////////////////////////////////////
+bool NodeShared::MatchTopicPatterns(const std::string &_topic,
+  const std::string &_msgType)
+{
+  std::vector<std::shared_ptr<NodeSharedPrivate::PatternSubscription>> subs;
+  if (!this->dataPtr->topicPatterns.Match(_topic, subs))
+    return false;
+
+  // The type comes from discovery, so it is only looked up.
+  const std::string *typeId = InternTable::Find(_msgType);
+  bool added = false;
+  for (const auto &sub : subs)
+  {
+    SubscriptionHandlerBase &handler = sub->handler ?
+      static_cast<SubscriptionHandlerBase &>(*sub->handler) : *sub->rawHandler;
+    const bool accepted = typeId ? handler.AcceptsType(typeId) :
+                                   handler.AcceptsType(_msgType);
+    if (!accepted || !sub->topics.insert(_topic).second)
+      continue;
+
+    if (sub->handler)
+    {
+      this->localSubscribers.normal.AddHandler(
+        _topic, sub->nUuid, sub->handler);
+    }
+    else
+    {
+      this->localSubscribers.raw.AddHandler(
+        _topic, sub->nUuid, sub->rawHandler);
+    }
+    added = true;
+  }
+
+  if (added)
+    this->dataPtr->SubscribersChanged();
+
+  return added;
+}
+
 //////////////////////////////////////////////////
 void NodeShared::OnNewConnection(const MessagePublisher &_pub)
 {
@@ -1200,24 +1617,49 @@ void NodeShared::OnNewConnection(const MessagePublisher &_pub)
 
   std::lock_guard<std::recursive_mutex> lock(this->mutex);
 
+  // Subscribe the matching topic patterns to the new topic.
+  this->MatchTopicPatterns(topic, _pub.MsgTypeName());
+
   // Check if we are interested in this topic.
   if (this->localSubscribers.HasSubscriber(topic) &&
       this->pUuid.compare(procUuid) != 0)
   {
-    // Handle security
-    this->dataPtr->SecurityOnNewConnection();
+    NodeSharedPrivate::SubscriberShard &shard =
+      this->dataPtr->Shard(topic, _pub.Options().Priority());
+
+    {
+      std::lock_guard<std::mutex> shardLock(shard.mutex);
+
+      // Handle security
+      this->dataPtr->SecurityOnNewConnection(shard.socket);
+
+      // The shard is not connected to the process.
+      if (shard.connected.insert(addr).second)
+        shard.socket.connect(addr.c_str());
+
+      // The names are interned once per connection, so the received
+      // messages are dispatched by address.
+      NodeSharedPrivate::ReceivedTopic &received = shard.tables.topics[topic];
+      received.internedTopic = InternTable::Topic(topic);
+      const std::string *typeId = InternTable::String(_pub.MsgTypeName());
+      if (std::find(received.typeIds.begin(), received.typeIds.end(),
+            typeId) == received.typeIds.end())
+      {
+        received.typeIds.push_back(typeId);
+      }
+    }
 
-    // I am not connected to the process.
-    if (!this->connections.HasPublisher(addr))
-      this->dataPtr->subscriber->connect(addr.c_str());
+    // The threads of the priority lanes start with their first publisher.
+    if (shard.priority != Priority_t::NORMAL && !shard.thread.joinable() &&
+        !this->dataPtr->exit)
+    {
+      shard.thread = std::thread(&NodeShared::RunShardReceptionTask, this,
+        shard.index);
+    }
 
     // Add a new filter for the topic.
-#ifdef GZ_CPPZMQ_POST_4_7_0
-    this->dataPtr->subscriber->set(zmq::sockopt::subscribe, topic);
-#else
-    this->dataPtr->subscriber->setsockopt(ZMQ_SUBSCRIBE,
-        topic.data(), topic.size());
-#endif
+    shard.SetFilter(topic, true);
+    this->dataPtr->topicShards[topic].insert(&shard);
 
     // Register the new connection with the publisher.
     this->connections.AddPublisher(_pub);
@@ -1228,6 +1670,17 @@ void NodeShared::OnNewConnection(const MessagePublisher &_pub)
     MessagePublisher pub(_pub);
     pub.SetPUuid(this->pUuid);
 
+    // Echo the topic ID to request the compact header. Otherwise, the
+    // publisher uses the regular format.
+    if (!this->dataPtr->AddCompactSource(_pub, shard))
+    {
+      pub.SetTopicId(0);
+      this->dataPtr->AddCodecSource(_pub, shard);
+    }
+
+    // Announce the compression codecs that we can decode.
+    pub.SetCodecs(supportedCodecs());
+
     // Hack: We use this field to store the PUuid of the topic publisher.
     pub.SetCtrl(_pub.PUuid());
 
@@ -1263,6 +1716,8 @@ void NodeShared::OnNewDisconnection(const MessagePublisher &_pub)
   if (topic != "" && nUuid != "")
   {
     this->remoteSubscribers.DelPublisherByNode(topic, procUuid, nUuid);
+    this->dataPtr->UpdateRemoteWireFormats(topic, this->remoteSubscribers);
+    this->dataPtr->SubscribersChanged();
 
     MessagePublisher connection;
     if (!this->connections.Publisher(topic, procUuid, nUuid, connection))
@@ -1270,6 +1725,7 @@ void NodeShared::OnNewDisconnection(const MessagePublisher &_pub)
 
     // I am no longer connected.
     this->connections.DelPublisherByNode(topic, procUuid, nUuid);
+    this->dataPtr->RemovePublisherSources(connection, this->connections);
   }
   else
   {
@@ -1279,11 +1735,18 @@ void NodeShared::OnNewDisconnection(const MessagePublisher &_pub)
     // data anymore.
 
     MsgAddresses_M info;
-    if (!this->connections.Publishers(topic, info))
+    this->connections.PublishersByProc(procUuid, info);
+    if (info.empty())
       return;
 
     // Remove all the connections from the process disonnected.
     this->connections.DelPublishersByProc(procUuid);
+
+    for (auto const &node : info)
+    {
+      for (auto const &connection : node.second)
+        this->dataPtr->RemovePublisherSources(connection, this->connections);
+    }
   }
 }
 
@@ -1303,18 +1766,19 @@ void NodeShared::OnNewSrvConnection(const ServicePublisher &_pub)
     std::cout << _pub;
   }
 
-  // I am still not connected to this address.
-  if (std::find(this->srvConnections.begin(), this->srvConnections.end(),
-        addr) == this->srvConnections.end())
+  // I am still not connected to this address. The pending requests are
+  // sent once the handshake succeeds.
+  if (this->dataPtr->requesterMonitor->Add(addr))
   {
     this->dataPtr->requester->connect(addr.c_str());
-    this->srvConnections.push_back(addr);
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
     if (this->verbose)
     {
       std::cout << "\t* Connected to [" << addr
                 << "] for service requests" << std::endl;
     }
+
+    // Let the reception thread watch the handshake.
+    this->dataPtr->receptionWakeup.Notify();
   }
 
   // Check if there's a pending service request with this specific combination
@@ -1334,10 +1798,10 @@ void NodeShared::OnNewSrvDisconnection(const ServicePublisher &_pub)
 
   std::lock_guard<std::recursive_mutex> lock(this->mutex);
 
-  // Remove the address from the list of connected addresses.
-  this->srvConnections.erase(std::remove(std::begin(this->srvConnections),
-    std::end(this->srvConnections), addr.c_str()),
-    std::end(this->srvConnections));
+  // Remove the address from the list of connected addresses. Its pending
+  // requests wait for another responser.
+  this->dataPtr->requesterMonitor->Remove(addr);
+  this->dataPtr->pendingRequests.erase(addr);
 
   if (this->verbose)
   {
@@ -1366,6 +1830,9 @@ void NodeShared::OnNewRegistration(const MessagePublisher &_pub)
   // Add a remote subscriber.
   std::lock_guard<std::recursive_mutex> lock(this->mutex);
   this->remoteSubscribers.AddPublisher(_pub);
+  this->dataPtr->UpdateRemoteWireFormats(_pub.Topic(),
+    this->remoteSubscribers);
+  this->dataPtr->SubscribersChanged();
 }
 
 //////////////////////////////////////////////////
@@ -1389,11 +1856,20 @@ void NodeShared::OnEndRegistration(const MessagePublisher &_pub)
   // Delete a remote subscriber.
   std::lock_guard<std::recursive_mutex> lock(this->mutex);
   this->remoteSubscribers.DelPublisherByNode(topic, procUuid, nodeUuid);
+  this->dataPtr->UpdateRemoteWireFormats(topic, this->remoteSubscribers);
+  this->dataPtr->SubscribersChanged();
 }
 
 //////////////////////////////////////////////////
 bool NodeShared::InitializeSockets()
 {
+  // Track the handshakes of the service sockets.
+  void *context = static_cast<void *>(*this->dataPtr->context);
+  this->dataPtr->requesterMonitor = std::make_unique<ConnectionMonitor>(
+    context, static_cast<void *>(*this->dataPtr->requester));
+  this->dataPtr->replierMonitor = std::make_unique<ConnectionMonitor>(
+    context, static_cast<void *>(*this->dataPtr->replier));
+
   try
   {
     // Set the hostname's ip address.
@@ -1429,12 +1905,41 @@ bool NodeShared::InitializeSockets()
       }
     }
 
+    for (auto &shard : this->dataPtr->subscriberShards)
+    {
 #ifdef GZ_CPPZMQ_POST_4_7_0
-    this->dataPtr->subscriber->set(zmq::sockopt::rcvhwm, rcvQueueVal);
+      shard->socket.set(zmq::sockopt::rcvhwm, rcvQueueVal);
 #else
-    this->dataPtr->subscriber->setsockopt(ZMQ_RCVHWM,
-          &rcvQueueVal, sizeof(rcvQueueVal));
+      shard->socket.setsockopt(ZMQ_RCVHWM,
+            &rcvQueueVal, sizeof(rcvQueueVal));
 #endif
+    }
+
+    // Run the callbacks of the received messages on a pool of threads. The
+    // messages waiting for a thread are bounded by the same high water mark.
+    const int callbackThreads = this->dataPtr->NonNegativeEnvVar(
+      "GZ_TRANSPORT_CALLBACK_THREADS", 0);
+    if (callbackThreads > 0)
+    {
+      this->dataPtr->callbackExecutor = std::make_unique<CallbackExecutor>(
+        static_cast<unsigned int>(callbackThreads),
+        static_cast<std::size_t>(rcvQueueVal));
+    }
+
+    // The subscriptions with a queue depth or keep last enabled have their
+    // own strands, so they run in parallel on the same number of threads.
+    this->dataPtr->queueThreads =
+      static_cast<unsigned int>(std::max(callbackThreads, 1));
+
+    // Run the callbacks of the messages published from this process on a
+    // pool of threads, so a slow subscriber does not delay the others.
+    const int localCallbackThreads = this->dataPtr->NonNegativeEnvVar(
+      "GZ_TRANSPORT_LOCAL_CALLBACK_THREADS", 0);
+    if (localCallbackThreads > 0)
+    {
+      this->dataPtr->localExecutor = std::make_unique<CallbackExecutor>(
+        static_cast<unsigned int>(localCallbackThreads));
+    }
 
     // Set the capacity of the buffer for sending messages.
     int sndQueueVal = this->dataPtr->NonNegativeEnvVar(
@@ -1452,6 +1957,8 @@ bool NodeShared::InitializeSockets()
       }
     }
 
+    this->dataPtr->sndHwm = sndQueueVal;
+
 #ifdef GZ_CPPZMQ_POST_4_7_0
     this->dataPtr->publisher->set(zmq::sockopt::sndhwm, sndQueueVal);
 
@@ -1552,11 +2059,15 @@ int NodeShared::RcvHwm()
   int rcvHwm;
   try
   {
+    // All the shards use the same high water mark.
+    NodeSharedPrivate::SubscriberShard &shard =
+      *this->dataPtr->subscriberShards[0];
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
 #ifdef GZ_CPPZMQ_POST_4_7_0
-    rcvHwm = this->dataPtr->subscriber->get(zmq::sockopt::rcvhwm);
+    rcvHwm = shard.socket.get(zmq::sockopt::rcvhwm);
 #else
     size_t rcvHwmSize = sizeof(rcvHwm);
-    this->dataPtr->subscriber->getsockopt(ZMQ_RCVHWM, &rcvHwm, &rcvHwmSize);
+    shard.socket.getsockopt(ZMQ_RCVHWM, &rcvHwm, &rcvHwmSize);
 #endif
   }
   catch (zmq::error_t &_e)
@@ -1588,6 +2099,18 @@ int NodeShared::SndHwm()
   return sndHwm;
 }
 
+//////////////////////////////////////////////////
+uint64_t NodeShared::PublishQueueDepth() const
+{
+  return this->dataPtr->PubQueueDepth();
+}
+
+//////////////////////////////////////////////////
+uint64_t NodeShared::PublishQueueHighWater() const
+{
+  return this->dataPtr->pubHighWater;
+}
+
 //////////////////////////////////////////////////
 bool NodeShared::HandlerWrapper::HasSubscriber(
     const std::string &_fullyQualifiedTopic,
@@ -1621,14 +2144,16 @@ static void AppendNodeUuids(const HandlerStorage<HandlerT> &_handlerStorage,
   std::map<std::string, std::map<std::string, HandlerTPtr>> handlers;
 
   _handlerStorage.Handlers(_fullyQualifiedTopic, handlers);
+
+  // The type comes from discovery, so it is only looked up.
+  const std::string *typeId = InternTable::Find(_msgTypeName);
   for (const auto &collection : handlers)
   {
     for (const auto &collectionEntry : collection.second)
     {
       const HandlerTPtr &handler = collectionEntry.second;
-      const std::string &handlerMsgType = handler->TypeName();
-      if (handlerMsgType == _msgTypeName
-          || handlerMsgType == kGenericMessageType)
+      if (typeId ? handler->AcceptsType(typeId) :
+                   handler->AcceptsType(_msgTypeName))
       {
         _uuids.push_back(handler->NodeUuid());
       }
@@ -1662,7 +2187,7 @@ bool NodeShared::HandlerWrapper::RemoveHandlersForNode(
 
 
 //////////////////////////////////////////////////
-void NodeSharedPrivate::SecurityOnNewConnection()
+void NodeSharedPrivate::SecurityOnNewConnection(zmq::socket_t &_subscriber)
 {
   std::string user, pass;
 
@@ -1675,11 +2200,11 @@ void NodeSharedPrivate::SecurityOnNewConnection()
   if (userPass(user, pass))
   {
 #ifdef GZ_CPPZMQ_POST_4_7_0
-    this->subscriber->set(zmq::sockopt::plain_username, user);
-    this->subscriber->set(zmq::sockopt::plain_password, pass);
+    _subscriber.set(zmq::sockopt::plain_username, user);
+    _subscriber.set(zmq::sockopt::plain_password, pass);
 #else
-    this->subscriber->setsockopt(ZMQ_PLAIN_USERNAME, user.c_str(), user.size());
-    this->subscriber->setsockopt(ZMQ_PLAIN_PASSWORD, pass.c_str(), pass.size());
+    _subscriber.setsockopt(ZMQ_PLAIN_USERNAME, user.c_str(), user.size());
+    _subscriber.setsockopt(ZMQ_PLAIN_PASSWORD, pass.c_str(), pass.size());
 #endif
   }
 }
@@ -1696,16 +2221,26 @@ void NodeSharedPrivate::SecurityInit()
     this->accessControlThread = std::thread(
         &NodeSharedPrivate::AccessControlHandler, this);
 
+    this->SecurityInitPublisher(*this->publisher);
+  }
+}
+
+//////////////////////////////////////////////////
+void NodeSharedPrivate::SecurityInitPublisher(zmq::socket_t &_publisher)
+{
+  std::string user, pass;
+  if (userPass(user, pass))
+  {
     int asPlainSecurityServer = static_cast<int>(
         ZmqPlainSecurityServerOptions::ZMQ_PLAIN_SECURITY_SERVER_ENABLED);
 
 #ifdef GZ_CPPZMQ_POST_4_7_0
-    this->publisher->set(zmq::sockopt::plain_server, asPlainSecurityServer);
-    this->publisher->set(zmq::sockopt::zap_domain, kGzAuthDomain);
+    _publisher.set(zmq::sockopt::plain_server, asPlainSecurityServer);
+    _publisher.set(zmq::sockopt::zap_domain, kGzAuthDomain);
 #else
-    this->publisher->setsockopt(ZMQ_PLAIN_SERVER,
+    _publisher.setsockopt(ZMQ_PLAIN_SERVER,
         &asPlainSecurityServer, sizeof(asPlainSecurityServer));
-    this->publisher->setsockopt(ZMQ_ZAP_DOMAIN, kGzAuthDomain,
+    _publisher.setsockopt(ZMQ_ZAP_DOMAIN, kGzAuthDomain,
         std::strlen(kGzAuthDomain));
 #endif
   }
@@ -1746,6 +2281,7 @@ void NodeSharedPrivate::AccessControlHandler()
     zmq::pollitem_t items[] =
     {
       {static_cast<void*>(*sock), 0, ZMQ_POLLIN, 0},
+      {this->accessControlWakeup.Socket(), 0, ZMQ_POLLIN, 0},
     };
 
     // Process
@@ -1754,13 +2290,16 @@ void NodeSharedPrivate::AccessControlHandler()
       try
       {
         zmq::poll(&items[0], sizeof(items) / sizeof(items[0]),
-            std::chrono::milliseconds(NodeSharedPrivate::Timeout));
+            std::chrono::milliseconds(-1));
       }
       catch(...)
       {
         continue;
       }
 
+      if (items[1].revents & ZMQ_POLLIN)
+        this->accessControlWakeup.Drain();
+
       if (items[0].revents & ZMQ_POLLIN)
       {
         // Get the version.
@@ -1862,92 +2401,1201 @@ void NodeSharedPrivate::AccessControlHandler()
 /////////////////////////////////////////////////
 void NodeSharedPrivate::PublishThread()
 {
+  // Reused for all the publications.
+  PublishMsgDetails msgDetails;
+
   // Loop until exits
-  while (!this->exit)
+  while (this->NextPublication(msgDetails))
   {
-    std::unique_ptr<PublishMsgDetails> msgDetails = nullptr;
-    // Lock the mutex, and acquire the next message to be published.
-    {
-      std::unique_lock<std::mutex> queueLock(this->pubThreadMutex);
+    // The tasks of the local executor may outlive msgDetails.
+    std::shared_ptr<const MessageInfo> info;
+    if (this->localExecutor)
+      info = std::make_shared<const MessageInfo>(msgDetails.info);
 
-      // Wait for more messages if the queue is empty. Otherwise get the
-      // next message and continue.
-      if (this->pubQueue.empty())
+    for (const auto &sample : msgDetails.samples)
+    {
+      // Send the message to all the local handlers.
+      for (auto &handler : msgDetails.localHandlers)
       {
-        auto now = std::chrono::system_clock::now();
-        this->signalNewPub.wait_until(queueLock, now + 500ms,
-          [&]{return !this->pubQueue.empty() || this->exit;});
+        if (Queued(handler->Options(), true))
+        {
+          this->EnqueueReceived(msgDetails.topic, handler, nullptr,
+            {nullptr, 0, sample.msgCopy, msgDetails.info});
+          continue;
+        }
+
+        if (this->localExecutor)
+        {
+          std::shared_ptr<const ProtoMsg> msg = sample.msgCopy;
+          this->PostLocal(msgDetails.topic, *handler, [handler, msg, info]()
+          {
+            RunLocalCallback(*handler, msg, *info);
+          });
+          continue;
+        }
+
+        RunLocalCallback(*handler, sample.msgCopy, msgDetails.info);
       }
 
-      if (this->pubQueue.empty())
-        continue;
+      // Send the message to all the raw handlers.
+      for (auto &handler : msgDetails.rawHandlers)
+      {
+        if (Queued(handler->Options(), true))
+        {
+          this->EnqueueReceived(msgDetails.topic, nullptr, handler,
+            {sample.sharedBuffer, sample.msgSize, nullptr, msgDetails.info});
+          continue;
+        }
 
-      // Stop early on exit.
-      if (this->exit)
-        break;
+        if (this->localExecutor)
+        {
+          SharedPayload buffer = sample.sharedBuffer;
+          const std::size_t size = sample.msgSize;
+          this->PostLocal(msgDetails.topic, *handler,
+            [handler, buffer, size, info]()
+          {
+            RunRawCallback(*handler, buffer.get(), size, *info);
+          });
+          continue;
+        }
 
-      // Get the message
-      msgDetails = std::move(this->pubQueue.front());
-      this->pubQueue.pop();
+        RunRawCallback(*handler, sample.sharedBuffer.get(), sample.msgSize,
+          msgDetails.info);
+      }
     }
 
-    // Send the message to all the local handlers.
-    for (auto &handler : msgDetails->localHandlers)
+    // Don't keep the handlers and the messages alive until the next
+    // publication.
+    msgDetails.localHandlers.clear();
+    msgDetails.rawHandlers.clear();
+    msgDetails.samples.clear();
+  }
+}
+
+/////////////////////////////////////////////////
+void NodeSharedPrivate::RunLocalCallback(ISubscriptionHandler &_handler,
+    const std::shared_ptr<const ProtoMsg> &_msg, const MessageInfo &_info)
+{
+  // Publications from the callback don't re-enter it inline.
+  activeHandlers.push_back(&_handler);
+  try
+  {
+    _handler.RunLocalCallback(_msg, _info);
+  }
+  catch (...)
+  {
+    std::cerr << "Exception occurred in a local callback "
+      << "on topic [" << _info.Topic() << "] with message ["
+      << _msg->DebugString() << "]" << std::endl;
+  }
+  activeHandlers.pop_back();
+}
+
+/////////////////////////////////////////////////
+void NodeSharedPrivate::RunRawCallback(RawSubscriptionHandler &_handler,
+    const char *_msgData, const std::size_t _size, const MessageInfo &_info)
+{
+  activeHandlers.push_back(&_handler);
+  try
+  {
+    _handler.RunRawCallback(_msgData, _size, _info);
+  }
+  catch (...)
+  {
+    std::cerr << "Exception occured in a local raw callback "
+      << "on topic [" << _info.Topic() << "] with "
+      << "message of size [" << _size << "]" << std::endl;
+  }
+  activeHandlers.pop_back();
+}
+
+/////////////////////////////////////////////////
+std::string NodeSharedPrivate::LocalStrand(const std::string &_topic,
+    const std::string &_nUuid, const std::string &_hUuid)
+{
+  return _topic + "#" + _nUuid + "#" + _hUuid;
+}
+
+/////////////////////////////////////////////////
+void NodeSharedPrivate::PostLocal(const std::string &_topic,
+    const SubscriptionHandlerBase &_handler, std::function<void()> _task)
+{
+  const SubscribeOptions &opts = _handler.Options();
+  std::size_t dropped = 0;
+  this->localExecutor->Post(
+    LocalStrand(_topic, _handler.NodeUuid(), _handler.HandlerUuid()),
+    std::move(_task), opts.LocalQueueDepth(), opts.Overflow(),
+    opts.BlockTimeout(), dropped);
+
+  if (dropped > 0)
+    this->RecordDrops(_topic, dropped);
+}
+
+/////////////////////////////////////////////////
+bool NodeSharedPrivate::NextPublication(PublishMsgDetails &_details)
+{
+  while (!this->exit)
+  {
+    // Take turns with the pubQueue while it isn't empty, so a busy ring
+    // can't starve the publications with a queue depth.
+    const bool queueTurn = this->pubQueueTurn && this->pubQueueSize > 0;
+    this->pubQueueTurn = !this->pubQueueTurn;
+    if (!queueTurn && this->pubRing.TryPop(_details))
+      return true;
+
+    std::unique_lock<std::mutex> lk(this->pubThreadMutex);
+
+    // The publications that overflowed the ring are newer than the ones in
+    // the ring, so they wait until it is drained.
+    if (!this->pubQueue.empty() &&
+        (this->pubQueue.front().bounded || this->pubRing.Empty()))
     {
-      try
+      _details = std::move(this->pubQueue.front());
+      this->pubQueue.pop_front();
+      --this->pubQueueSize;
+
+      if (_details.bounded)
       {
-        handler->RunLocalCallback(*(msgDetails->msgCopy.get()),
-            msgDetails->info);
+        auto depth = this->pubQueueDepths.find(_details.topic);
+        if (depth != this->pubQueueDepths.end() && --depth->second == 0)
+          this->pubQueueDepths.erase(depth);
+        this->signalPubQueueSpace.notify_all();
       }
-      catch (...)
+      else
       {
-        std::cerr << "Exception occurred in a local callback "
-          << "on topic [" << msgDetails->info.Topic() << "] with message ["
-          << msgDetails->msgCopy->DebugString() << "]" << std::endl;
+        --this->pubOverflow;
       }
+      return true;
     }
 
-    // Send the message to all the raw handlers.
-    for (auto &handler : msgDetails->rawHandlers)
+    if (!this->pubRing.Empty())
     {
-      try
-      {
-        handler->RunRawCallback(msgDetails->sharedBuffer.get(),
-            msgDetails->msgSize, msgDetails->info);
-      }
-      catch (...)
-      {
-        std::cerr << "Exception occured in a local raw callback "
-          << "on topic [" << msgDetails->info.Topic() << "] with "
-          << "message [" << msgDetails->msgCopy->DebugString() << "]"
-          << std::endl;
-      }
+      // A producer is still writing the oldest item of the ring.
+      lk.unlock();
+      std::this_thread::yield();
+      continue;
     }
+
+    // Park until there is work. The producers check the flag after adding
+    // their publication, and the fences guarantee that either they see it
+    // or the wait predicate sees their publication.
+    this->pubThreadParked = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    this->signalNewPub.wait(lk, [&]
+      {
+        return !this->pubRing.Empty() || !this->pubQueue.empty() ||
+          this->exit;
+      });
+    this->pubThreadParked = false;
   }
+
+  return false;
 }
 
-//////////////////////////////////////////////////
-std::optional<transport::TopicStatistics> NodeShared::TopicStats(
-    const std::string &_topic) const
+/////////////////////////////////////////////////
+uint64_t NodeSharedPrivate::PubQueueDepth() const
 {
-  if (this->dataPtr->topicStats.find(_topic) != this->dataPtr->topicStats.end())
-    return this->dataPtr->topicStats.at(_topic);
-  return std::nullopt;
+  return this->pubRing.Size() + this->pubQueueSize;
 }
 
-//////////////////////////////////////////////////
-void NodeShared::EnableStats(const std::string &_topic, bool _enable,
-    std::function<void(const TopicStatistics &_stats)> _statCb)
+/////////////////////////////////////////////////
+void NodeSharedPrivate::PublicationAdded()
 {
-  if (_enable)
+  const uint64_t depth = this->PubQueueDepth();
+  uint64_t highWater = this->pubHighWater.load(std::memory_order_relaxed);
+  while (depth > highWater &&
+         !this->pubHighWater.compare_exchange_weak(highWater, depth,
+           std::memory_order_relaxed))
   {
-    this->dataPtr->enabledTopicStatistics.insert({_topic, _statCb});
   }
-  else
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (this->pubThreadParked)
   {
-    this->dataPtr->enabledTopicStatistics.extract(_topic);
-    // \todo Also cleanup topicStats.
+    std::lock_guard<std::mutex> lk(this->pubThreadMutex);
+    this->signalNewPub.notify_one();
+  }
+}
+
+/////////////////////////////////////////////////
+void NodeSharedPrivate::EnqueuePublication(PublishMsgDetails &&_details,
+    const AdvertiseMessageOptions &_opts)
+{
+  const uint64_t queueDepth = _opts.LocalQueueDepth();
+
+  // Fast path, without locks.
+  if (queueDepth == 0 && this->pubOverflow == 0 &&
+      this->pubRing.TryPush(std::move(_details)))
+  {
+    this->PublicationAdded();
+    return;
   }
+
+  std::unique_lock<std::mutex> lk(this->pubThreadMutex);
+
+  if (queueDepth > 0)
+  {
+    const std::string &topic = _details.topic;
+    auto full = [&]()
+    {
+      auto depth = this->pubQueueDepths.find(topic);
+      return depth != this->pubQueueDepths.end() &&
+        depth->second >= queueDepth;
+    };
+
+    if (full())
+    {
+      switch (_opts.Overflow())
+      {
+        case OverflowPolicy::DROP_OLDEST:
+        {
+          for (auto it = this->pubQueue.begin(); it != this->pubQueue.end();
+               ++it)
+          {
+            if (it->bounded && it->topic == topic)
+            {
+              this->RecordDrops(topic, it->samples.size());
+              this->pubQueue.erase(it);
+              --this->pubQueueSize;
+              --this->pubQueueDepths[topic];
+              break;
+            }
+          }
+          break;
+        }
+        case OverflowPolicy::BLOCK:
+        {
+          if (this->signalPubQueueSpace.wait_for(lk, _opts.BlockTimeout(),
+                [&]{return !full() || this->exit;}) && !this->exit)
+          {
+            break;
+          }
+          [[fallthrough]];
+        }
+        case OverflowPolicy::DROP_NEWEST:
+        default:
+        {
+          this->RecordDrops(topic, _details.samples.size());
+          return;
+        }
+      }
+    }
+
+    _details.bounded = true;
+    ++this->pubQueueDepths[topic];
+  }
+  else
+  {
+    ++this->pubOverflow;
+  }
+
+  this->pubQueue.push_back(std::move(_details));
+  ++this->pubQueueSize;
+  lk.unlock();
+
+  this->PublicationAdded();
+}
+
+/////////////////////////////////////////////////
+bool NodeSharedPrivate::Queued(const SubscribeOptions &_opts,
+    const bool _intraProcess)
+{
+  // The queue depth only applies to messages from other processes, the
+  // publishers in this process apply their own queue depth.
+  return _opts.KeepLast() > 0 || (!_intraProcess && _opts.QueueDepth() > 0);
+}
+
+/////////////////////////////////////////////////
+thread_local std::vector<const SubscriptionHandlerBase *>
+  NodeSharedPrivate::activeHandlers;
+
+/////////////////////////////////////////////////
+bool NodeSharedPrivate::RunsInline(const SubscriptionHandlerBase &_handler)
+{
+  const SubscribeOptions &opts = _handler.Options();
+  if (!opts.InlineDelivery() || Queued(opts, true))
+    return false;
+
+  return activeHandlers.size() < kMaxInlineDepth &&
+    std::find(activeHandlers.begin(), activeHandlers.end(), &_handler) ==
+      activeHandlers.end();
+}
+
+/////////////////////////////////////////////////
+CallbackExecutor &NodeSharedPrivate::QueueExecutor()
+{
+  std::call_once(this->queueExecutorOnce, [this]()
+    {
+      this->queueExecutor =
+        std::make_unique<CallbackExecutor>(this->queueThreads);
+      this->queueExecutorCreated = true;
+    });
+  return *this->queueExecutor;
+}
+
+/////////////////////////////////////////////////
+void NodeSharedPrivate::EnqueueReceived(const std::string &_topic,
+    const ISubscriptionHandlerPtr &_localHandler,
+    const RawSubscriptionHandlerPtr &_rawHandler,
+    QueuedMsg &&_msg)
+{
+  const SubscriptionHandlerBase &handler = _localHandler ?
+    static_cast<const SubscriptionHandlerBase &>(*_localHandler) :
+    static_cast<const SubscriptionHandlerBase &>(*_rawHandler);
+  const SubscribeOptions &opts = handler.Options();
+
+  // Keep last replaces the oldest message, which is not a drop.
+  const bool keepLast = opts.KeepLast() > 0;
+  const uint64_t queueDepth = keepLast ? opts.KeepLast() : opts.QueueDepth();
+  const OverflowPolicy overflow =
+    keepLast ? OverflowPolicy::DROP_OLDEST : opts.Overflow();
+
+  // The pending tasks of the strand are the queue of the subscription.
+  std::size_t dropped = 0;
+  this->QueueExecutor().Post(
+    LocalStrand(_topic, handler.NodeUuid(), handler.HandlerUuid()),
+    [_localHandler, _rawHandler, msg = std::move(_msg)]()
+    {
+      if (_rawHandler)
+      {
+        RunRawCallback(*_rawHandler, msg.buffer.get(), msg.size, msg.info);
+      }
+      else if (msg.msg)
+      {
+        RunLocalCallback(*_localHandler, msg.msg, msg.info);
+      }
+      else
+      {
+        // Deserialize only the messages that survived in the queue.
+        auto received = _localHandler->CreateMsg(msg.buffer.get(), msg.size,
+          msg.info.Type());
+        if (received)
+          RunLocalCallback(*_localHandler, received, msg.info);
+      }
+    },
+    static_cast<std::size_t>(queueDepth), overflow, opts.BlockTimeout(),
+    dropped);
+
+  if (!keepLast && dropped > 0)
+    this->RecordDrops(_topic, dropped);
+}
+
+/////////////////////////////////////////////////
+void NodeSharedPrivate::RemoveSubscriptionQueues(const std::string &_topic,
+    const std::string &_nUuid)
+{
+  const std::string prefix = LocalStrand(_topic, _nUuid, "");
+  if (this->queueExecutorCreated)
+    this->queueExecutor->Discard(prefix);
+
+  if (this->localExecutor)
+    this->localExecutor->Discard(prefix);
+}
+
+//////////////////////////////////////////////////
+NodeSharedPrivate::HandlerSnapshot NodeSharedPrivate::CheckHandlerSnapshot(
+  const NodeShared &_shared, const InternedTopic *_topic)
+{
+  HandlerSnapshot info;
+
+  // The snapshots are read without the mutex.
+  info.localHandlers = _shared.localSubscribers.normal.Snapshot(_topic);
+  info.haveLocal = info.localHandlers != nullptr;
+
+  info.rawHandlers = _shared.localSubscribers.raw.Snapshot(_topic);
+  info.haveRaw = info.rawHandlers != nullptr;
+
+  return info;
+}
+
+//////////////////////////////////////////////////
+NodeSharedPrivate::SubscriberSnapshot
+NodeSharedPrivate::CheckSubscriberSnapshot(const NodeShared &_shared,
+  const InternedTopic &_topic, const std::string &_msgType) const
+{
+  SubscriberSnapshot info;
+
+  info.localHandlers = _shared.localSubscribers.normal.Snapshot(&_topic);
+  info.haveLocal = info.localHandlers != nullptr;
+
+  info.rawHandlers = _shared.localSubscribers.raw.Snapshot(&_topic);
+  info.haveRaw = info.rawHandlers != nullptr;
+
+  std::lock_guard<std::recursive_mutex> lk(_shared.mutex);
+
+  const std::string &topic = _topic.fullyQualified;
+  info.haveRemote = _shared.remoteSubscribers.HasTopic(topic, _msgType);
+
+  auto formats = this->remoteWireFormats.find(topic);
+  if (info.haveRemote && formats != this->remoteWireFormats.end())
+    info.remoteCodecs = formats->second.codecs;
+
+  return info;
+}
+
+//////////////////////////////////////////////////
+void NodeSharedPrivate::TriggerCallbacks(const MessageInfo &_info,
+    const char *_msgData, const std::size_t _size,
+    const HandlerSnapshot &_handlerInfo, zmq::message_t *_frame)
+{
+  if (!_handlerInfo.haveLocal && !_handlerInfo.haveRaw)
+    return;
+
+  // Handlers are matched by interned type. The type of the message is
+  // interned when its publisher or connection is registered, otherwise the
+  // names are compared.
+  const std::string *typeId = _info.TypeId();
+  auto accepts = [&](SubscriptionHandlerBase &_handler)
+  {
+    return typeId ? _handler.AcceptsType(typeId) :
+                    _handler.AcceptsType(_info.Type());
+  };
+
+  // Message shared by all the queued subscriptions.
+  const char *msgData = _msgData;
+  SharedPayload queuedData;
+  std::string fullyQualifiedTopic;
+  auto queued = [&](const SubscriptionHandlerBase &_handler)
+  {
+    if (!Queued(_handler.Options(), _info.IntraProcess()))
+      return false;
+    if (!queuedData)
+    {
+      if (_frame)
+      {
+        auto frame = std::make_shared<zmq::message_t>(std::move(*_frame));
+        queuedData = SharedPayload(frame, static_cast<char *>(frame->data()));
+
+        // Small messages live inside the zmq::message_t, so they move too.
+        msgData = queuedData.get();
+      }
+      else
+      {
+        queuedData = this->MakeSharedPayload(_size);
+        memcpy(queuedData.get(), _msgData, _size);
+      }
+      fullyQualifiedTopic = "@" + _info.Partition() + "@" + _info.Topic();
+    }
+    return true;
+  };
+
+  if (_handlerInfo.haveRaw)
+  {
+    for (const RawSubscriptionHandlerPtr &rawHandler :
+         *_handlerInfo.rawHandlers)
+    {
+      if (rawHandler)
+      {
+        if (accepts(*rawHandler))
+        {
+          if (queued(*rawHandler))
+          {
+            this->EnqueueReceived(fullyQualifiedTopic, nullptr,
+              rawHandler, {queuedData, _size, nullptr, _info});
+            continue;
+          }
+
+          rawHandler->RunRawCallback(msgData, _size, _info);
+        }
+      }
+      else
+        std::cerr << "Raw subscription handler is NULL" << std::endl;
+    }
+  }
+
+  if (_handlerInfo.haveLocal)
+  {
+    // This will be instantiated by the first suitable handler that we
+    // encounter. If there is no suitable handler, then we can avoid
+    // deserializing the message altogether.
+    std::shared_ptr<ProtoMsg> msg;
+
+    for (const ISubscriptionHandlerPtr &localHandler :
+         *_handlerInfo.localHandlers)
+    {
+      if (localHandler)
+      {
+        if (accepts(*localHandler))
+        {
+          if (queued(*localHandler))
+          {
+            this->EnqueueReceived(fullyQualifiedTopic,
+              localHandler, nullptr, {queuedData, _size, nullptr, _info});
+            continue;
+          }
+
+          if (!msg)
+          {
+            // If the message has not been deserialized yet, do it now since
+            // we have allegedly found a subscriber which should be able to
+            // do it.
+            msg = localHandler->CreateMsg(msgData, _size, _info.Type());
+
+            if (!msg)
+            {
+              // If the message could not be created, then none of the
+              // handlers in this process will be able to create it, because
+              // protobuf has access to all message types that the current
+              // process is linked to. If CreateMsg(~,~) fails, then we may
+              // as well quit.
+              return;
+            }
+          }
+
+          localHandler->RunLocalCallback(msg, _info);
+        }
+      }
+      else
+        std::cerr << "Local subscription handler is NULL" << std::endl;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void NodeSharedPrivate::RecordDrops(const std::string &_topic,
+    const uint64_t _count)
+{
+  if (_count == 0)
+    return;
+
+  std::lock_guard<std::mutex> lk(this->droppedMsgsMutex);
+  this->droppedMsgs[_topic] += _count;
+}
+
+//////////////////////////////////////////////////
+uint64_t NodeShared::DroppedMessages(const std::string &_topic) const
+{
+  std::lock_guard<std::mutex> lk(this->dataPtr->droppedMsgsMutex);
+  auto it = this->dataPtr->droppedMsgs.find(_topic);
+  if (it == this->dataPtr->droppedMsgs.end())
+    return 0;
+  return it->second;
+}
+
+//////////////////////////////////////////////////
+std::optional<transport::TopicStatistics> NodeShared::TopicStats(
+    const std::string &_topic) const
+{
+  std::lock_guard<std::mutex> lk(this->dataPtr->topicStatsMutex);
+  if (this->dataPtr->topicStats.find(_topic) != this->dataPtr->topicStats.end())
+    return this->dataPtr->topicStats.at(_topic);
+  return std::nullopt;
+}
+
+//////////////////////////////////////////////////
+void NodeShared::EnableStats(const std::string &_topic, bool _enable,
+    std::function<void(const TopicStatistics &_stats)> _statCb)
+{
+  std::lock_guard<std::mutex> lk(this->dataPtr->topicStatsMutex);
+  if (_enable)
+  {
+    this->dataPtr->enabledTopicStatistics.insert({_topic, _statCb});
+  }
+  else
+  {
+    this->dataPtr->enabledTopicStatistics.extract(_topic);
+    // \todo Also cleanup topicStats.
+  }
+}
+
+//////////////////////////////////////////////////
+void NodeSharedPrivate::UpdateTopicStats(const std::string &_topic,
+    const std::string &_sender, const uint64_t _stamp, const uint64_t _seq)
+{
+  std::function<void(const TopicStatistics &_stats)> statCb;
+  std::optional<TopicStatistics> stats;
+  {
+    std::lock_guard<std::mutex> lk(this->topicStatsMutex);
+    auto enabled = this->enabledTopicStatistics.find(_topic);
+    if (enabled == this->enabledTopicStatistics.end())
+      return;
+
+    TopicStatistics &topicStats = this->topicStats[_topic];
+    topicStats.Update(_sender, _stamp, _seq);
+    statCb = enabled->second;
+    stats.emplace(topicStats);
+  }
+
+  if (statCb)
+    statCb(*stats);
+}
+
+//////////////////////////////////////////////////
+void NodeSharedPrivate::SendMsgFrames(zmq::socket_t &_socket,
+    const std::string &_topic, const std::string &_address,
+    zmq::message_t &_payload, zmq::message_t *_compressed,
+    const std::string &_msgType)
+{
+  // Choose the formats requested by the remote subscribers.
+  bool sendRegular = true;
+  bool sendRouted = false;
+  uint64_t compactId = 0;
+  uint32_t codecs = 0;
+  auto formats = this->remoteWireFormats.find(_topic);
+  if (formats != this->remoteWireFormats.end())
+  {
+    sendRegular = formats->second.legacy;
+    sendRouted = formats->second.routed;
+    codecs = formats->second.codecs;
+    if (!formats->second.compactIds.empty())
+    {
+      const uint64_t topicId = CompactHeader::TopicId(_topic, _msgType);
+      if (formats->second.compactIds.count(topicId) > 0)
+        compactId = topicId;
+      else
+        sendRegular = true;
+    }
+  }
+
+  // The compressed copy is only sent if all the subscribers that accept
+  // compressed messages decode its codec. The subscribers might have
+  // changed since the message was compressed.
+  Compression_t codec = Compression_t::NONE;
+  if (_compressed)
+  {
+    codec = static_cast<Compression_t>(
+      static_cast<const char *>(_compressed->data())[1]);
+    if (!(codecs & codecMask(codec)))
+    {
+      codec = Compression_t::NONE;
+      _compressed = nullptr;
+    }
+  }
+
+  // Create publication metadata.
+  PublicationMetadata meta;
+  if (this->topicStatsEnabled)
+  {
+    // Send the sequence number, which can be used to detect dropped
+    // messages.
+    meta.seq = this->topicPubSeq[_topic]++;
+    // Send the publication time.
+    meta.stamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  if (compactId != 0)
+  {
+    CompactHeader header;
+    header.topicId = compactId;
+    header.senderId = CompactHeader::SenderId(_address);
+    if (this->topicStatsEnabled)
+    {
+      header.flags |= CompactHeader::kFlagMetadata;
+      header.meta = meta;
+    }
+    if (_compressed)
+      header.flags |= CompactHeader::kFlagCompressed;
+
+    zmq::message_t headerMsg(CompactHeader::kSize);
+    header.Serialize(static_cast<char *>(headerMsg.data()));
+
+    // The payload frame shares the data with the other formats, if any.
+    zmq::message_t payload;
+    payload.copy(_compressed ? *_compressed : _payload);
+
+#ifdef GZ_ZMQ_POST_4_3_1
+    _socket.send(headerMsg, zmq::send_flags::sndmore);
+    _socket.send(payload, zmq::send_flags::none);
+#else
+    _socket.send(headerMsg, ZMQ_SNDMORE);
+    _socket.send(payload, 0);
+#endif
+  }
+
+  if (sendRouted)
+  {
+    zmq::message_t payload;
+    payload.copy(_compressed ? *_compressed : _payload);
+    this->SendRegularFrames(_socket, CodecRoute::Frame(_topic, codec),
+      _address, payload, _msgType, meta);
+  }
+
+  if (sendRegular)
+  {
+    this->SendRegularFrames(_socket, _topic, _address, _payload, _msgType,
+      meta);
+  }
+}
+
+//////////////////////////////////////////////////
+void NodeSharedPrivate::SendRegularFrames(zmq::socket_t &_socket,
+    const std::string &_topic, const std::string &_address,
+    zmq::message_t &_payload, const std::string &_msgType,
+    const PublicationMetadata &_meta)
+{
+  // Create the messages.
+  zmq::message_t msg0(_topic.data(), _topic.size()),
+                 msg1(_address.data(), _address.size()),
+                 msg3(_msgType.data(), _msgType.size());
+
+#ifdef GZ_ZMQ_POST_4_3_1
+  _socket.send(msg0, zmq::send_flags::sndmore);
+  _socket.send(msg1, zmq::send_flags::sndmore);
+  _socket.send(_payload, zmq::send_flags::sndmore);
+#else
+  _socket.send(msg0, ZMQ_SNDMORE);
+  _socket.send(msg1, ZMQ_SNDMORE);
+  _socket.send(_payload, ZMQ_SNDMORE);
+#endif
+
+  if (this->topicStatsEnabled)
+  {
+    zmq::message_t msg4(&_meta, sizeof(_meta));
+#ifdef GZ_ZMQ_POST_4_3_1
+    _socket.send(msg3, zmq::send_flags::sndmore);
+    _socket.send(msg4, zmq::send_flags::none);
+#else
+    _socket.send(msg3, ZMQ_SNDMORE);
+    _socket.send(msg4, 0);
+#endif
+  }
+  else
+  {
+#ifdef GZ_ZMQ_POST_4_3_1
+    _socket.send(msg3, zmq::send_flags::none);
+#else
+    _socket.send(msg3, 0);
+#endif
+  }
+}
+
+//////////////////////////////////////////////////
+void NodeSharedPrivate::UpdateRemoteWireFormats(const std::string &_topic,
+    const TopicStorage<MessagePublisher> &_remoteSubscribers)
+{
+  RemoteWireFormats formats;
+  formats.codecs = ~0u;
+  std::map<std::string, std::vector<MessagePublisher>> subscribers;
+  if (_remoteSubscribers.Publishers(_topic, subscribers))
+  {
+    for (const auto &proc : subscribers)
+    {
+      for (const MessagePublisher &sub : proc.second)
+      {
+        // The subscribers use the codec route when both sides support
+        // compression. See AddCodecSource().
+        if (sub.TopicId() != 0)
+        {
+          formats.compactIds.insert(sub.TopicId());
+          formats.codecs &= sub.Codecs();
+        }
+        else if (sub.Codecs() != 0 && supportedCodecs() != 0)
+        {
+          formats.routed = true;
+          formats.codecs &= sub.Codecs();
+        }
+        else
+        {
+          formats.legacy = true;
+        }
+      }
+    }
+  }
+
+  if (!formats.routed && formats.compactIds.empty())
+    formats.codecs = 0;
+
+  if (!formats.legacy && !formats.routed && formats.compactIds.empty())
+    this->remoteWireFormats.erase(_topic);
+  else
+    this->remoteWireFormats[_topic] = formats;
+}
+
+//////////////////////////////////////////////////
+bool NodeSharedPrivate::AddCompactSource(const MessagePublisher &_pub,
+    SubscriberShard &_shard)
+{
+  if (!this->compactHeaderEnabled || _pub.TopicId() == 0)
+    return false;
+
+  // Fall back to the regular format if the publisher computes the topic
+  // IDs differently.
+  const uint64_t topicId = _pub.TopicId();
+  if (topicId != CompactHeader::TopicId(_pub.Topic(), _pub.MsgTypeName()))
+    return false;
+
+  // A shard receives every message matching its filters from the
+  // publishers that it is connected to, so a topic ID must name the same
+  // topic in all the shards.
+  for (auto &shard : this->subscriberShards)
+  {
+    std::lock_guard<std::mutex> lk(shard->mutex);
+    auto compactTopic = shard->tables.compactTopics.find(topicId);
+    if (compactTopic != shard->tables.compactTopics.end() &&
+        (compactTopic->second.topic != _pub.Topic() ||
+         compactTopic->second.msgType != _pub.MsgTypeName()))
+    {
+      // Topic ID collision.
+      return false;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(_shard.mutex);
+    _shard.tables.compactTopics[topicId] = {_pub.Topic(), _pub.MsgTypeName(),
+      InternTable::Topic(_pub.Topic()),
+      InternTable::String(_pub.MsgTypeName())};
+    _shard.tables.compactSenders[CompactHeader::SenderId(_pub.Addr())] =
+      _pub.Addr();
+  }
+
+  // Publishers of the topic in different lanes use different shards.
+  _shard.SetFilter(CompactHeader::Filter(topicId), true);
+
+  std::lock_guard<std::mutex> lk(_shard.mutex);
+  _shard.tables.compactSources.insert({_pub.Addr(), topicId});
+  return true;
+}
+
+//////////////////////////////////////////////////
+void NodeSharedPrivate::AddCodecSource(const MessagePublisher &_pub,
+    SubscriberShard &_shard)
+{
+  // The publisher announces its compression support when it advertises the
+  // topic.
+  if (_pub.Codecs() == 0 || supportedCodecs() == 0)
+    return;
+
+  for (const std::string &filter : CodecRoute::Filters(_pub.Topic()))
+    _shard.SetFilter(filter, true);
+
+  std::lock_guard<std::mutex> lk(_shard.mutex);
+  _shard.tables.codecSources.insert({_pub.Addr(), _pub.Topic()});
+}
+
+//////////////////////////////////////////////////
+void NodeSharedPrivate::RemoveCompactTopic(const std::string &_topic)
+{
+  for (auto &shard : this->subscriberShards)
+  {
+    std::vector<uint64_t> topicIds;
+    {
+      std::lock_guard<std::mutex> lk(shard->mutex);
+      ReceiveTables &tables = shard->tables;
+      for (auto it = tables.compactTopics.begin();
+           it != tables.compactTopics.end();)
+      {
+        if (it->second.topic != _topic)
+        {
+          ++it;
+          continue;
+        }
+
+        for (auto source = tables.compactSources.begin();
+             source != tables.compactSources.end();)
+        {
+          if (source->second == it->first)
+            source = tables.compactSources.erase(source);
+          else
+            ++source;
+        }
+
+        topicIds.push_back(it->first);
+        it = tables.compactTopics.erase(it);
+      }
+    }
+
+    for (const uint64_t topicId : topicIds)
+      shard->SetFilter(CompactHeader::Filter(topicId), false);
+  }
+}
+
+//////////////////////////////////////////////////
+void NodeSharedPrivate::RemovePublisherSources(const MessagePublisher &_pub,
+    const TopicStorage<MessagePublisher> &_connections)
+{
+  const std::string &addr = _pub.Addr();
+
+  // Another node of the process might still publish the topic.
+  MsgAddresses_M info;
+  bool connected = false;
+  if (_connections.Publishers(_pub.Topic(), info))
+  {
+    for (auto const &proc : info)
+    {
+      for (auto const &pub : proc.second)
+        connected = connected || pub.Addr() == addr;
+    }
+  }
+
+  const bool gone = !_connections.HasPublisher(addr);
+  if (connected && !gone)
+    return;
+
+  const uint64_t topicId =
+    CompactHeader::TopicId(_pub.Topic(), _pub.MsgTypeName());
+  for (auto &shard : this->subscriberShards)
+  {
+    std::lock_guard<std::mutex> lk(shard->mutex);
+    if (!connected)
+    {
+      shard->tables.compactSources.erase({addr, topicId});
+      shard->tables.codecSources.erase({addr, _pub.Topic()});
+    }
+
+    if (gone)
+      shard->tables.compactSenders.erase(CompactHeader::SenderId(addr));
+  }
+}
+
+//////////////////////////////////////////////////
+NodeSharedPrivate::SubscriberShard &NodeSharedPrivate::Shard(
+    const std::string &_topic, const Priority_t _priority)
+{
+  switch (_priority)
+  {
+    case Priority_t::REALTIME:
+      return *this->subscriberShards[this->numHashedShards];
+    case Priority_t::BULK:
+      return *this->subscriberShards[this->numHashedShards + 1];
+    case Priority_t::NORMAL:
+    default:
+      break;
+  }
+
+  if (this->numHashedShards == 1)
+    return *this->subscriberShards[0];
+
+  // 64-bit FNV-1a, which doesn't change between processes and runs.
+  const uint64_t hash = CompactHeader::TopicId(_topic, "");
+  return *this->subscriberShards[hash % this->numHashedShards];
+}
+
+//////////////////////////////////////////////////
+void NodeSharedPrivate::RemoveTopicFilters(const std::string &_topic)
+{
+  this->RemoveCompactTopic(_topic);
+
+  for (auto &shard : this->subscriberShards)
+  {
+    std::lock_guard<std::mutex> lk(shard->mutex);
+    shard->tables.topics.erase(_topic);
+
+    std::set<std::pair<std::string, std::string>> &sources =
+      shard->tables.codecSources;
+    for (auto source = sources.begin(); source != sources.end();)
+    {
+      if (source->second == _topic)
+        source = sources.erase(source);
+      else
+        ++source;
+    }
+  }
+
+  auto shards = this->topicShards.find(_topic);
+  if (shards == this->topicShards.end())
+    return;
+
+  const std::vector<std::string> routeFilters = CodecRoute::Filters(_topic);
+  for (SubscriberShard *shard : shards->second)
+  {
+    shard->SetFilter(_topic, false);
+    for (const std::string &filter : routeFilters)
+      shard->SetFilter(filter, false);
+  }
+  this->topicShards.erase(shards);
+}
+
+//////////////////////////////////////////////////
+void NodeSharedPrivate::SubscriberShard::SetFilter(const std::string &_filter,
+    const bool _subscribe)
+{
+  std::lock_guard<std::mutex> lk(this->mutex);
+  if (_subscribe ? !this->filters.insert(_filter).second :
+                   this->filters.erase(_filter) == 0)
+  {
+    return;
+  }
+
+#ifdef GZ_CPPZMQ_POST_4_7_0
+  if (_subscribe)
+    this->socket.set(zmq::sockopt::subscribe, _filter);
+  else
+    this->socket.set(zmq::sockopt::unsubscribe, _filter);
+#else
+  this->socket.setsockopt(_subscribe ? ZMQ_SUBSCRIBE : ZMQ_UNSUBSCRIBE,
+    _filter.data(), _filter.size());
+#endif
+}
+
+//////////////////////////////////////////////////
+NodeSharedPrivate::PublisherLane *NodeSharedPrivate::Lane(
+    const Priority_t _priority, const std::string &_hostAddr)
+{
+  if (_priority == Priority_t::NORMAL)
+    return nullptr;
+
+  auto it = this->publisherLanes.find(_priority);
+  if (it != this->publisherLanes.end())
+    return it->second.socket ? &it->second : nullptr;
+
+  // Only one attempt is made. On failure the lane falls back to the
+  // publisher socket, which is also the address announced in discovery.
+  PublisherLane &lane = this->publisherLanes[_priority];
+  try
+  {
+    auto socket = std::make_unique<zmq::socket_t>(*this->context, ZMQ_PUB);
+    this->SecurityInitPublisher(*socket);
+
+    int lingerVal = 0;
+    const std::string anyTcpEp = "tcp://" + _hostAddr + ":*";
+#ifdef GZ_CPPZMQ_POST_4_7_0
+    socket->set(zmq::sockopt::linger, lingerVal);
+    socket->set(zmq::sockopt::sndhwm, this->sndHwm);
+    socket->bind(anyTcpEp.c_str());
+    lane.address = socket->get(zmq::sockopt::last_endpoint);
+#else
+    socket->setsockopt(ZMQ_LINGER, &lingerVal, sizeof(lingerVal));
+    socket->setsockopt(ZMQ_SNDHWM, &this->sndHwm, sizeof(this->sndHwm));
+    socket->bind(anyTcpEp.c_str());
+    char bindEndPoint[1024];
+    size_t size = sizeof(bindEndPoint);
+    socket->getsockopt(ZMQ_LAST_ENDPOINT, &bindEndPoint, &size);
+    lane.address = bindEndPoint;
+#endif
+    lane.socket = std::move(socket);
+  }
+  catch(const zmq::error_t &_error)
+  {
+    std::cerr << "Unable to create the publisher socket of a priority lane: "
+              << _error.what() << std::endl;
+    return nullptr;
+  }
+
+  return &lane;
+}
+
+//////////////////////////////////////////////////
+void CompactHeader::Serialize(char *_buffer) const
+{
+  char *p = _buffer;
+  *p++ = kMarker;
+  p = writeLittleEndian(p, this->topicId);
+  *p++ = static_cast<char>(kVersion);
+  *p++ = static_cast<char>(this->flags);
+  p = writeLittleEndian(p, this->senderId);
+  p = writeLittleEndian(p, this->meta.seq);
+  writeLittleEndian(p, this->meta.stamp);
+}
+
+//////////////////////////////////////////////////
+bool CompactHeader::Parse(const char *_buffer, const std::size_t _size)
+{
+  if (_size != kSize || !IsCompact(_buffer, _size))
+    return false;
+
+  const char *p = readLittleEndian(_buffer + 1, this->topicId);
+  if (static_cast<uint8_t>(*p++) != kVersion)
+    return false;
+  this->flags = static_cast<uint8_t>(*p++);
+  p = readLittleEndian(p, this->senderId);
+  p = readLittleEndian(p, this->meta.seq);
+  readLittleEndian(p, this->meta.stamp);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool CompactHeader::IsCompact(const char *_buffer, const std::size_t _size)
+{
+  return _size > 0 && _buffer[0] == kMarker;
+}
+
+//////////////////////////////////////////////////
+std::string CompactHeader::Filter(const uint64_t _topicId)
+{
+  std::string filter(1 + sizeof(_topicId), kMarker);
+  writeLittleEndian(&filter[1], _topicId);
+  return filter;
+}
+
+//////////////////////////////////////////////////
+uint64_t CompactHeader::TopicId(const std::string &_topic,
+    const std::string &_msgType)
+{
+  // 64-bit FNV-1a of the topic and the type, separated by a null character.
+  uint64_t hash = 14695981039346656037ull;
+  auto mix = [&hash](const std::string &_str)
+  {
+    for (const char c : _str)
+    {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 1099511628211ull;
+    }
+  };
+  mix(_topic);
+  hash *= 1099511628211ull;
+  mix(_msgType);
+
+  // 0 means that the compact header is not supported.
+  return hash != 0 ? hash : 1;
+}
+
+//////////////////////////////////////////////////
+uint64_t CompactHeader::SenderId(const std::string &_address)
+{
+  return TopicId(_address, "");
+}
+
+//////////////////////////////////////////////////
+std::string CodecRoute::Frame(const std::string &_topic,
+    const Compression_t _codec)
+{
+  if (_codec == Compression_t::NONE)
+    return kUncompressed + _topic;
+
+  std::string frame(1, kCompressed);
+  frame += static_cast<char>(_codec);
+  return frame + _topic;
+}
+
+//////////////////////////////////////////////////
+std::vector<std::string> CodecRoute::Filters(const std::string &_topic)
+{
+  std::vector<std::string> filters = {Frame(_topic, Compression_t::NONE)};
+  for (const Compression_t codec : {Compression_t::LZ4, Compression_t::ZSTD})
+  {
+    if (supportedCodecs() & codecMask(codec))
+      filters.push_back(Frame(_topic, codec));
+  }
+  return filters;
+}
+
+//////////////////////////////////////////////////
+bool CodecRoute::Parse(std::string &_topic, bool &_compressed)
+{
+  if (!_topic.empty() && _topic[0] == kUncompressed)
+  {
+    _compressed = false;
+    _topic.erase(0, 1);
+    return true;
+  }
+
+  if (_topic.size() > 1 && _topic[0] == kCompressed)
+  {
+    _compressed = true;
+    _topic.erase(0, 2);
+    return true;
+  }
+
+  return false;
+}
+
+//////////////////////////////////////////////////
+NodeSharedPrivate::SharedPayload NodeSharedPrivate::MakeSharedPayload(
+    std::size_t _size)
+{
+  BufferPool *pool = &this->bufferPool;
+  return SharedPayload(pool->Acquire(_size), [pool](char *_buffer)
+  {
+    pool->Release(_buffer);
+  });
+}
+
+//////////////////////////////////////////////////
+void NodeSharedPrivate::ReleaseSharedPayload(void * /*_data*/, void *_hint)
+{
+  delete static_cast<SharedPayload *>(_hint);
 }
 
 /////////////////////////////////////////////////
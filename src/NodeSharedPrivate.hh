@@ -20,15 +20,35 @@
 
 #include <zmq.hpp>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
-#include <queue>
+#include <mutex>
+#include <set>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include "gz/transport/BufferPool.hh"
+#include "gz/transport/Compression.hh"
 #include "gz/transport/Discovery.hh"
+#include "gz/transport/InternTable.hh"
 #include "gz/transport/Node.hh"
+#include "gz/transport/WakeupChannel.hh"
+
+#include "CallbackExecutor.hh"
+#include "ConnectionMonitor.hh"
+#include "MpscRing.hh"
+#include "TopicPatternTrie.hh"
 
 namespace gz
 {
@@ -48,26 +68,316 @@ namespace gz
       public: uint64_t seq = 0;
     };
 
+    /// \brief Fixed-size binary header that replaces the topic, address,
+    /// type and metadata frames of a message when the publisher and the
+    /// subscriber agreed on a topic ID during discovery. A message in this
+    /// format has two frames: the header and the payload.
+    ///
+    /// The header starts with kMarker followed by the topic ID, so this
+    /// prefix is used as ZMQ subscription filter. A topic name never starts
+    /// with kMarker, so subscribers using the regular format never receive
+    /// these messages. The integers are serialized in little-endian byte
+    /// order, so the filter matches across platforms.
+    class CompactHeader
+    {
+      /// \brief First byte of the header.
+      public: inline static const char kMarker = '\0';
+
+      /// \brief Version of the header layout.
+      public: inline static const uint8_t kVersion = 1;
+
+      /// \brief Flag set when the publication metadata is valid.
+      public: inline static const uint8_t kFlagMetadata = 0x01;
+
+      /// \brief Flag set when the payload is compressed.
+      public: inline static const uint8_t kFlagCompressed = 0x02;
+
+      /// \brief Size of a serialized header (bytes): marker, topic ID,
+      /// version, flags, sender ID, sequence number and timestamp.
+      public: inline static const std::size_t kSize =
+        1 + 8 + 1 + 1 + 8 + 8 + 8;
+
+      /// \brief Serialize the header.
+      /// \param[out] _buffer Buffer with room for kSize bytes.
+      public: void Serialize(char *_buffer) const;
+
+      /// \brief Parse a header.
+      /// \param[in] _buffer Frame data.
+      /// \param[in] _size Frame size (bytes).
+      /// \return True if the frame is a valid header.
+      public: bool Parse(const char *_buffer, std::size_t _size);
+
+      /// \brief Check whether a frame has the compact header layout.
+      /// \param[in] _buffer Frame data.
+      /// \param[in] _size Frame size (bytes).
+      /// \return True if the frame starts with kMarker.
+      public: static bool IsCompact(const char *_buffer, std::size_t _size);
+
+      /// \brief Get the ZMQ subscription filter of a topic ID.
+      /// \param[in] _topicId Topic ID.
+      /// \return The filter.
+      public: static std::string Filter(uint64_t _topicId);
+
+      /// \brief Compute the topic ID of a topic and message type pair.
+      /// \param[in] _topic Fully qualified topic name.
+      /// \param[in] _msgType Message type name.
+      /// \return The topic ID, never 0.
+      public: static uint64_t TopicId(const std::string &_topic,
+                                      const std::string &_msgType);
+
+      /// \brief Compute the sender ID of a publisher address.
+      /// \param[in] _address ZMQ address of the publisher.
+      /// \return The sender ID.
+      public: static uint64_t SenderId(const std::string &_address);
+
+      /// \brief Topic ID.
+      public: uint64_t topicId = 0;
+
+      /// \brief Sender ID.
+      public: uint64_t senderId = 0;
+
+      /// \brief Combination of flags.
+      public: uint8_t flags = 0;
+
+      /// \brief Publication metadata. Valid if kFlagMetadata is set.
+      public: PublicationMetadata meta;
+    };
+
+    /// \brief Prefixes of the topic frame of the messages sent in the
+    /// regular format to the subscribers that decode compressed messages.
+    /// A compressed message is sent with kCompressed followed by its codec,
+    /// so it only reaches the subscribers that decode that codec. The other
+    /// messages are sent with kUncompressed. A topic name never starts with
+    /// these bytes, so subscribers without compression support never
+    /// receive these messages.
+    class CodecRoute
+    {
+      /// \brief First byte of the topic frame of a compressed message.
+      public: inline static const char kCompressed = '\x01';
+
+      /// \brief First byte of the topic frame of an uncompressed message.
+      public: inline static const char kUncompressed = '\x02';
+
+      /// \brief Get the topic frame of a message, which is also its ZMQ
+      /// subscription filter.
+      /// \param[in] _topic Fully qualified topic name.
+      /// \param[in] _codec Codec of the payload or NONE if uncompressed.
+      /// \return The topic frame.
+      public: static std::string Frame(const std::string &_topic,
+                                       Compression_t _codec);
+
+      /// \brief Get the filters of all the messages of a topic that this
+      /// process can decode.
+      /// \param[in] _topic Fully qualified topic name.
+      /// \return The filters.
+      public: static std::vector<std::string> Filters(
+        const std::string &_topic);
+
+      /// \brief Remove the prefix of a received topic frame.
+      /// \param[in, out] _topic Topic frame, replaced by the topic name if
+      /// it has a prefix.
+      /// \param[out] _compressed True if the payload is compressed.
+      /// \return True if the frame has a prefix.
+      public: static bool Parse(std::string &_topic, bool &_compressed);
+    };
+
     //
     // Private data class for NodeShared.
     class NodeSharedPrivate
     {
+      /// \brief Forward declaration, see below.
+      public: struct SubscriberShard;
+
       // Constructor
       public: NodeSharedPrivate() :
                 context(new zmq::context_t(1)),
                 publisher(new zmq::socket_t(*context, ZMQ_PUB)),
-                subscriber(new zmq::socket_t(*context, ZMQ_SUB)),
                 requester(new zmq::socket_t(*context, ZMQ_ROUTER)),
                 responseReceiver(new zmq::socket_t(*context, ZMQ_ROUTER)),
                 replier(new zmq::socket_t(*context, ZMQ_ROUTER))
       {
+        this->numHashedShards = static_cast<std::size_t>(std::max(1,
+          this->NonNegativeEnvVar("GZ_TRANSPORT_RECEPTION_SHARDS", 1)));
+        for (std::size_t i = 0; i < this->numHashedShards; ++i)
+        {
+          this->subscriberShards.push_back(std::make_unique<SubscriberShard>(
+            *this->context, i, Priority_t::NORMAL));
+        }
+
+        // The shards of the priority lanes go after the hashed shards.
+        for (Priority_t priority : {Priority_t::REALTIME, Priority_t::BULK})
+        {
+          this->subscriberShards.push_back(std::make_unique<SubscriberShard>(
+            *this->context, this->subscriberShards.size(), priority));
+        }
       }
 
+      /// \brief Serialized message shared between the local raw handlers and
+      /// the zero-copy ZMQ frame sent to the remote subscribers.
+      public: using SharedPayload = std::shared_ptr<char>;
+
+      /// \brief Create a payload backed by a buffer of the bufferPool. The
+      /// buffer returns to the pool when the last reference is released.
+      /// \param[in] _size Payload size (bytes).
+      /// \return The new payload.
+      public: SharedPayload MakeSharedPayload(std::size_t _size);
+
+      /// \brief Deallocation function passed to ZMQ for frames that
+      /// reference a SharedPayload.
+      /// \param[in] _data Pointer to the payload data (unused).
+      /// \param[in] _hint Heap allocated SharedPayload holding the reference
+      /// owned by ZMQ.
+      public: static void ReleaseSharedPayload(void *_data, void *_hint);
+
+      /// \brief Buffer handed over to the transport, held until a
+      /// zmq::message_t takes ownership of it, so it is released even if
+      /// the message can't be created. Ownership is tracked separately from
+      /// the pointer, so a null buffer with a deallocation function is
+      /// released too.
+      public: class OwnedBuffer
+              {
+                /// \brief Constructor.
+                /// \param[in] _data The buffer.
+                /// \param[in] _ffn Deallocation function, or nullptr if the
+                /// buffer is not owned.
+                /// \param[in] _hint Second argument of the deallocation
+                /// function.
+                public: OwnedBuffer(char *_data, DeallocFunc *_ffn,
+                                    void *_hint)
+                  : data(_data), ffn(_ffn), hint(_hint)
+                {
+                }
+
+                /// \brief Destructor. Releases the buffer if still owned.
+                public: ~OwnedBuffer()
+                {
+                  if (this->ffn)
+                    this->ffn(this->data, this->hint);
+                }
+
+                /// \brief No copy.
+                public: OwnedBuffer(const OwnedBuffer &) = delete;
+
+                /// \brief No copy.
+                public: OwnedBuffer &operator=(const OwnedBuffer &) = delete;
+
+                /// \brief Get the buffer.
+                /// \return The buffer, which may be nullptr.
+                public: char *Get() const
+                {
+                  return this->data;
+                }
+
+                /// \brief Whether the buffer is still owned.
+                /// \return True if the buffer will be released here.
+                public: bool Owned() const
+                {
+                  return this->ffn != nullptr;
+                }
+
+                /// \brief Give up ownership of the buffer.
+                /// \return The buffer.
+                public: char *Release()
+                {
+                  this->ffn = nullptr;
+                  return this->data;
+                }
+
+                /// \brief The buffer.
+                private: char *data = nullptr;
+
+                /// \brief Deallocation function, or nullptr if the buffer
+                /// is not owned.
+                private: DeallocFunc *ffn = nullptr;
+
+                /// \brief Second argument of the deallocation function.
+                private: void *hint = nullptr;
+              };
+
+      /// \brief Send the frames of a message through a publisher socket.
+      /// The caller must hold the NodeShared mutex.
+      /// \param[in] _socket Publisher socket.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _address Address of the publisher socket.
+      /// \param[in, out] _payload Serialized message data.
+      /// \param[in, out] _compressed Compressed copy of the payload or
+      /// nullptr. It is only sent to the subscribers that decode it.
+      /// \param[in] _msgType Message type name.
+      /// \throws zmq::error_t on failure.
+      public: void SendMsgFrames(zmq::socket_t &_socket,
+                                 const std::string &_topic,
+                                 const std::string &_address,
+                                 zmq::message_t &_payload,
+                                 zmq::message_t *_compressed,
+                                 const std::string &_msgType);
+
+      /// \brief Send the frames of a message in the regular format: topic,
+      /// address, payload, type and, with topic statistics, metadata. The
+      /// caller must hold the NodeShared mutex.
+      /// \param[in] _socket Publisher socket.
+      /// \param[in] _topic Topic frame.
+      /// \param[in] _address Address of the publisher socket.
+      /// \param[in, out] _payload Payload frame.
+      /// \param[in] _msgType Message type name.
+      /// \param[in] _meta Publication metadata.
+      /// \throws zmq::error_t on failure.
+      public: void SendRegularFrames(zmq::socket_t &_socket,
+                                     const std::string &_topic,
+                                     const std::string &_address,
+                                     zmq::message_t &_payload,
+                                     const std::string &_msgType,
+                                     const PublicationMetadata &_meta);
+
+      /// \brief Update the wire formats requested by the remote subscribers
+      /// of a topic. Call it after changing the remote subscribers. The
+      /// caller must hold the NodeShared mutex.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _remoteSubscribers Remote subscribers.
+      public: void UpdateRemoteWireFormats(const std::string &_topic,
+        const TopicStorage<MessagePublisher> &_remoteSubscribers);
+
+      /// \brief Start receiving the messages of a remote publisher with
+      /// the compact header, if both sides support it. The caller must hold
+      /// the NodeShared mutex.
+      /// \param[in] _pub Remote publisher.
+      /// \param[in] _shard Shard connected to the publisher.
+      /// \return True if the compact header will be used.
+      public: bool AddCompactSource(const MessagePublisher &_pub,
+                                    SubscriberShard &_shard);
+
+      /// \brief Start receiving the messages of a remote publisher on the
+      /// codec route, if both sides support compression. The caller must
+      /// hold the NodeShared mutex.
+      /// \param[in] _pub Remote publisher.
+      /// \param[in] _shard Shard connected to the publisher.
+      public: void AddCodecSource(const MessagePublisher &_pub,
+                                  SubscriberShard &_shard);
+
+      /// \brief Stop receiving a topic with the compact header. The caller
+      /// must hold the NodeShared mutex.
+      /// \param[in] _topic Topic name.
+      public: void RemoveCompactTopic(const std::string &_topic);
+
+      /// \brief Forget the compact header and codec route sources of a
+      /// remote publisher that is gone, so a new publisher reusing its
+      /// address isn't taken as a duplicate. The caller must hold the
+      /// NodeShared mutex.
+      /// \param[in] _pub Remote publisher removed from the connections.
+      /// \param[in] _connections Remaining connections.
+      public: void RemovePublisherSources(const MessagePublisher &_pub,
+        const TopicStorage<MessagePublisher> &_connections);
+
       /// \brief Initialize security
       public: void SecurityInit();
 
+      /// \brief Enable the authentication server of a publisher socket if
+      /// a username and password are set.
+      /// \param[in] _publisher Publisher socket about to bind.
+      public: void SecurityInitPublisher(zmq::socket_t &_publisher);
+
       /// \brief Handle new secure connections
-      public: void SecurityOnNewConnection();
+      /// \param[in] _subscriber Subscriber socket about to connect.
+      public: void SecurityOnNewConnection(zmq::socket_t &_subscriber);
 
       /// \brief Access control handler for plain security.
       /// This function is designed to be run in a thread.
@@ -83,6 +393,11 @@ namespace gz
       public: int NonNegativeEnvVar(const std::string &_envVar,
                                     int _defaultValue) const;
 
+      /// \brief Pool of buffers used to serialize published messages. ZMQ
+      /// returns the buffers to the pool when it is done with them, so the
+      /// pool must be declared before the context to outlive it.
+      public: BufferPool bufferPool;
+
       //////////////////////////////////////////////////
       ///////    Declare here the ZMQ Context    ///////
       //////////////////////////////////////////////////
@@ -98,8 +413,184 @@ namespace gz
       /// \brief ZMQ socket to send topic updates.
       public: std::unique_ptr<zmq::socket_t> publisher;
 
-      /// \brief ZMQ socket to receive topic updates.
-      public: std::unique_ptr<zmq::socket_t> subscriber;
+      /// \brief Publisher socket of a priority lane.
+      public: struct PublisherLane
+              {
+                /// \brief ZMQ socket to send the topic updates of the lane.
+                public: std::unique_ptr<zmq::socket_t> socket;
+
+                /// \brief Address of the socket, announced in discovery
+                /// instead of NodeShared::myAddress.
+                public: std::string address;
+              };
+
+      /// \brief Publisher sockets of the REALTIME and BULK lanes. A lane is
+      /// created when its first topic is advertised. The NORMAL lane uses
+      /// publisher. Protected by the NodeShared mutex.
+      public: std::map<Priority_t, PublisherLane> publisherLanes;
+
+      /// \brief Get the publisher socket of a priority lane, creating it
+      /// if needed. The caller must hold the NodeShared mutex.
+      /// \param[in] _priority Priority class.
+      /// \param[in] _hostAddr Address to bind the socket to.
+      /// \return The lane, or nullptr for Priority_t::NORMAL or if the
+      /// socket can't be created. Then the publisher socket is used.
+      public: PublisherLane *Lane(Priority_t _priority,
+                                  const std::string &_hostAddr);
+
+      /// \brief Send high water mark of the publisher sockets.
+      public: int sndHwm = 0;
+
+      /// \brief Topic and message type received with the compact header.
+      public: struct CompactTopic
+              {
+                /// \brief Topic name.
+                public: std::string topic;
+
+                /// \brief Message type name.
+                public: std::string msgType;
+
+                /// \brief Interned topic.
+                public: const InternedTopic *internedTopic = nullptr;
+
+                /// \brief Interned message type name.
+                public: const std::string *typeId = nullptr;
+              };
+
+      /// \brief Interned names of a topic received in the regular format.
+      public: struct ReceivedTopic
+              {
+                /// \brief Interned topic.
+                public: const InternedTopic *internedTopic = nullptr;
+
+                /// \brief Interned message types of the publishers that the
+                /// shard is connected to.
+                public: std::vector<const std::string *> typeIds;
+              };
+
+      /// \brief Tables used to resolve the names of the messages received by
+      /// a shard and to drop the duplicated messages of the publishers that
+      /// it is connected to. The names are interned when the shard connects
+      /// to a publisher, so the messages are dispatched without looking them
+      /// up in the InternTable.
+      public: struct ReceiveTables
+              {
+                /// \brief Topics subscribed by the shard. The key is the
+                /// topic name.
+                public: std::map<std::string, ReceivedTopic> topics;
+
+                /// \brief Topics received with the compact header. The key
+                /// is the topic ID.
+                public: std::map<uint64_t, CompactTopic> compactTopics;
+
+                /// \brief Publisher address and topic ID pairs received with
+                /// the compact header. Messages from these sources in the
+                /// regular format are duplicates.
+                public: std::set<std::pair<std::string, uint64_t>>
+                  compactSources;
+
+                /// \brief Publisher address and topic name pairs received on
+                /// the codec route. Messages from these sources without the
+                /// route prefix are duplicates.
+                public: std::set<std::pair<std::string, std::string>>
+                  codecSources;
+
+                /// \brief Addresses of the publishers sending the compact
+                /// header. The key is the sender ID.
+                public: std::map<uint64_t, std::string> compactSenders;
+              };
+
+      /// \brief A ZMQ_SUB socket receiving a subset of the remote topics.
+      /// Every topic is received by exactly one shard, so the messages of a
+      /// topic keep their order. See GZ_TRANSPORT_RECEPTION_SHARDS.
+      public: struct SubscriberShard
+              {
+                /// \brief Constructor.
+                /// \param[in] _context ZMQ context.
+                /// \param[in] _index Position in subscriberShards.
+                /// \param[in] _priority Priority lane received by the
+                /// shard.
+                public: SubscriberShard(zmq::context_t &_context,
+                                        std::size_t _index,
+                                        Priority_t _priority)
+                  : socket(_context, ZMQ_SUB),
+                    index(_index),
+                    priority(_priority)
+                {
+                }
+
+                /// \brief Add or remove a subscription filter. ZMQ counts
+                /// repeated subscriptions, so a filter is only added once.
+                /// \param[in] _filter Topic name or compact header filter.
+                /// \param[in] _subscribe True to subscribe, false to
+                /// unsubscribe.
+                public: void SetFilter(const std::string &_filter,
+                                       bool _subscribe);
+
+                /// \brief ZMQ socket to receive topic updates.
+                public: zmq::socket_t socket;
+
+                /// \brief Position in subscriberShards.
+                public: const std::size_t index;
+
+                /// \brief Priority lane received by the shard.
+                public: const Priority_t priority;
+
+                /// \brief Subscription filters of the socket. Protected by
+                /// mutex.
+                public: std::set<std::string> filters;
+
+                /// \brief Protects the socket and the tables. The NodeShared
+                /// mutex can't be locked while holding this mutex.
+                public: std::mutex mutex;
+
+                /// \brief Tables of the publishers connected to the socket.
+                /// They are modified under the NodeShared mutex and mutex,
+                /// and read by the reception thread under mutex only, so
+                /// receiving a message never locks the NodeShared mutex.
+                public: ReceiveTables tables;
+
+                /// \brief Addresses of the publishers that the socket is
+                /// connected to. Protected by the NodeShared mutex.
+                public: std::set<std::string> connected;
+
+                /// \brief Thread receiving the messages of this shard. The
+                /// first shard is received by NodeShared::threadReception
+                /// instead. The threads of the priority lanes start with
+                /// their first connection.
+                public: std::thread thread;
+
+                /// \brief Wakes up the thread of this shard.
+                public: WakeupChannel wakeup;
+              };
+
+      /// \brief Subscriber sockets: numHashedShards shards for the NORMAL
+      /// lane followed by the REALTIME and BULK lanes. The vector doesn't
+      /// change after construction.
+      public: std::vector<std::unique_ptr<SubscriberShard>> subscriberShards;
+
+      /// \brief Number of shards of the NORMAL lane.
+      public: std::size_t numHashedShards = 1;
+
+      /// \brief Shards with a filter for a topic. The key is the topic
+      /// name. Protected by the NodeShared mutex.
+      public: std::map<std::string, std::set<SubscriberShard *>> topicShards;
+
+      /// \brief Get the shard receiving a topic from a publisher. In the
+      /// NORMAL lane, the shard is chosen with a stable hash of the topic
+      /// name, so it doesn't depend on the order in which the topics are
+      /// discovered.
+      /// \param[in] _topic Fully qualified topic name.
+      /// \param[in] _priority Priority lane of the publisher.
+      /// \return The shard.
+      public: SubscriberShard &Shard(const std::string &_topic,
+                                     Priority_t _priority);
+
+      /// \brief Remove the topic, codec route and compact header filters of
+      /// a topic from all the shards. The caller must hold the NodeShared
+      /// mutex.
+      /// \param[in] _topic Fully qualified topic name.
+      public: void RemoveTopicFilters(const std::string &_topic);
 
       /// \brief ZMQ socket for sending service call requests.
       public: std::unique_ptr<zmq::socket_t> requester;
@@ -110,9 +601,49 @@ namespace gz
       /// \brief ZMQ socket to receive service call requests.
       public: std::unique_ptr<zmq::socket_t> replier;
 
+      /// \brief Handshakes of the requester with the responsers. Declared
+      /// after the sockets, so it stops monitoring them before they close.
+      public: std::unique_ptr<ConnectionMonitor> requesterMonitor;
+
+      /// \brief Handshakes of the replier with the requesters.
+      public: std::unique_ptr<ConnectionMonitor> replierMonitor;
+
+      /// \brief Service calls waiting for the handshake with a responser.
+      /// The key is the address of the responser and the values are the
+      /// topic, request type and response type passed to
+      /// NodeShared::SendPendingRemoteReqs(). The caller must hold the
+      /// NodeShared mutex.
+      public: std::unordered_map<std::string,
+        std::set<std::tuple<std::string, std::string, std::string>>>
+        pendingRequests;
+
+      /// \brief Frames of the service responses waiting for the handshake
+      /// with a requester, indexed by the address of the requester. The
+      /// caller must hold the NodeShared mutex.
+      public: std::unordered_map<std::string,
+        std::vector<std::vector<std::string>>> pendingResponses;
+
+      /// \brief Time after which a service peer is considered ready even
+      /// if its handshake was not reported. It matches the fixed delay that
+      /// used to follow every new service connection.
+      public: static constexpr std::chrono::milliseconds
+        kServiceHandshakeTimeout{100};
+
+      /// \brief Polling period of the reception thread while a service
+      /// handshake is pending, to check kServiceHandshakeTimeout.
+      public: static constexpr std::chrono::milliseconds
+        kServiceHandshakePollPeriod{10};
+
       /// \brief Thread the handle access control
       public: std::thread accessControlThread;
 
+      /// \brief Wakes up the reception thread, which otherwise blocks on its
+      /// sockets until they receive data.
+      public: WakeupChannel receptionWakeup;
+
+      /// \brief Wakes up the access control thread.
+      public: WakeupChannel accessControlWakeup;
+
       //////////////////////////////////////////////////
       /////// Declare here the discovery object  ///////
       //////////////////////////////////////////////////
@@ -130,18 +661,15 @@ namespace gz
       /// \brief When true, the reception thread will finish.
       public: std::atomic<bool> exit = false;
 
-      /// \brief Timeout used for receiving messages (ms.).
-      public: inline static const int Timeout = 250;
-
       ////////////////////////////////////////////////////////////////
       /////// The following is for asynchronous publication of ///////
       /////// messages to local subscribers.                    ///////
       ////////////////////////////////////////////////////////////////
 
       /// \brief Encapsulates information needed to publish a message. An
-      /// instance of this class is pushed onto a publish queue, pubQueue, when
-      /// a message is published through Node::Publisher::Publish.
-      /// The pubThread processes the pubQueue in the
+      /// instance of this class is pushed onto the publish ring, pubRing, or
+      /// the publish queue, pubQueue, when a message is published through
+      /// Node::Publisher::Publish. The pubThread processes them in the
       /// NodeSharedPrivate::PublishThread function.
       ///
       /// A producer-consumer mechanism is used to send messages so that
@@ -155,42 +683,419 @@ namespace gz
                 /// \brief All the raw handlers.
                 public: std::vector<RawSubscriptionHandlerPtr> rawHandlers;
 
-                /// \brief Buffer for the raw handlers.
-                public: std::unique_ptr<char[]> sharedBuffer = nullptr;
+                /// \brief A single published message.
+                public: struct Sample
+                        {
+                          /// \brief Buffer for the raw handlers. It may also
+                          /// be referenced by a ZMQ frame in flight to remote
+                          /// subscribers.
+                          public: SharedPayload sharedBuffer = nullptr;
 
-                /// \brief Msg copy for the local handlers.
-                public: std::unique_ptr<ProtoMsg> msgCopy = nullptr;
+                          /// \brief Msg for the local handlers. It is either
+                          /// a copy of the published message or the message
+                          /// shared by the publisher.
+                          public: std::shared_ptr<const ProtoMsg> msgCopy =
+                                    nullptr;
 
-                /// \brief Message size.
-                // cppcheck-suppress unusedStructMember
-                public: std::size_t msgSize = 0;
+                          /// \brief Message size.
+                          // cppcheck-suppress unusedStructMember
+                          public: std::size_t msgSize = 0;
+                        };
+
+                /// \brief Messages to deliver, in publication order. A
+                /// batched publication holds more than one.
+                public: std::vector<Sample> samples;
 
                 /// \brief Information about the topic and type.
                 public: MessageInfo info;
+
+                /// \brief Fully qualified topic name.
+                public: std::string topic;
+
+                /// \brief True if this publication counts towards the
+                /// queue depth of its topic.
+                public: bool bounded = false;
               };
 
-      /// \brief Publish thread used to process the pubQueue.
+      /// \brief Publish thread used to process the pubRing and pubQueue.
       public: std::thread pubThread;
 
-      /// \brief Mutex to protect the pubThread and pubQueue.
+      /// \brief Capacity of the pubRing.
+      public: static constexpr std::size_t kPubRingCapacity = 1024;
+
+      /// \brief Lock-free ring onto which the publications without a queue
+      /// depth are pushed. The pubThread pops them off and sends them to the
+      /// local subscribers.
+      public: MpscRing<PublishMsgDetails> pubRing{kPubRingCapacity};
+
+      /// \brief Mutex to protect the pubQueue. The pubThread also waits
+      /// with it when it parks.
       public: std::mutex pubThreadMutex;
 
-      /// \brief Queue onto which new messages are pushed. The pubThread
-      /// will pop off the messages and send them to local subscribers.
-      public: std::queue<std::unique_ptr<PublishMsgDetails>> pubQueue;
+      /// \brief Queue onto which the publications with a queue depth are
+      /// pushed, as well as the ones that didn't fit in the pubRing.
+      public: std::deque<PublishMsgDetails> pubQueue;
+
+      /// \brief Number of publications in the pubQueue.
+      public: std::atomic<uint64_t> pubQueueSize{0};
+
+      /// \brief Number of publications without a queue depth in the
+      /// pubQueue. While there is any, the new ones go to the pubQueue too,
+      /// so the messages of a publisher stay in order.
+      public: std::atomic<uint64_t> pubOverflow{0};
+
+      /// \brief True while the pubThread waits for new publications.
+      public: std::atomic<bool> pubThreadParked{false};
+
+      /// \brief Maximum number of publications waiting for the pubThread.
+      public: std::atomic<uint64_t> pubHighWater{0};
+
+      /// \brief True if the pubThread takes the next publication from the
+      /// pubQueue. Only used by the pubThread.
+      public: bool pubQueueTurn = false;
+
+      /// \brief Number of bounded publications in the pubQueue per topic.
+      public: std::map<std::string, uint64_t> pubQueueDepths;
 
       /// \brief used to signal when new work is available
       public: std::condition_variable signalNewPub;
 
+      /// \brief Used to signal when a bounded publication leaves the queue.
+      public: std::condition_variable signalPubQueueSpace;
+
+      /// \brief Add a publication to the pubRing, or to the pubQueue
+      /// applying the queue depth and the overflow policy of the publisher.
+      /// \param[in] _details The publication.
+      /// \param[in] _opts Advertise options of the publisher.
+      public: void EnqueuePublication(PublishMsgDetails &&_details,
+        const AdvertiseMessageOptions &_opts);
+
+      /// \brief Get the next publication for the pubThread, parking the
+      /// thread while there is none.
+      /// \param[out] _details The publication.
+      /// \return False on exit.
+      public: bool NextPublication(PublishMsgDetails &_details);
+
+      /// \brief Get the number of publications waiting for the pubThread.
+      /// \return The number of publications.
+      public: uint64_t PubQueueDepth() const;
+
+      /// \brief Update pubHighWater and wake up the pubThread if it is
+      /// parked. Called after adding a publication.
+      public: void PublicationAdded();
+
       /// \brief Handles local publication of messages on the pubQueue.
       public: void PublishThread();
 
+      ////////////////////////////////////////////////////////////////
+      /////// The following is for queued delivery of messages  ///////
+      /////// received from other processes.                    ///////
+      ////////////////////////////////////////////////////////////////
+
+      /// \brief A message waiting in a subscription queue. Only one of
+      /// buffer or msg is set.
+      public: struct QueuedMsg
+              {
+                /// \brief Serialized message published from this process or
+                /// received from another one.
+                public: SharedPayload buffer;
+
+                /// \brief Size of buffer.
+                public: std::size_t size = 0;
+
+                /// \brief Message published from this process.
+                public: std::shared_ptr<const ProtoMsg> msg;
+
+                /// \brief Information about the topic and type.
+                public: MessageInfo info;
+              };
+
+      /// \brief Executor running the callbacks of the subscriptions with a
+      /// queue depth or with keep last enabled. Each subscription has its own
+      /// strand, whose pending tasks are the queued messages. It is created
+      /// by QueueExecutor() on first use, so processes without queued
+      /// subscriptions don't run its threads, and it may only be read once
+      /// queueExecutorCreated is set.
+      /// See GZ_TRANSPORT_CALLBACK_THREADS.
+      public: std::unique_ptr<CallbackExecutor> queueExecutor;
+
+      /// \brief Creates the queueExecutor once.
+      public: std::once_flag queueExecutorOnce;
+
+      /// \brief Whether the queueExecutor was created.
+      public: std::atomic<bool> queueExecutorCreated{false};
+
+      /// \brief Number of threads of the queueExecutor.
+      public: unsigned int queueThreads = 1;
+
+      /// \brief Executor running the callbacks of the messages received from
+      /// other processes, or nullptr to run them in the reception thread.
+      /// See GZ_TRANSPORT_CALLBACK_THREADS.
+      public: std::unique_ptr<CallbackExecutor> callbackExecutor;
+
+      /// \brief Executor running the callbacks of the messages published from
+      /// this process, or nullptr to run them in the publish thread.
+      /// See GZ_TRANSPORT_LOCAL_CALLBACK_THREADS.
+      public: std::unique_ptr<CallbackExecutor> localExecutor;
+
+      /// \brief Check if the messages of a subscription go through a
+      /// subscription queue.
+      /// \param[in] _opts Options of the subscription.
+      /// \param[in] _intraProcess True if the message was published from
+      /// this process.
+      /// \return True if the messages must be queued.
+      public: static bool Queued(const SubscribeOptions &_opts,
+                                 bool _intraProcess);
+
+      /// \brief Maximum number of nested inline callbacks on a thread.
+      public: static constexpr std::size_t kMaxInlineDepth = 8;
+
+      /// \brief Subscriptions whose local callbacks are running on this
+      /// thread, outermost first.
+      public: static thread_local std::vector<const SubscriptionHandlerBase *>
+        activeHandlers;
+
+      /// \brief Check if a subscription runs its callback on the thread
+      /// publishing a message from this process. A callback that is already
+      /// running on this thread is not re-entered, and the nesting of inline
+      /// callbacks is bounded.
+      /// \param[in] _handler The subscription.
+      /// \return True to run the callback inline.
+      public: static bool RunsInline(const SubscriptionHandlerBase &_handler);
+
+      /// \brief Run the callback of a subscription for a message published
+      /// from this process, keeping track of the active handlers.
+      /// \param[in] _handler The subscription.
+      /// \param[in] _msg The message.
+      /// \param[in] _info Message information.
+      public: static void RunLocalCallback(ISubscriptionHandler &_handler,
+                                 const std::shared_ptr<const ProtoMsg> &_msg,
+                                           const MessageInfo &_info);
+
+      /// \brief Run the callback of a raw subscription for a message
+      /// published from this process, keeping track of the active handlers.
+      /// \param[in] _handler The subscription.
+      /// \param[in] _msgData The serialized message.
+      /// \param[in] _size Size of _msgData (bytes).
+      /// \param[in] _info Message information.
+      public: static void RunRawCallback(RawSubscriptionHandler &_handler,
+                                         const char *_msgData,
+                                         const std::size_t _size,
+                                         const MessageInfo &_info);
+
+      /// \brief Name of the strand of the local executor used by a
+      /// subscription. The strands of a node's subscriptions to a topic
+      /// share the prefix returned for an empty _hUuid.
+      /// \param[in] _topic Fully qualified topic name.
+      /// \param[in] _nUuid Node UUID.
+      /// \param[in] _hUuid Handler UUID.
+      /// \return The strand name.
+      public: static std::string LocalStrand(const std::string &_topic,
+                                             const std::string &_nUuid,
+                                             const std::string &_hUuid);
+
+      /// \brief Queue the callback of a subscription in the local executor,
+      /// applying the local queue depth and overflow policy of the
+      /// subscription. The callbacks of a subscription run in order.
+      /// \param[in] _topic Fully qualified topic name.
+      /// \param[in] _handler The subscription.
+      /// \param[in] _task Task running the callback.
+      public: void PostLocal(const std::string &_topic,
+                             const SubscriptionHandlerBase &_handler,
+                             std::function<void()> _task);
+
+      /// \brief Local handlers of a topic read from the lock-free snapshots
+      /// of the subscription storages. Unlike NodeShared::HandlerInfo, the
+      /// handlers are shared with the storages instead of copied.
+      public: struct HandlerSnapshot
+              {
+                /// \brief Standard local handlers, or nullptr if there are
+                /// none.
+                public: HandlerStorage<ISubscriptionHandler>::HandlerListPtr
+                  localHandlers;
+
+                /// \brief Raw local handlers, or nullptr if there are none.
+                public: HandlerStorage<RawSubscriptionHandler>::HandlerListPtr
+                  rawHandlers;
+
+                /// \brief True iff there are any standard local subscribers.
+                public: bool haveLocal = false;
+
+                /// \brief True iff there are any raw local subscribers.
+                public: bool haveRaw = false;
+              };
+
+      /// \brief Subscribers of a publisher. It is the counterpart of
+      /// NodeShared::SubscriberInfo used by the publishers.
+      public: struct SubscriberSnapshot : public HandlerSnapshot
+              {
+                /// \brief True if the publisher has any remote subscribers.
+                public: bool haveRemote = false;
+
+                /// \brief Compression codecs decoded by all the remote
+                /// subscribers that accept compressed messages, or 0 if there
+                /// are none. See codecMask().
+                public: uint32_t remoteCodecs = 0;
+              };
+
+      /// \brief Get the local handlers of a topic without locking the
+      /// NodeShared mutex.
+      /// \param[in] _shared The NodeShared owning the handlers.
+      /// \param[in] _topic Interned fully qualified topic name, or nullptr
+      /// if the topic is not interned, in which case it has no handlers.
+      /// \return The handlers of the topic.
+      public: static HandlerSnapshot CheckHandlerSnapshot(
+        const NodeShared &_shared, const InternedTopic *_topic);
+
+      /// \brief Get the subscribers of a publisher. Only the remote
+      /// subscribers are read under the NodeShared mutex.
+      /// \param[in] _shared The NodeShared owning the handlers.
+      /// \param[in] _topic Interned fully qualified topic name.
+      /// \param[in] _msgType Type of the published messages.
+      /// \return The subscribers of the topic.
+      public: SubscriberSnapshot CheckSubscriberSnapshot(
+        const NodeShared &_shared, const InternedTopic &_topic,
+        const std::string &_msgType) const;
+
+      /// \brief Call the local and raw handlers of a serialized message.
+      /// The message is parsed at most once, directly from _msgData.
+      /// \param[in] _info Message information.
+      /// \param[in] _msgData The serialized message.
+      /// \param[in] _size Size of _msgData (bytes).
+      /// \param[in] _handlerInfo Handlers of the topic.
+      /// \param[in, out] _frame ZMQ frame that holds _msgData, or nullptr.
+      /// If a queued subscription needs to keep the message, the frame is
+      /// moved into a shared holder instead of copying its data. Otherwise
+      /// the data is copied into a buffer of the bufferPool.
+      public: void TriggerCallbacks(const MessageInfo &_info,
+                                    const char *_msgData,
+                                    const std::size_t _size,
+                                    const HandlerSnapshot &_handlerInfo,
+                                    zmq::message_t *_frame);
+
+      /// \brief Get the queueExecutor, creating it on first use.
+      /// \return The executor of the queued subscriptions.
+      public: CallbackExecutor &QueueExecutor();
+
+      /// \brief Queue a message for a subscription with a queue depth or
+      /// with keep last enabled in the strand of the subscription in the
+      /// queueExecutor, applying its overflow policy. Exactly one of the
+      /// handlers must be set.
+      /// \param[in] _topic Fully qualified topic name.
+      /// \param[in] _localHandler Handler of a regular subscription.
+      /// \param[in] _rawHandler Handler of a raw subscription.
+      /// \param[in] _msg The message.
+      public: void EnqueueReceived(const std::string &_topic,
+        const ISubscriptionHandlerPtr &_localHandler,
+        const RawSubscriptionHandlerPtr &_rawHandler,
+        QueuedMsg &&_msg);
+
+      /// \brief Discard the pending messages of the subscriptions of a node
+      /// to a topic.
+      /// \param[in] _topic Fully qualified topic name.
+      /// \param[in] _nUuid Node UUID.
+      public: void RemoveSubscriptionQueues(const std::string &_topic,
+                                            const std::string &_nUuid);
+
+      /// \brief Count messages dropped by a full queue.
+      /// \param[in] _topic Fully qualified topic name.
+      /// \param[in] _count Number of messages dropped.
+      public: void RecordDrops(const std::string &_topic, uint64_t _count);
+
+      /// \brief Mutex to protect droppedMsgs.
+      public: mutable std::mutex droppedMsgsMutex;
+
+      /// \brief Number of messages dropped per topic.
+      public: std::map<std::string, uint64_t> droppedMsgs;
+
       /// \brief Topic publication sequence numbers.
       public: std::map<std::string, uint64_t> topicPubSeq;
 
+      /// \brief True if the compact header is enabled.
+      public: bool compactHeaderEnabled = false;
+
+      /// \brief Largest uncompressed size of a received message (bytes).
+      public: std::size_t maxDecompressedSize = kDefaultMaxDecompressedSize;
+
+      /// \brief Wire formats requested by the remote subscribers of a topic.
+      public: struct RemoteWireFormats
+              {
+                /// \brief True if any subscriber uses the regular format
+                /// without compression support.
+                public: bool legacy = false;
+
+                /// \brief True if any subscriber uses the regular format
+                /// with compression support. These subscribers receive the
+                /// messages on the codec route.
+                public: bool routed = false;
+
+                /// \brief Topic IDs used by the subscribers with the compact
+                /// header.
+                public: std::set<uint64_t> compactIds;
+
+                /// \brief Compression codecs decoded by all the subscribers
+                /// on the codec route or with the compact header, or 0 if
+                /// there are none.
+                public: uint32_t codecs = 0;
+              };
+
+      /// \brief Wire formats of the remote subscribers. The key is the
+      /// topic name. Topics without remote subscribers are not stored.
+      public: std::map<std::string, RemoteWireFormats> remoteWireFormats;
+
+      /// \brief Generation of the subscriber set. It is incremented, while
+      /// holding the NodeShared mutex, every time that a local handler or a
+      /// remote subscriber is added or removed. Publishers use it to know
+      /// when their cached SubscriberInfo is stale.
+      public: std::atomic<uint64_t> subscribersGeneration{0};
+
+      /// \brief Mark the subscriber set as changed. The NodeShared mutex
+      /// must be held by the caller.
+      public: void SubscribersChanged()
+      {
+        this->subscribersGeneration.fetch_add(1, std::memory_order_release);
+      }
+
+      /// \brief Subscription of a node to the topics matching a pattern.
+      public: struct PatternSubscription
+              {
+                /// \brief Node UUID.
+                public: std::string nUuid;
+
+                /// \brief Handler of a typed subscription, or nullptr.
+                public: ISubscriptionHandlerPtr handler;
+
+                /// \brief Handler of a raw subscription, or nullptr.
+                public: RawSubscriptionHandlerPtr rawHandler;
+
+                /// \brief Topics matching the pattern. The handler is stored
+                /// in NodeShared::localSubscribers for each of them.
+                public: std::unordered_set<std::string> topics;
+              };
+
+      /// \brief Subscriptions to topic patterns, keyed by the fully
+      /// qualified pattern. The NodeShared mutex must be held to use it.
+      public: TopicPatternTrie<std::shared_ptr<PatternSubscription>>
+        topicPatterns;
+
+      /// \brief Update the statistics of a topic with a received message
+      /// and notify them, if the topic has statistics enabled. The callback
+      /// runs without any lock held.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _sender Address of the publisher.
+      /// \param[in] _stamp Publication time stamp.
+      /// \param[in] _seq Publication sequence number.
+      public: void UpdateTopicStats(const std::string &_topic,
+                                    const std::string &_sender,
+                                    uint64_t _stamp, uint64_t _seq);
+
       /// \brief True if topic statistics have been enabled.
       public: bool topicStatsEnabled = false;
 
+      /// \brief Protects topicStats and enabledTopicStatistics, so the
+      /// reception threads don't need the NodeShared mutex to update them.
+      public: mutable std::mutex topicStatsMutex;
+
       /// \brief Statistics for a topic. The key in the map is the topic
       /// name and the value contains the topic statistics.
       public: std::map<std::string, TopicStatistics> topicStats;
@@ -18,13 +18,17 @@
 #include <gz/msgs/stringmsg.pb.h>
 #include <gz/msgs/vector3d.pb.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <csignal>
 #include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "gz/transport/AdvertiseOptions.hh"
@@ -700,6 +704,563 @@ TEST(NodeTest, PubSubSameThreadMessageInfo)
   reset();
 }
 
+//////////////////////////////////////////////////
+/// \brief Publish messages by shared and unique pointer and receive them
+/// in a callback that accepts a shared pointer. Local subscribers should get
+/// the published object itself instead of a copy.
+TEST(NodeTest, PubSubSharedPtr)
+{
+  reset();
+
+  transport::Node node;
+  auto pub = node.Advertise<gz::msgs::Int32>(g_topic);
+  EXPECT_TRUE(pub);
+
+  std::shared_ptr<const gz::msgs::Int32> received;
+  std::function<void(const std::shared_ptr<const gz::msgs::Int32> &,
+                     const transport::MessageInfo &)> sharedCb =
+    [&received](const std::shared_ptr<const gz::msgs::Int32> &_msg,
+                const transport::MessageInfo &_info)
+    {
+      EXPECT_EQ(_info.Topic(), g_topic);
+      EXPECT_TRUE(_info.IntraProcess());
+      EXPECT_EQ(_msg->data(), data);
+      std::lock_guard<std::mutex> lk(cbMutex);
+      received = _msg;
+      cbExecuted = true;
+    };
+  EXPECT_TRUE(node.Subscribe(g_topic, sharedCb));
+
+  // Wait some time before publishing.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  // Publish a shared message.
+  auto msg = std::make_shared<gz::msgs::Int32>();
+  msg->set_data(data);
+  std::shared_ptr<const gz::msgs::Int32> constMsg = msg;
+  EXPECT_TRUE(pub.Publish(constMsg));
+
+  // Give some time to the subscribers.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  {
+    std::lock_guard<std::mutex> lk(cbMutex);
+    EXPECT_TRUE(cbExecuted);
+    EXPECT_EQ(constMsg.get(), received.get());
+  }
+
+  reset();
+
+  // Publish a message transferring its ownership.
+  auto uniqueMsg = std::make_unique<gz::msgs::Int32>();
+  uniqueMsg->set_data(data);
+  const gz::msgs::Int32 *rawMsg = uniqueMsg.get();
+  EXPECT_TRUE(pub.Publish(std::move(uniqueMsg)));
+
+  // Give some time to the subscribers.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  {
+    std::lock_guard<std::mutex> lk(cbMutex);
+    EXPECT_TRUE(cbExecuted);
+    EXPECT_EQ(rawMsg, received.get());
+  }
+
+  reset();
+
+  // A message published by reference is copied.
+  gz::msgs::Int32 refMsg;
+  refMsg.set_data(data);
+  EXPECT_TRUE(pub.Publish(refMsg));
+
+  // Give some time to the subscribers.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  {
+    std::lock_guard<std::mutex> lk(cbMutex);
+    EXPECT_TRUE(cbExecuted);
+    EXPECT_NE(&refMsg, received.get());
+  }
+
+  // A null message is rejected.
+  EXPECT_FALSE(pub.Publish(std::shared_ptr<const gz::msgs::Int32>()));
+
+  reset();
+}
+
+//////////////////////////////////////////////////
+/// \brief Publish batches of messages and check that local and raw
+/// subscribers receive all of them in order.
+TEST(NodeTest, PubSubBatch)
+{
+  reset();
+
+  const int kBatchSize = 5;
+
+  transport::Node node;
+  auto pub = node.Advertise<gz::msgs::Int32>(g_topic);
+  EXPECT_TRUE(pub);
+
+  std::vector<int> received;
+  std::function<void(const gz::msgs::Int32 &)> localCb =
+    [&received](const gz::msgs::Int32 &_msg)
+    {
+      std::lock_guard<std::mutex> lk(cbMutex);
+      received.push_back(_msg.data());
+      cbCondition.notify_all();
+    };
+  EXPECT_TRUE(node.Subscribe(g_topic, localCb));
+
+  std::vector<int> receivedRaw;
+  transport::RawCallback rawCb =
+    [&receivedRaw](const char *_msgData, const std::size_t _size,
+                   const transport::MessageInfo &)
+    {
+      gz::msgs::Int32 msg;
+      EXPECT_TRUE(msg.ParseFromArray(_msgData, static_cast<int>(_size)));
+      std::lock_guard<std::mutex> lk(cbMutex);
+      receivedRaw.push_back(msg.data());
+      cbCondition.notify_all();
+    };
+  EXPECT_TRUE(node.SubscribeRaw(g_topic, rawCb,
+    gz::msgs::Int32().GetTypeName()));
+
+  // Wait some time before publishing.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  std::vector<gz::msgs::Int32> msgs(kBatchSize);
+  std::vector<const transport::ProtoMsg *> batch;
+  std::vector<std::shared_ptr<const transport::ProtoMsg>> sharedBatch;
+  std::vector<std::string> rawBatch;
+  for (int i = 0; i < kBatchSize; ++i)
+  {
+    msgs[i].set_data(i);
+    batch.push_back(&msgs[i]);
+
+    auto sharedMsg = std::make_shared<gz::msgs::Int32>();
+    sharedMsg->set_data(kBatchSize + i);
+    sharedBatch.push_back(sharedMsg);
+
+    gz::msgs::Int32 rawMsg;
+    rawMsg.set_data(2 * kBatchSize + i);
+    rawBatch.push_back(rawMsg.SerializeAsString());
+  }
+
+  // Wait for the given number of messages on both subscriptions.
+  auto waitForMessages = [&](const std::size_t _count)
+  {
+    std::unique_lock<std::mutex> lk(cbMutex);
+    return cbCondition.wait_for(lk, std::chrono::seconds(5), [&]
+      {
+        return received.size() >= _count && receivedRaw.size() >= _count;
+      });
+  };
+
+  EXPECT_TRUE(pub.PublishBatch(batch));
+  EXPECT_TRUE(pub.PublishBatch(sharedBatch));
+
+  // The typed batches are delivered asynchronously, while the raw batch
+  // runs the callbacks before returning. Wait for the typed batches, so the
+  // messages of all the batches arrive in order.
+  EXPECT_TRUE(waitForMessages(2u * kBatchSize));
+
+  EXPECT_TRUE(pub.PublishRawBatch(rawBatch, gz::msgs::Int32().GetTypeName()));
+  EXPECT_TRUE(waitForMessages(3u * kBatchSize));
+
+  {
+    std::lock_guard<std::mutex> lk(cbMutex);
+    ASSERT_EQ(3u * kBatchSize, received.size());
+    ASSERT_EQ(3u * kBatchSize, receivedRaw.size());
+    for (int i = 0; i < 3 * kBatchSize; ++i)
+    {
+      EXPECT_EQ(i, received[i]);
+      EXPECT_EQ(i, receivedRaw[i]);
+    }
+  }
+
+  // An empty batch is valid.
+  EXPECT_TRUE(pub.PublishBatch(std::vector<const transport::ProtoMsg *>()));
+
+  // Null messages and type mismatches are rejected.
+  batch.push_back(nullptr);
+  EXPECT_FALSE(pub.PublishBatch(batch));
+  gz::msgs::StringMsg wrongType;
+  batch.back() = &wrongType;
+  EXPECT_FALSE(pub.PublishBatch(batch));
+  EXPECT_FALSE(pub.PublishRawBatch(rawBatch,
+    gz::msgs::StringMsg().GetTypeName()));
+
+  reset();
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that a publisher notices subscribers added and removed
+/// between publications.
+TEST(NodeTest, PubSubSubscribersChange)
+{
+  reset();
+
+  gz::msgs::Int32 msg;
+  msg.set_data(data);
+
+  transport::Node node;
+  auto pub = node.Advertise<gz::msgs::Int32>(g_topic);
+  EXPECT_TRUE(pub);
+
+  // No subscribers yet.
+  EXPECT_TRUE(pub.Publish(msg));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(cbExecuted);
+
+  transport::Node subNode;
+  EXPECT_TRUE(subNode.Subscribe(g_topic, cb));
+
+  EXPECT_TRUE(pub.Publish(msg));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_TRUE(cbExecuted);
+
+  reset();
+
+  EXPECT_TRUE(subNode.Unsubscribe(g_topic));
+
+  EXPECT_TRUE(pub.Publish(msg));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(cbExecuted);
+
+  reset();
+}
+
+//////////////////////////////////////////////////
+/// \brief Subscribe to a topic pattern and check that the matching topics
+/// with a compatible type are received, whether they were advertised before
+/// or after the subscription.
+TEST(NodeTest, PubSubTopicPattern)
+{
+  std::mutex mutex;
+  std::vector<std::string> topics;
+  std::function<void(const msgs::Int32 &, const transport::MessageInfo &)>
+    patternCb = [&mutex, &topics](const msgs::Int32 &,
+                                  const transport::MessageInfo &_info)
+    {
+      std::lock_guard<std::mutex> lk(mutex);
+      topics.push_back(_info.Topic());
+    };
+
+  msgs::Int32 msg;
+  msg.set_data(data);
+  msgs::StringMsg strMsg;
+
+  transport::Node pubNode;
+  auto boxPub = pubNode.Advertise<msgs::Int32>("/model/box/pose");
+  EXPECT_TRUE(boxPub);
+
+  // Without the pattern option, "*" is a literal segment.
+  auto literalPub = pubNode.Advertise<msgs::Int32>("/model/*/pose");
+  EXPECT_TRUE(literalPub);
+
+  std::atomic<int> literalCounter{0};
+  std::function<void(const msgs::Int32 &)> literalCb =
+    [&literalCounter](const msgs::Int32 &)
+    {
+      ++literalCounter;
+    };
+  transport::Node literalNode;
+  EXPECT_TRUE(literalNode.Subscribe("/model/*/pose", literalCb));
+
+  transport::SubscribeOptions opts;
+  opts.SetTopicPattern(true);
+  transport::Node node;
+  EXPECT_TRUE(node.Subscribe("/model/*/pose", patternCb, opts));
+  std::vector<std::string> subscribed = node.SubscribedTopics();
+  ASSERT_EQ(1u, subscribed.size());
+  EXPECT_EQ("/model/*/pose", subscribed.front());
+
+  auto spherePub = pubNode.Advertise<msgs::Int32>("/model/sphere/pose");
+  auto twistPub = pubNode.Advertise<msgs::Int32>("/model/box/twist");
+  auto conePub = pubNode.Advertise<msgs::StringMsg>("/model/cone/pose");
+  EXPECT_TRUE(spherePub);
+  EXPECT_TRUE(twistPub);
+  EXPECT_TRUE(conePub);
+
+  EXPECT_TRUE(boxPub.Publish(msg));
+  EXPECT_TRUE(spherePub.Publish(msg));
+  EXPECT_TRUE(twistPub.Publish(msg));
+  EXPECT_TRUE(conePub.Publish(strMsg));
+  EXPECT_TRUE(literalPub.Publish(msg));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  {
+    std::lock_guard<std::mutex> lk(mutex);
+    std::sort(topics.begin(), topics.end());
+    EXPECT_EQ(std::vector<std::string>({"/model/*/pose", "/model/box/pose",
+      "/model/sphere/pose"}), topics);
+    topics.clear();
+  }
+  EXPECT_EQ(1, literalCounter);
+
+  EXPECT_TRUE(node.Unsubscribe("/model/*/pose"));
+  EXPECT_TRUE(node.SubscribedTopics().empty());
+
+  EXPECT_TRUE(boxPub.Publish(msg));
+  EXPECT_TRUE(spherePub.Publish(msg));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  std::lock_guard<std::mutex> lk(mutex);
+  EXPECT_TRUE(topics.empty());
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that the explicit subscriptions and the pattern
+/// subscriptions of a node to the same topic are independent.
+TEST(NodeTest, PubSubTopicPatternAndTopic)
+{
+  std::atomic<int> patternCounter{0};
+  std::atomic<int> topicCounter{0};
+  transport::RawCallback rawPatternCb =
+    [&patternCounter](const char *, const size_t,
+                      const transport::MessageInfo &)
+    {
+      ++patternCounter;
+    };
+  std::function<void(const msgs::Int32 &)> topicCb =
+    [&topicCounter](const msgs::Int32 &)
+    {
+      ++topicCounter;
+    };
+
+  msgs::Int32 msg;
+  msg.set_data(data);
+
+  transport::Node pubNode;
+  auto pub = pubNode.Advertise<msgs::Int32>("/robot/arm/joint");
+  EXPECT_TRUE(pub);
+
+  transport::SubscribeOptions opts;
+  opts.SetTopicPattern(true);
+  transport::Node node;
+  EXPECT_TRUE(node.SubscribeRaw("/robot/**", rawPatternCb,
+    transport::kGenericMessageType, opts));
+  EXPECT_TRUE(node.Subscribe("/robot/arm/joint", topicCb));
+
+  EXPECT_TRUE(pub.Publish(msg));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(1, patternCounter);
+  EXPECT_EQ(1, topicCounter);
+
+  // Unsubscribing from the topic keeps the pattern.
+  EXPECT_TRUE(node.Unsubscribe("/robot/arm/joint"));
+  EXPECT_TRUE(pub.Publish(msg));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(2, patternCounter);
+  EXPECT_EQ(1, topicCounter);
+
+  // Unsubscribing from the pattern keeps the topic.
+  EXPECT_TRUE(node.Subscribe("/robot/arm/joint", topicCb));
+  EXPECT_TRUE(node.Unsubscribe("/robot/**"));
+  EXPECT_TRUE(pub.Publish(msg));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(2, patternCounter);
+  EXPECT_EQ(2, topicCounter);
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that a publisher with a local queue depth drops the messages that
+/// a slow local subscriber can't keep up with.
+TEST(NodeTest, PubSubQueueDepth)
+{
+  const std::string topic = "/queue_depth";
+  std::atomic<int> counter{0};
+  std::function<void(const msgs::Int32 &)> slowCb =
+    [&counter](const msgs::Int32 &)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      ++counter;
+    };
+
+  gz::msgs::Int32 msg;
+  msg.set_data(data);
+
+  transport::Node node;
+  transport::AdvertiseMessageOptions opts;
+  opts.SetLocalQueueDepth(1u);
+  auto pub = node.Advertise<gz::msgs::Int32>(topic, opts);
+  EXPECT_TRUE(pub);
+  EXPECT_TRUE(node.Subscribe(topic, slowCb));
+  EXPECT_EQ(0u, node.DroppedMessages(topic));
+
+  const int kMsgs = 10;
+  for (int i = 0; i < kMsgs; ++i)
+    EXPECT_TRUE(pub.Publish(msg));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+  const uint64_t dropped = node.DroppedMessages(topic);
+  EXPECT_GT(dropped, 0u);
+  EXPECT_EQ(static_cast<uint64_t>(kMsgs), counter + dropped);
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that a slow subscriber keeping the last message skips the
+/// stale messages and always gets the latest one.
+TEST(NodeTest, PubSubKeepLast)
+{
+  const std::string topic = "/keep_last";
+  std::atomic<int> counter{0};
+  std::atomic<int> lastValue{-1};
+  std::function<void(const msgs::Int32 &)> slowCb =
+    [&counter, &lastValue](const msgs::Int32 &_msg)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      lastValue = _msg.data();
+      ++counter;
+    };
+
+  transport::Node node;
+  auto pub = node.Advertise<gz::msgs::Int32>(topic);
+  EXPECT_TRUE(pub);
+
+  transport::SubscribeOptions opts;
+  opts.SetKeepLast(1u);
+  EXPECT_TRUE(node.Subscribe(topic, slowCb, opts));
+
+  const int kMsgs = 20;
+  gz::msgs::Int32 msg;
+  for (int i = 0; i < kMsgs; ++i)
+  {
+    msg.set_data(i);
+    EXPECT_TRUE(pub.Publish(msg));
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+  EXPECT_LT(counter, kMsgs);
+  EXPECT_EQ(kMsgs - 1, lastValue);
+
+  // Replaced messages are not drops.
+  EXPECT_EQ(0u, node.DroppedMessages(topic));
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that the messages kept for a slow subscriber are discarded
+/// when it unsubscribes.
+TEST(NodeTest, PubSubKeepLastUnsubscribe)
+{
+  const std::string topic = "/keep_last_unsubscribe";
+  std::atomic<int> counter{0};
+  std::function<void(const msgs::Int32 &)> slowCb =
+    [&counter](const msgs::Int32 &)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      ++counter;
+    };
+
+  transport::Node node;
+  auto pub = node.Advertise<gz::msgs::Int32>(topic);
+  EXPECT_TRUE(pub);
+
+  transport::SubscribeOptions opts;
+  opts.SetKeepLast(5u);
+  EXPECT_TRUE(node.Subscribe(topic, slowCb, opts));
+
+  gz::msgs::Int32 msg;
+  msg.set_data(data);
+  for (int i = 0; i < 5; ++i)
+    EXPECT_TRUE(pub.Publish(msg));
+
+  // Let the first callback start, then drop the kept messages.
+  std::this_thread::sleep_for(std::chrono::milliseconds(25));
+  EXPECT_TRUE(node.Unsubscribe(topic));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_LE(counter, 1);
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that an inline subscription runs its callback on the
+/// publishing thread before Publish() returns.
+TEST(NodeTest, PubSubInline)
+{
+  const std::string topic = "/inline";
+  std::thread::id cbThread;
+  int counter = 0;
+  std::function<void(const msgs::Int32 &)> cb =
+    [&cbThread, &counter](const msgs::Int32 &)
+    {
+      cbThread = std::this_thread::get_id();
+      ++counter;
+    };
+
+  transport::Node node;
+  auto pub = node.Advertise<gz::msgs::Int32>(topic);
+  EXPECT_TRUE(pub);
+
+  transport::SubscribeOptions opts;
+  opts.SetInlineDelivery(true);
+  EXPECT_TRUE(node.Subscribe(topic, cb, opts));
+
+  gz::msgs::Int32 msg;
+  msg.set_data(data);
+  EXPECT_TRUE(pub.Publish(msg));
+  EXPECT_EQ(1, counter);
+  EXPECT_EQ(std::this_thread::get_id(), cbThread);
+
+  // The node option applies to all its subscriptions.
+  transport::NodeOptions nodeOpts;
+  nodeOpts.SetInlineDelivery(true);
+  transport::Node inlineNode(nodeOpts);
+  int rawCounter = 0;
+  EXPECT_TRUE(inlineNode.SubscribeRaw(topic,
+    [&rawCounter](const char *, const std::size_t,
+                  const transport::MessageInfo &)
+    {
+      ++rawCounter;
+    }, msg.GetTypeName()));
+
+  EXPECT_TRUE(pub.Publish(msg));
+  EXPECT_EQ(2, counter);
+  EXPECT_EQ(1, rawCounter);
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that an inline callback publishing on its own topic is not
+/// re-entered. The nested message goes through the publish thread.
+TEST(NodeTest, PubSubInlineReentrant)
+{
+  const std::string topic = "/inline_reentrant";
+  transport::Node node;
+  auto pub = node.Advertise<gz::msgs::Int32>(topic);
+  EXPECT_TRUE(pub);
+
+  std::atomic<int> depth{0};
+  std::atomic<int> maxDepth{0};
+  std::atomic<int> counter{0};
+  std::function<void(const msgs::Int32 &)> cb =
+    [&](const msgs::Int32 &_msg)
+    {
+      maxDepth = std::max(maxDepth.load(), ++depth);
+      ++counter;
+      if (_msg.data() > 0)
+      {
+        gz::msgs::Int32 next;
+        next.set_data(_msg.data() - 1);
+        EXPECT_TRUE(pub.Publish(next));
+      }
+      --depth;
+    };
+
+  transport::SubscribeOptions opts;
+  opts.SetInlineDelivery(true);
+  EXPECT_TRUE(node.Subscribe(topic, cb, opts));
+
+  gz::msgs::Int32 msg;
+  msg.set_data(3);
+  EXPECT_TRUE(pub.Publish(msg));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(4, counter);
+  EXPECT_EQ(1, maxDepth);
+}
+
 //////////////////////////////////////////////////
 TEST(NodeTest, RawPubSubSameThreadMessageInfo)
 {
@@ -780,6 +1341,130 @@ TEST(NodeTest, RawPubRawSubSameThreadMessageInfo)
   reset();
 }
 
+//////////////////////////////////////////////////
+/// \brief Deallocation function that counts its calls.
+void countingDealloc(void *_data, void *_hint)
+{
+  delete[] static_cast<char *>(_data);
+  ++(*static_cast<int *>(_hint));
+}
+
+//////////////////////////////////////////////////
+/// \brief Publish raw messages from a span and from an owned buffer.
+TEST(NodeTest, RawPubSpanAndOwnedBuffer)
+{
+  reset();
+
+  gz::msgs::Int32 msg;
+  msg.set_data(data);
+  const std::string serialized = msg.SerializeAsString();
+
+  transport::Node node;
+  auto pub = node.Advertise<gz::msgs::Int32>(g_topic);
+  EXPECT_TRUE(pub);
+
+  EXPECT_TRUE(node.Subscribe(g_topic, cb));
+  EXPECT_TRUE(node.SubscribeRaw(g_topic, rawCbInfo));
+
+  // Wait some time before publishing.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  // Span.
+  EXPECT_TRUE(pub.PublishRaw(serialized.data(), serialized.size(),
+    msg.GetTypeName()));
+  EXPECT_TRUE(cbExecuted);
+  EXPECT_EQ(2, counter);
+
+  reset();
+
+  // Owned buffer. The local subscribers do not keep it, so it is released
+  // before returning.
+  int released = 0;
+  char *buffer = new char[serialized.size()];
+  memcpy(buffer, serialized.data(), serialized.size());
+  EXPECT_TRUE(pub.PublishRaw(buffer, serialized.size(), &countingDealloc,
+    &released, msg.GetTypeName()));
+  EXPECT_TRUE(cbExecuted);
+  EXPECT_EQ(2, counter);
+  EXPECT_EQ(1, released);
+
+  // The buffer is also released when the message is rejected.
+  buffer = new char[serialized.size()];
+  EXPECT_FALSE(pub.PublishRaw(buffer, serialized.size(), &countingDealloc,
+    &released, "wrong.type"));
+  EXPECT_EQ(2, released);
+
+  // A deallocation function is required.
+  char unowned[1] = {0};
+  EXPECT_FALSE(pub.PublishRaw(unowned, sizeof(unowned), nullptr, nullptr,
+    msg.GetTypeName()));
+
+  // An invalid publisher releases the buffer too.
+  transport::Node::Publisher invalidPub;
+  buffer = new char[serialized.size()];
+  EXPECT_FALSE(invalidPub.PublishRaw(buffer, serialized.size(),
+    &countingDealloc, &released, msg.GetTypeName()));
+  EXPECT_EQ(3, released);
+
+  // An empty owned buffer is released as well.
+  EXPECT_FALSE(pub.PublishRaw(nullptr, 0, &countingDealloc, &released,
+    "wrong.type"));
+  EXPECT_EQ(4, released);
+  EXPECT_FALSE(invalidPub.PublishRaw(nullptr, 0, &countingDealloc,
+    &released, msg.GetTypeName()));
+  EXPECT_EQ(5, released);
+
+  reset();
+}
+
+//////////////////////////////////////////////////
+/// \brief Deserialize raw messages in arenas for typed and generic
+/// subscribers.
+TEST(NodeTest, RawPubSubArena)
+{
+  reset();
+
+  gz::msgs::Int32 msg;
+  msg.set_data(data);
+
+  transport::Node node;
+  auto pub = node.Advertise<gz::msgs::Int32>(g_topic);
+  EXPECT_TRUE(pub);
+
+  transport::SubscribeOptions opts;
+  opts.SetUseArena(true);
+  EXPECT_TRUE(opts.UseArena());
+
+  std::atomic<int> arenaMsgs{0};
+  std::function<void(const gz::msgs::Int32 &)> typedCb =
+    [&arenaMsgs](const gz::msgs::Int32 &_msg)
+    {
+      EXPECT_EQ(data, _msg.data());
+      if (_msg.GetArena())
+        ++arenaMsgs;
+    };
+  std::function<void(const transport::ProtoMsg &)> generic =
+    [&arenaMsgs](const transport::ProtoMsg &_msg)
+    {
+      EXPECT_EQ(gz::msgs::Int32().GetTypeName(), _msg.GetTypeName());
+      if (_msg.GetArena())
+        ++arenaMsgs;
+    };
+
+  transport::Node typedNode;
+  EXPECT_TRUE(typedNode.Subscribe(g_topic, typedCb, opts));
+  transport::Node genericNode;
+  EXPECT_TRUE(genericNode.Subscribe(g_topic, generic, opts));
+
+  for (int i = 0; i < 3; ++i)
+    EXPECT_TRUE(pub.PublishRaw(msg.SerializeAsString(), msg.GetTypeName()));
+
+  // The first subscriber deserializes the message for both of them.
+  EXPECT_EQ(6, arenaMsgs);
+
+  reset();
+}
+
 //////////////////////////////////////////////////
 TEST(NodeTest, PubRawSubSameThreadMessageInfo)
 {
@@ -2259,6 +2944,45 @@ TEST(NodeTest, SndHwm)
   EXPECT_EQ(gz::transport::kDefaultSndHwm, gz::transport::sndHwm());
 }
 
+//////////////////////////////////////////////////
+/// \brief Check the depth and the high-water mark of the queue of local
+/// publications.
+TEST(NodeTest, PublishQueueDepth)
+{
+  const std::string topic = "/publish_queue_depth";
+  std::atomic<bool> release{false};
+  std::atomic<int> counter{0};
+  std::function<void(const msgs::Int32 &)> cb =
+    [&release, &counter](const msgs::Int32 &)
+    {
+      while (!release)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      ++counter;
+    };
+
+  transport::Node node;
+  auto pub = node.Advertise<gz::msgs::Int32>(topic);
+  EXPECT_TRUE(pub);
+  EXPECT_TRUE(node.Subscribe(topic, cb));
+
+  // The first message blocks the publish thread, the others wait.
+  const int kMsgs = 10;
+  gz::msgs::Int32 msg;
+  for (int i = 0; i < kMsgs; ++i)
+    EXPECT_TRUE(pub.Publish(msg));
+
+  EXPECT_GE(transport::publishQueueDepth(), kMsgs - 1u);
+  EXPECT_GE(transport::publishQueueHighWater(), kMsgs - 1u);
+
+  release = true;
+  for (int i = 0; i < 100 && counter < kMsgs; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  EXPECT_EQ(kMsgs, counter);
+  EXPECT_EQ(0u, transport::publishQueueDepth());
+  EXPECT_GE(transport::publishQueueHighWater(), kMsgs - 1u);
+}
+
 //////////////////////////////////////////////////
 /// \brief Check that we destruct a Node object before a Node::Publisher.
 TEST(NodePubTest, DestructionOrder)
@@ -26,9 +26,23 @@
 #include "gz/transport/NodeShared.hh"
 #include "gz/transport/SubscriptionHandler.hh"
 
+#include "AdvertiseOptionsPrivate.hh"
+
 using namespace gz;
 using namespace transport;
 
+namespace
+{
+  /// \brief Key of the discovery header entry holding the topic ID.
+  const char kTopicIdKey[] = "topic_id";
+
+  /// \brief Key of the discovery header entry holding the supported codecs.
+  const char kCodecsKey[] = "codecs";
+
+  /// \brief Key of the discovery header entry holding the priority class.
+  const char kPriorityKey[] = "priority";
+}
+
 //////////////////////////////////////////////////
 Publisher::Publisher(const std::string &_topic, const std::string &_addr,
   const std::string &_pUuid, const std::string &_nUuid,
@@ -172,6 +186,10 @@ MessagePublisher::MessagePublisher(const std::string &_topic,
     msgTypeName(_msgTypeName),
     msgOpts(_opts)
 {
+  // The options of another publisher don't carry over its topic ID and
+  // codecs.
+  this->SetTopicId(0);
+  this->SetCodecs(0);
 }
 
 //////////////////////////////////////////////////
@@ -207,7 +225,37 @@ const AdvertiseMessageOptions& MessagePublisher::Options() const
 //////////////////////////////////////////////////
 void MessagePublisher::SetOptions(const AdvertiseMessageOptions &_opts)
 {
+  // The topic ID and the codecs belong to this publisher, not to the
+  // options.
+  const uint64_t topicId = this->TopicId();
+  const uint32_t codecs = this->Codecs();
   this->msgOpts = _opts;
+  this->SetTopicId(topicId);
+  this->SetCodecs(codecs);
+}
+
+//////////////////////////////////////////////////
+uint64_t MessagePublisher::TopicId() const
+{
+  return this->msgOpts.dataPtr->topicId;
+}
+
+//////////////////////////////////////////////////
+void MessagePublisher::SetTopicId(const uint64_t _topicId)
+{
+  this->msgOpts.dataPtr->topicId = _topicId;
+}
+
+//////////////////////////////////////////////////
+uint32_t MessagePublisher::Codecs() const
+{
+  return this->msgOpts.dataPtr->codecs;
+}
+
+//////////////////////////////////////////////////
+void MessagePublisher::SetCodecs(const uint32_t _codecs)
+{
+  this->msgOpts.dataPtr->codecs = _codecs;
 }
 
 //////////////////////////////////////////////////
@@ -221,6 +269,29 @@ void MessagePublisher::FillDiscovery(msgs::Discovery &_msg) const
   pub->mutable_msg_pub()->set_msg_type(this->MsgTypeName());
   pub->mutable_msg_pub()->set_throttled(this->msgOpts.Throttled());
   pub->mutable_msg_pub()->set_msgs_per_sec(this->msgOpts.MsgsPerSec());
+
+  // The topic ID travels in the header, so older versions ignore it.
+  if (this->TopicId() != 0)
+  {
+    auto *data = _msg.mutable_header()->add_data();
+    data->set_key(kTopicIdKey);
+    data->add_value(std::to_string(this->TopicId()));
+  }
+
+  if (this->Codecs() != 0)
+  {
+    auto *data = _msg.mutable_header()->add_data();
+    data->set_key(kCodecsKey);
+    data->add_value(std::to_string(this->Codecs()));
+  }
+
+  if (this->msgOpts.Priority() != Priority_t::NORMAL)
+  {
+    auto *data = _msg.mutable_header()->add_data();
+    data->set_key(kPriorityKey);
+    data->add_value(
+      std::to_string(static_cast<int>(this->msgOpts.Priority())));
+  }
 }
 
 //////////////////////////////////////////////////
@@ -234,6 +305,37 @@ void MessagePublisher::SetFromDiscovery(const msgs::Discovery &_msg)
     this->msgOpts.SetMsgsPerSec(kUnthrottled);
   else
     this->msgOpts.SetMsgsPerSec(_msg.pub().msg_pub().msgs_per_sec());
+
+  this->SetTopicId(0);
+  this->SetCodecs(0);
+  this->msgOpts.SetPriority(Priority_t::NORMAL);
+  for (const auto &data : _msg.header().data())
+  {
+    if (data.value_size() == 0)
+      continue;
+
+    try
+    {
+      if (data.key() == kTopicIdKey)
+        this->SetTopicId(std::stoull(data.value(0)));
+      else if (data.key() == kCodecsKey)
+        this->SetCodecs(static_cast<uint32_t>(std::stoul(data.value(0))));
+      else if (data.key() == kPriorityKey)
+      {
+        const int priority = std::stoi(data.value(0));
+        if (priority >= static_cast<int>(Priority_t::REALTIME) &&
+            priority <= static_cast<int>(Priority_t::BULK))
+        {
+          this->msgOpts.SetPriority(static_cast<Priority_t>(priority));
+        }
+      }
+    }
+    catch(...)
+    {
+      std::cerr << "MessagePublisher::SetFromDiscovery(): Invalid value for "
+                << "[" << data.key() << "]" << std::endl;
+    }
+  }
 }
 
 //////////////////////////////////////////////////
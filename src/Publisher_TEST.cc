@@ -221,6 +221,52 @@ TEST(PublisherTest, MessagePublisherIO)
   EXPECT_EQ(publisher.NUuid(),       otherPublisher.NUuid());
   EXPECT_EQ(publisher.MsgTypeName(), otherPublisher.MsgTypeName());
   EXPECT_EQ(publisher.Options(),     otherPublisher.Options());
+  EXPECT_EQ(0u,                      otherPublisher.TopicId());
+
+  // Pack a publisher with a compact topic ID.
+  const uint64_t topicId = 0x123456789abcdef0u;
+  publisher.SetTopicId(topicId);
+  EXPECT_EQ(topicId, publisher.TopicId());
+  msgs::Discovery msgWithId;
+  publisher.FillDiscovery(msgWithId);
+  otherPublisher.SetFromDiscovery(msgWithId);
+  EXPECT_EQ(topicId, otherPublisher.TopicId());
+
+  // The topic ID does not change the identity of the publisher.
+  EXPECT_EQ(publisher, otherPublisher);
+
+  // Pack a publisher with the supported compression codecs.
+  publisher.SetCodecs(0x6u);
+  EXPECT_EQ(0x6u, publisher.Codecs());
+  msgs::Discovery msgWithCodecs;
+  publisher.FillDiscovery(msgWithCodecs);
+  otherPublisher.SetFromDiscovery(msgWithCodecs);
+  EXPECT_EQ(0x6u, otherPublisher.Codecs());
+  EXPECT_EQ(topicId, otherPublisher.TopicId());
+
+  // Pack a publisher sending through the bulk priority lane.
+  AdvertiseMessageOptions bulkOpts(g_msgOpts2);
+  bulkOpts.SetPriority(Priority_t::BULK);
+  publisher.SetOptions(bulkOpts);
+  msgs::Discovery msgWithPriority;
+  publisher.FillDiscovery(msgWithPriority);
+  otherPublisher.SetFromDiscovery(msgWithPriority);
+  EXPECT_EQ(Priority_t::BULK, otherPublisher.Options().Priority());
+
+  // New options keep the topic ID and the codecs of the publisher, and a
+  // new publisher doesn't take them from the options of another one.
+  EXPECT_EQ(topicId, publisher.TopicId());
+  EXPECT_EQ(0x6u, publisher.Codecs());
+  MessagePublisher copiedOptsPublisher(g_topic, g_addr, g_ctrl, g_puuid,
+    g_nuuid, g_msgTypeName, publisher.Options());
+  EXPECT_EQ(0u, copiedOptsPublisher.TopicId());
+  EXPECT_EQ(0u, copiedOptsPublisher.Codecs());
+
+  // A discovery message without topic ID, codecs or priority resets them.
+  otherPublisher.SetFromDiscovery(msg);
+  EXPECT_EQ(0u, otherPublisher.TopicId());
+  EXPECT_EQ(0u, otherPublisher.Codecs());
+  EXPECT_EQ(Priority_t::NORMAL, otherPublisher.Options().Priority());
 }
 
 //////////////////////////////////////////////////
@@ -36,6 +36,14 @@ SubscribeOptions::SubscribeOptions(const SubscribeOptions &_otherSubscribeOpts)
   : dataPtr(new SubscribeOptionsPrivate())
 {
   this->SetMsgsPerSec(_otherSubscribeOpts.MsgsPerSec());
+  this->SetQueueDepth(_otherSubscribeOpts.QueueDepth());
+  this->SetLocalQueueDepth(_otherSubscribeOpts.LocalQueueDepth());
+  this->SetOverflow(_otherSubscribeOpts.Overflow());
+  this->SetBlockTimeout(_otherSubscribeOpts.BlockTimeout());
+  this->SetKeepLast(_otherSubscribeOpts.KeepLast());
+  this->SetUseArena(_otherSubscribeOpts.UseArena());
+  this->SetInlineDelivery(_otherSubscribeOpts.InlineDelivery());
+  this->SetTopicPattern(_otherSubscribeOpts.TopicPattern());
 }
 
 //////////////////////////////////////////////////
@@ -60,3 +68,100 @@ void SubscribeOptions::SetMsgsPerSec(const uint64_t _newMsgsPerSec)
 {
   this->dataPtr->msgsPerSec = _newMsgsPerSec;
 }
+
+//////////////////////////////////////////////////
+uint64_t SubscribeOptions::QueueDepth() const
+{
+  return this->dataPtr->queueDepth;
+}
+
+//////////////////////////////////////////////////
+void SubscribeOptions::SetQueueDepth(const uint64_t _depth)
+{
+  this->dataPtr->queueDepth = _depth;
+}
+
+//////////////////////////////////////////////////
+uint64_t SubscribeOptions::LocalQueueDepth() const
+{
+  return this->dataPtr->localQueueDepth;
+}
+
+//////////////////////////////////////////////////
+void SubscribeOptions::SetLocalQueueDepth(const uint64_t _depth)
+{
+  this->dataPtr->localQueueDepth = _depth;
+}
+
+//////////////////////////////////////////////////
+OverflowPolicy SubscribeOptions::Overflow() const
+{
+  return this->dataPtr->overflow;
+}
+
+//////////////////////////////////////////////////
+void SubscribeOptions::SetOverflow(const OverflowPolicy _policy)
+{
+  this->dataPtr->overflow = _policy;
+}
+
+//////////////////////////////////////////////////
+std::chrono::milliseconds SubscribeOptions::BlockTimeout() const
+{
+  return this->dataPtr->blockTimeout;
+}
+
+//////////////////////////////////////////////////
+void SubscribeOptions::SetBlockTimeout(
+  const std::chrono::milliseconds &_timeout)
+{
+  this->dataPtr->blockTimeout = _timeout;
+}
+
+//////////////////////////////////////////////////
+uint64_t SubscribeOptions::KeepLast() const
+{
+  return this->dataPtr->keepLast;
+}
+
+//////////////////////////////////////////////////
+void SubscribeOptions::SetKeepLast(const uint64_t _n)
+{
+  this->dataPtr->keepLast = _n;
+}
+
+//////////////////////////////////////////////////
+bool SubscribeOptions::UseArena() const
+{
+  return this->dataPtr->useArena;
+}
+
+//////////////////////////////////////////////////
+void SubscribeOptions::SetUseArena(const bool _useArena)
+{
+  this->dataPtr->useArena = _useArena;
+}
+
+//////////////////////////////////////////////////
+bool SubscribeOptions::InlineDelivery() const
+{
+  return this->dataPtr->inlineDelivery;
+}
+
+//////////////////////////////////////////////////
+void SubscribeOptions::SetInlineDelivery(const bool _inline)
+{
+  this->dataPtr->inlineDelivery = _inline;
+}
+
+//////////////////////////////////////////////////
+bool SubscribeOptions::TopicPattern() const
+{
+  return this->dataPtr->topicPattern;
+}
+
+//////////////////////////////////////////////////
+void SubscribeOptions::SetTopicPattern(const bool _pattern)
+{
+  this->dataPtr->topicPattern = _pattern;
+}
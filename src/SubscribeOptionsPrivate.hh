@@ -18,9 +18,11 @@
 #ifndef GZ_TRANSPORT_SUBSCRIBEOPTIONSPRIVATE_HH_
 #define GZ_TRANSPORT_SUBSCRIBEOPTIONSPRIVATE_HH_
 
+#include <chrono>
 #include <cstdint>
 
 #include "gz/transport/Helpers.hh"
+#include "gz/transport/OverflowPolicy.hh"
 
 namespace gz
 {
@@ -41,6 +43,30 @@ namespace gz
 
       /// \brief Default message subscription rate.
       public: uint64_t msgsPerSec = kUnthrottled;
+
+      /// \brief Queue depth (0 means no queue).
+      public: uint64_t queueDepth = 0;
+
+      /// \brief Queue depth for local messages (0 means no limit).
+      public: uint64_t localQueueDepth = 0;
+
+      /// \brief Overflow policy.
+      public: OverflowPolicy overflow = OverflowPolicy::DROP_NEWEST;
+
+      /// \brief Timeout used with OverflowPolicy::BLOCK.
+      public: std::chrono::milliseconds blockTimeout{100};
+
+      /// \brief Number of latest messages kept (0 means disabled).
+      public: uint64_t keepLast = 0;
+
+      /// \brief Deserialize the messages in a protobuf arena.
+      public: bool useArena = false;
+
+      /// \brief Run the callback on the publishing thread.
+      public: bool inlineDelivery = false;
+
+      /// \brief The topic of the subscription is a pattern.
+      public: bool topicPattern = false;
     };
     }
   }
@@ -15,6 +15,8 @@
  *
 */
 
+#include <chrono>
+
 #include "gz/transport/Helpers.hh"
 #include "gz/transport/SubscribeOptions.hh"
 #include "test_config.hh"
@@ -30,8 +32,24 @@ TEST(SubscribeOptionsTest, copyConstructor)
   SubscribeOptions opts1;
   opts1.SetMsgsPerSec(2u);
   EXPECT_EQ(opts1.MsgsPerSec(), 2u);
+  opts1.SetQueueDepth(5u);
+  opts1.SetLocalQueueDepth(6u);
+  opts1.SetOverflow(OverflowPolicy::BLOCK);
+  opts1.SetBlockTimeout(std::chrono::milliseconds(20));
+  opts1.SetKeepLast(1u);
+  opts1.SetUseArena(true);
+  opts1.SetInlineDelivery(true);
+  opts1.SetTopicPattern(true);
   SubscribeOptions opts2(opts1);
   EXPECT_EQ(opts2.MsgsPerSec(), opts1.MsgsPerSec());
+  EXPECT_EQ(opts2.QueueDepth(), opts1.QueueDepth());
+  EXPECT_EQ(opts2.LocalQueueDepth(), opts1.LocalQueueDepth());
+  EXPECT_EQ(opts2.Overflow(), opts1.Overflow());
+  EXPECT_EQ(opts2.BlockTimeout(), opts1.BlockTimeout());
+  EXPECT_EQ(opts2.KeepLast(), opts1.KeepLast());
+  EXPECT_EQ(opts2.UseArena(), opts1.UseArena());
+  EXPECT_EQ(opts2.InlineDelivery(), opts1.InlineDelivery());
+  EXPECT_EQ(opts2.TopicPattern(), opts1.TopicPattern());
 }
 
 //////////////////////////////////////////////////
@@ -43,6 +61,40 @@ TEST(SubscribeOptionsTest, accessors)
   EXPECT_EQ(opts.MsgsPerSec(), kUnthrottled);
   opts.SetMsgsPerSec(3u);
   EXPECT_EQ(opts.MsgsPerSec(), 3u);
+
+  // Queue depth and overflow policy.
+  EXPECT_EQ(opts.QueueDepth(), 0u);
+  EXPECT_EQ(opts.Overflow(), OverflowPolicy::DROP_NEWEST);
+  EXPECT_EQ(opts.BlockTimeout(), std::chrono::milliseconds(100));
+  opts.SetQueueDepth(4u);
+  EXPECT_EQ(opts.QueueDepth(), 4u);
+  EXPECT_EQ(opts.LocalQueueDepth(), 0u);
+  opts.SetLocalQueueDepth(7u);
+  EXPECT_EQ(opts.LocalQueueDepth(), 7u);
+  opts.SetOverflow(OverflowPolicy::DROP_OLDEST);
+  EXPECT_EQ(opts.Overflow(), OverflowPolicy::DROP_OLDEST);
+  opts.SetBlockTimeout(std::chrono::milliseconds(10));
+  EXPECT_EQ(opts.BlockTimeout(), std::chrono::milliseconds(10));
+
+  // Keep last.
+  EXPECT_EQ(opts.KeepLast(), 0u);
+  opts.SetKeepLast(2u);
+  EXPECT_EQ(opts.KeepLast(), 2u);
+
+  // Arena.
+  EXPECT_FALSE(opts.UseArena());
+  opts.SetUseArena(true);
+  EXPECT_TRUE(opts.UseArena());
+
+  // Inline delivery.
+  EXPECT_FALSE(opts.InlineDelivery());
+  opts.SetInlineDelivery(true);
+  EXPECT_TRUE(opts.InlineDelivery());
+
+  // Topic pattern.
+  EXPECT_FALSE(opts.TopicPattern());
+  opts.SetTopicPattern(true);
+  EXPECT_TRUE(opts.TopicPattern());
 }
 
 //////////////////////////////////////////////////
@@ -37,6 +37,31 @@ namespace gz
         this->periodNs = 1e9 / this->opts.MsgsPerSec();
     }
 
+    /////////////////////////////////////////////////
+    const std::string *SubscriptionHandlerBase::TypeId()
+    {
+      if (this->typeId)
+        return this->typeId;
+      return InternTable::String(this->TypeName());
+    }
+
+    /////////////////////////////////////////////////
+    bool SubscriptionHandlerBase::AcceptsType(const std::string *_typeId)
+    {
+      static const std::string *genericTypeId =
+        InternTable::String(kGenericMessageType);
+
+      const std::string *id = this->TypeId();
+      return id == _typeId || id == genericTypeId;
+    }
+
+    /////////////////////////////////////////////////
+    bool SubscriptionHandlerBase::AcceptsType(const std::string &_typeName)
+    {
+      const std::string *id = this->TypeId();
+      return *id == _typeName || *id == kGenericMessageType;
+    }
+
     /////////////////////////////////////////////////
     std::string SubscriptionHandlerBase::NodeUuid() const
     {
@@ -49,6 +74,12 @@ namespace gz
       return this->hUuid;
     }
 
+    /////////////////////////////////////////////////
+    const SubscribeOptions &SubscriptionHandlerBase::Options() const
+    {
+      return this->opts;
+    }
+
     /////////////////////////////////////////////////
     bool SubscriptionHandlerBase::UpdateThrottling()
     {
@@ -77,7 +108,27 @@ namespace gz
         const SubscribeOptions &_opts)
       : SubscriptionHandlerBase(_nUuid, _opts)
     {
-      // Do nothing
+      if (this->opts.UseArena())
+        this->arenas = std::make_shared<ArenaPool>();
+    }
+
+    /////////////////////////////////////////////////
+    bool ISubscriptionHandler::RunLocalCallback(
+        const std::shared_ptr<const ProtoMsg> &_msg,
+        const MessageInfo &_info)
+    {
+      if (!_msg)
+        return false;
+
+      return this->RunLocalCallback(*_msg, _info);
+    }
+
+    /////////////////////////////////////////////////
+    const std::shared_ptr<ProtoMsg> ISubscriptionHandler::CreateMsg(
+        const char *_data, const std::size_t _size,
+        const std::string &_type) const
+    {
+      return this->CreateMsg(std::string(_data, _size), _type);
     }
 
     /////////////////////////////////////////////////
@@ -102,7 +153,7 @@ namespace gz
       : SubscriptionHandlerBase(_nUuid, _opts),
         pimpl(new Implementation(_msgType))
     {
-      // Do nothing
+      this->typeId = InternTable::String(_msgType);
     }
 
     /////////////////////////////////////////////////
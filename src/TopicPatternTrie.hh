@@ -0,0 +1,312 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_TRANSPORT_TOPICPATTERNTRIE_HH_
+#define GZ_TRANSPORT_TOPICPATTERNTRIE_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "gz/transport/config.hh"
+
+namespace gz
+{
+  namespace transport
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE {
+    //
+    /// \class TopicPatternTrie TopicPatternTrie.hh
+    /// \brief Store values associated to topic patterns and find the ones
+    /// whose pattern matches a topic.
+    ///
+    /// The patterns are split in segments separated by '/'. A "*" segment
+    /// matches exactly one segment of the topic and a "**" segment matches
+    /// any number of segments, including none. Other segments must be equal.
+    /// E.g. "/model/*/pose" matches "/model/box/pose" and "/model/**"
+    /// matches every topic under "/model".
+    ///
+    /// The patterns are compiled into a trie of segments, so matching a
+    /// topic only walks the branches that can match it, regardless of the
+    /// number of patterns stored. Consecutive "**" segments are equivalent
+    /// to a single one and are stored as such.
+    /// \sa TopicUtils::IsTopicPattern
+    template<typename T> class TopicPatternTrie
+    {
+      /// \brief Constructor.
+      public: TopicPatternTrie() = default;
+
+      /// \brief Destructor.
+      public: virtual ~TopicPatternTrie() = default;
+
+      /// \brief Add a value associated to a pattern.
+      /// \param[in] _pattern Topic pattern.
+      /// \param[in] _value Value.
+      public: void Insert(const std::string &_pattern, const T &_value)
+      {
+        TrieNode *node = &this->root;
+        for (const auto &segment : SplitPattern(_pattern))
+        {
+          std::unique_ptr<TrieNode> &child = Child(*node, segment);
+          if (!child)
+            child.reset(new TrieNode());
+          node = child.get();
+        }
+
+        node->values.push_back(_value);
+        ++this->size;
+      }
+
+      /// \brief Remove the values of a pattern that satisfy a predicate.
+      /// \param[in] _pattern Topic pattern.
+      /// \param[in] _pred Predicate returning true for the values to remove.
+      /// \return The removed values.
+      public: std::vector<T> Remove(const std::string &_pattern,
+                  const std::function<bool(const T &)> &_pred)
+      {
+        std::vector<T> removed;
+        this->Remove(this->root, SplitPattern(_pattern), 0, _pred, removed);
+        this->size -= removed.size();
+        return removed;
+      }
+
+      /// \brief Get the values whose pattern matches a topic. Each value is
+      /// returned once, even if its pattern matches the topic in different
+      /// ways.
+      /// \param[in] _topic Topic name.
+      /// \param[out] _values The matching values are appended here.
+      /// \return True if at least one value matches.
+      public: bool Match(const std::string &_topic,
+                         std::vector<T> &_values) const
+      {
+        if (this->size == 0)
+          return false;
+
+        std::unordered_set<const TrieNode *> matched;
+        std::set<std::pair<const TrieNode *, std::size_t>> visited;
+        Match(this->root, Split(_topic), 0, visited, matched);
+
+        for (const TrieNode *node : matched)
+          _values.insert(_values.end(), node->values.begin(),
+            node->values.end());
+        return !matched.empty();
+      }
+
+      /// \brief Check if there are no patterns stored.
+      /// \return True if empty.
+      public: bool Empty() const
+      {
+        return this->size == 0;
+      }
+
+      /// \brief Segment matching exactly one segment.
+      public: static constexpr const char *kAnySegment = "*";
+
+      /// \brief Segment matching any number of segments.
+      public: static constexpr const char *kAnySegments = "**";
+
+      /// \brief Node of the trie.
+      private: struct TrieNode
+      {
+        /// \brief Children with a literal segment.
+        public: std::unordered_map<std::string, std::unique_ptr<TrieNode>>
+          children;
+
+        /// \brief Child with a "*" segment.
+        public: std::unique_ptr<TrieNode> anySegment;
+
+        /// \brief Child with a "**" segment.
+        public: std::unique_ptr<TrieNode> anySegments;
+
+        /// \brief Values of the pattern ending at this node.
+        public: std::vector<T> values;
+      };
+
+      /// \brief Split a topic in segments, ignoring the empty ones.
+      /// \param[in] _topic Topic name.
+      /// \return The segments.
+      private: static std::vector<std::string> Split(const std::string &_topic)
+      {
+        std::vector<std::string> segments;
+        std::size_t start = 0;
+        while (start <= _topic.size())
+        {
+          std::size_t end = _topic.find('/', start);
+          if (end == std::string::npos)
+            end = _topic.size();
+          if (end > start)
+            segments.push_back(_topic.substr(start, end - start));
+          start = end + 1;
+        }
+        return segments;
+      }
+
+      /// \brief Split a pattern in segments, ignoring the empty ones and
+      /// collapsing consecutive "**" segments.
+      /// \param[in] _pattern Topic pattern.
+      /// \return The segments.
+      private: static std::vector<std::string> SplitPattern(
+                   const std::string &_pattern)
+      {
+        std::vector<std::string> segments = Split(_pattern);
+        auto last = std::unique(segments.begin(), segments.end(),
+          [](const std::string &_a, const std::string &_b)
+          {
+            return _a == kAnySegments && _b == kAnySegments;
+          });
+        segments.erase(last, segments.end());
+        return segments;
+      }
+
+      /// \brief Get the child of a node for a segment.
+      /// \param[in] _node Parent node.
+      /// \param[in] _segment Pattern segment.
+      /// \return The pointer to the child, which might be null.
+      private: static std::unique_ptr<TrieNode> &Child(TrieNode &_node,
+                   const std::string &_segment)
+      {
+        if (_segment == kAnySegment)
+          return _node.anySegment;
+        if (_segment == kAnySegments)
+          return _node.anySegments;
+        return _node.children[_segment];
+      }
+
+      /// \brief Check if a node has no values and no children.
+      /// \param[in] _node The node.
+      /// \return True if the node can be pruned.
+      private: static bool Unused(const TrieNode &_node)
+      {
+        return _node.values.empty() && _node.children.empty() &&
+          !_node.anySegment && !_node.anySegments;
+      }
+
+      /// \brief Remove values below a node and prune the unused branches.
+      /// \param[in] _node Current node.
+      /// \param[in] _segments Segments of the pattern.
+      /// \param[in] _index Index of the next segment.
+      /// \param[in] _pred Predicate returning true for the values to remove.
+      /// \param[out] _removed The removed values are appended here.
+      private: static void Remove(TrieNode &_node,
+                   const std::vector<std::string> &_segments,
+                   const std::size_t _index,
+                   const std::function<bool(const T &)> &_pred,
+                   std::vector<T> &_removed)
+      {
+        if (_index == _segments.size())
+        {
+          auto &values = _node.values;
+          for (auto it = values.begin(); it != values.end();)
+          {
+            if (_pred(*it))
+            {
+              _removed.push_back(*it);
+              it = values.erase(it);
+            }
+            else
+              ++it;
+          }
+          return;
+        }
+
+        const std::string &segment = _segments[_index];
+        std::unique_ptr<TrieNode> *child;
+        if (segment == kAnySegment)
+          child = &_node.anySegment;
+        else if (segment == kAnySegments)
+          child = &_node.anySegments;
+        else
+        {
+          auto it = _node.children.find(segment);
+          if (it == _node.children.end())
+            return;
+          child = &it->second;
+        }
+
+        if (!*child)
+          return;
+
+        Remove(**child, _segments, _index + 1, _pred, _removed);
+        if (Unused(**child))
+        {
+          if (segment == kAnySegment || segment == kAnySegments)
+            child->reset();
+          else
+            _node.children.erase(segment);
+        }
+      }
+
+      /// \brief Collect the nodes below a node whose pattern matches the
+      /// rest of a topic.
+      /// \param[in] _node Current node.
+      /// \param[in] _segments Segments of the topic.
+      /// \param[in] _index Index of the next segment.
+      /// \param[in, out] _visited The node and index pairs already matched.
+      /// Each pair is only matched once, so patterns with several "**"
+      /// segments don't try the same split of the topic over and over.
+      /// \param[out] _matched The matching nodes with values.
+      private: static void Match(const TrieNode &_node,
+                   const std::vector<std::string> &_segments,
+                   const std::size_t _index,
+                   std::set<std::pair<const TrieNode *, std::size_t>>
+                     &_visited,
+                   std::unordered_set<const TrieNode *> &_matched)
+      {
+        if (!_visited.emplace(&_node, _index).second)
+          return;
+
+        // "**" consumes any number of the remaining segments.
+        if (_node.anySegments)
+        {
+          for (std::size_t i = _index; i <= _segments.size(); ++i)
+            Match(*_node.anySegments, _segments, i, _visited, _matched);
+        }
+
+        if (_index == _segments.size())
+        {
+          if (!_node.values.empty())
+            _matched.insert(&_node);
+          return;
+        }
+
+        auto it = _node.children.find(_segments[_index]);
+        if (it != _node.children.end())
+          Match(*it->second, _segments, _index + 1, _visited, _matched);
+
+        if (_node.anySegment)
+          Match(*_node.anySegment, _segments, _index + 1, _visited, _matched);
+      }
+
+      /// \brief Root of the trie.
+      private: TrieNode root;
+
+      /// \brief Number of values stored.
+      private: std::size_t size = 0;
+    };
+    }
+  }
+}
+
+#endif
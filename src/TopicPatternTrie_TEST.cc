@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "TopicPatternTrie.hh"
+
+using namespace gz;
+using namespace transport;
+
+//////////////////////////////////////////////////
+/// \brief Get the sorted values matching a topic.
+/// \param[in] _trie The trie.
+/// \param[in] _topic Topic name.
+/// \return The matching values.
+static std::vector<int> match(const TopicPatternTrie<int> &_trie,
+  const std::string &_topic)
+{
+  std::vector<int> values;
+  _trie.Match(_topic, values);
+  std::sort(values.begin(), values.end());
+  return values;
+}
+
+//////////////////////////////////////////////////
+/// \brief Check the matching of the different kinds of segments.
+TEST(TopicPatternTrieTest, Match)
+{
+  TopicPatternTrie<int> trie;
+  EXPECT_TRUE(trie.Empty());
+  EXPECT_TRUE(match(trie, "/model/box/pose").empty());
+
+  trie.Insert("/model/*/pose", 1);
+  trie.Insert("/model/**", 2);
+  trie.Insert("/model/box/pose", 3);
+  trie.Insert("/**/pose", 4);
+  trie.Insert("/model/*/pose", 5);
+  EXPECT_FALSE(trie.Empty());
+
+  EXPECT_EQ(std::vector<int>({1, 2, 3, 4, 5}),
+    match(trie, "/model/box/pose"));
+  EXPECT_EQ(std::vector<int>({1, 2, 4, 5}),
+    match(trie, "/model/sphere/pose"));
+  EXPECT_EQ(std::vector<int>({2}), match(trie, "/model/box/twist"));
+  EXPECT_EQ(std::vector<int>({2, 4}), match(trie, "/model/a/b/pose"));
+  EXPECT_EQ(std::vector<int>({2}), match(trie, "/model"));
+  EXPECT_EQ(std::vector<int>({4}), match(trie, "/pose"));
+  EXPECT_TRUE(match(trie, "/world/pose/x").empty());
+  EXPECT_TRUE(match(trie, "/models/box/pose/x").empty());
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that a value is returned once even if its pattern matches
+/// the topic in several ways.
+TEST(TopicPatternTrieTest, MatchOnce)
+{
+  TopicPatternTrie<int> trie;
+  trie.Insert("/**/**", 1);
+  trie.Insert("@/partition@/**", 2);
+
+  EXPECT_EQ(std::vector<int>({1}), match(trie, "/a/b/c"));
+  EXPECT_EQ(std::vector<int>({1, 2}), match(trie, "@/partition@/a/b"));
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that consecutive "**" segments are collapsed and that
+/// patterns with many "**" segments match long topics quickly.
+TEST(TopicPatternTrieTest, ManyAnySegments)
+{
+  TopicPatternTrie<int> trie;
+  trie.Insert("/a/**/**/**/b", 1);
+  EXPECT_EQ(std::vector<int>({1}), match(trie, "/a/b"));
+  EXPECT_EQ(std::vector<int>({1}), match(trie, "/a/x/y/b"));
+  EXPECT_EQ(std::vector<int>({1}),
+    trie.Remove("/a/**/b", [](const int &) {return true;}));
+  EXPECT_TRUE(trie.Empty());
+
+  // Without memoization, every split of the topic between the "**"
+  // segments would be tried.
+  std::string pattern;
+  for (int i = 0; i < 16; ++i)
+    pattern += "/**/x";
+  trie.Insert(pattern + "/end", 2);
+
+  std::string topic;
+  for (int i = 0; i < 64; ++i)
+    topic += "/x";
+  EXPECT_TRUE(match(trie, topic).empty());
+  EXPECT_EQ(std::vector<int>({2}), match(trie, topic + "/end"));
+}
+
+//////////////////////////////////////////////////
+/// \brief Check the removal of values.
+TEST(TopicPatternTrieTest, Remove)
+{
+  TopicPatternTrie<int> trie;
+  trie.Insert("/model/*/pose", 1);
+  trie.Insert("/model/*/pose", 2);
+  trie.Insert("/model/**", 3);
+
+  auto isOne = [](const int &_value) {return _value == 1;};
+  EXPECT_TRUE(trie.Remove("/model/box/pose", isOne).empty());
+  EXPECT_TRUE(trie.Remove("/model/**/pose", isOne).empty());
+  EXPECT_EQ(std::vector<int>({1}), trie.Remove("/model/*/pose", isOne));
+  EXPECT_EQ(std::vector<int>({2, 3}), match(trie, "/model/box/pose"));
+
+  auto all = [](const int &) {return true;};
+  EXPECT_EQ(std::vector<int>({2}), trie.Remove("/model/*/pose", all));
+  EXPECT_EQ(std::vector<int>({3}), match(trie, "/model/box/pose"));
+  EXPECT_EQ(std::vector<int>({3}), trie.Remove("/model/**", all));
+  EXPECT_TRUE(trie.Empty());
+  EXPECT_TRUE(match(trie, "/model/box/pose").empty());
+
+  // The pruned branches can be used again.
+  trie.Insert("/model/*/pose", 4);
+  EXPECT_EQ(std::vector<int>({4}), match(trie, "/model/box/pose"));
+}
@@ -501,3 +501,71 @@ TEST(TopicStorageTest, HasTopicWithType)
   EXPECT_TRUE(test.AddPublisher(publisher2));
   EXPECT_TRUE(test.HasTopic(g_topic1));
 }
+
+//////////////////////////////////////////////////
+/// \brief Check that the type, address and process indexes follow the
+/// changes of the storage.
+TEST(TopicStorageTest, Indexes)
+{
+  init();
+
+  std::string ctrl = "ctrl_address";
+  AdvertiseMessageOptions opts;
+  MessagePublisher publisher1(g_topic1, g_addr1, ctrl, g_pUuid1, g_nUuid1,
+    "type1", opts);
+  MessagePublisher publisher2(g_topic1, g_addr1, ctrl, g_pUuid1, g_nUuid2,
+    "type2", opts);
+  MessagePublisher publisher3(g_topic2, g_addr1, ctrl, g_pUuid1, g_nUuid1,
+    "type1", opts);
+  MessagePublisher publisher4(g_topic2, g_addr2, ctrl, g_pUuid2, g_nUuid3,
+    kGenericMessageType, opts);
+
+  TopicStorage<MessagePublisher> test;
+  EXPECT_TRUE(test.AddPublisher(publisher1));
+  EXPECT_TRUE(test.AddPublisher(publisher2));
+  EXPECT_TRUE(test.AddPublisher(publisher3));
+  EXPECT_TRUE(test.AddPublisher(publisher4));
+
+  EXPECT_TRUE(test.HasTopic(g_topic1, "type1"));
+  EXPECT_TRUE(test.HasTopic(g_topic1, "type2"));
+  EXPECT_FALSE(test.HasTopic(g_topic1, "type3"));
+
+  // A generic publisher matches any type.
+  EXPECT_TRUE(test.HasTopic(g_topic2, "type3"));
+
+  // The topics are listed in order.
+  std::vector<std::string> topics;
+  test.TopicList(topics);
+  EXPECT_EQ((std::vector<std::string>{g_topic1, g_topic2}), topics);
+
+  std::vector<MessagePublisher> pubs;
+  test.PublishersByNode(g_pUuid1, g_nUuid1, pubs);
+  EXPECT_EQ(2u, pubs.size());
+
+  // Removing a node only updates the indexes of its publishers.
+  EXPECT_TRUE(test.DelPublisherByNode(g_topic1, g_pUuid1, g_nUuid2));
+  EXPECT_FALSE(test.HasTopic(g_topic1, "type2"));
+  EXPECT_TRUE(test.HasTopic(g_topic1, "type1"));
+  EXPECT_TRUE(test.HasPublisher(g_addr1));
+
+  std::map<std::string, std::vector<MessagePublisher>> byProc;
+  test.PublishersByProc(g_pUuid1, byProc);
+  ASSERT_EQ(1u, byProc.size());
+  EXPECT_EQ(2u, byProc[g_nUuid1].size());
+
+  // Removing a process keeps the publishers of the other processes.
+  EXPECT_TRUE(test.DelPublishersByProc(g_pUuid1));
+  EXPECT_FALSE(test.DelPublishersByProc(g_pUuid1));
+  EXPECT_FALSE(test.HasTopic(g_topic1));
+  EXPECT_TRUE(test.HasTopic(g_topic2, "type3"));
+  EXPECT_FALSE(test.HasPublisher(g_addr1));
+  EXPECT_TRUE(test.HasPublisher(g_addr2));
+  test.PublishersByProc(g_pUuid1, byProc);
+  EXPECT_TRUE(byProc.empty());
+  test.PublishersByProc(g_pUuid2, byProc);
+  EXPECT_EQ(1u, byProc.size());
+
+  // The process can publish again.
+  EXPECT_TRUE(test.AddPublisher(publisher1));
+  EXPECT_TRUE(test.HasTopic(g_topic1, "type1"));
+}
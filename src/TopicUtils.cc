@@ -74,6 +74,27 @@ bool TopicUtils::IsValidTopic(const std::string &_topic)
   return IsValidNamespace(_topic) && !_topic.empty();
 }
 
+//////////////////////////////////////////////////
+bool TopicUtils::IsTopicPattern(const std::string &_topic)
+{
+  std::size_t start = 0;
+  while (start <= _topic.size())
+  {
+    std::size_t end = _topic.find('/', start);
+    if (end == std::string::npos)
+      end = _topic.size();
+
+    const std::size_t length = end - start;
+    if ((length == 1 || length == 2) &&
+        _topic.compare(start, length, "**", length) == 0)
+    {
+      return true;
+    }
+    start = end + 1;
+  }
+  return false;
+}
+
 //////////////////////////////////////////////////
 bool TopicUtils::FullyQualifiedName(const std::string &_partition,
   const std::string &_ns, const std::string &_topic, std::string &_name)
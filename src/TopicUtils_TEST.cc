@@ -54,6 +54,27 @@ TEST(TopicUtilsTest, testTopics)
     std::string(transport::TopicUtils::kMaxNameLength + 1, 'a')));
 }
 
+//////////////////////////////////////////////////
+/// \brief Check the topic patterns.
+TEST(TopicUtilsTest, testTopicPatterns)
+{
+  EXPECT_TRUE(transport::TopicUtils::IsTopicPattern("*"));
+  EXPECT_TRUE(transport::TopicUtils::IsTopicPattern("/model/*/pose"));
+  EXPECT_TRUE(transport::TopicUtils::IsTopicPattern("/model/**"));
+  EXPECT_TRUE(transport::TopicUtils::IsTopicPattern("**/pose"));
+  EXPECT_TRUE(transport::TopicUtils::IsTopicPattern("@/partition@/a/*"));
+
+  EXPECT_FALSE(transport::TopicUtils::IsTopicPattern(""));
+  EXPECT_FALSE(transport::TopicUtils::IsTopicPattern("/model/box/pose"));
+  EXPECT_FALSE(transport::TopicUtils::IsTopicPattern("/model/box*/pose"));
+  EXPECT_FALSE(transport::TopicUtils::IsTopicPattern("/model/***"));
+  EXPECT_FALSE(transport::TopicUtils::IsTopicPattern("/a*b"));
+
+  // Patterns are valid topic names.
+  EXPECT_TRUE(transport::TopicUtils::IsValidTopic("/model/*/pose"));
+  EXPECT_TRUE(transport::TopicUtils::IsValidTopic("/model/**"));
+}
+
 //////////////////////////////////////////////////
 /// \brief Check the namespace.
 TEST(TopicUtilsTest, testNamespaces)
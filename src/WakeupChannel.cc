@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <zmq.hpp>
+
+#include <iostream>
+#include <memory>
+#include <mutex>
+
+#include "gz/transport/WakeupChannel.hh"
+
+namespace gz
+{
+  namespace transport
+  {
+    inline namespace GZ_TRANSPORT_VERSION_NAMESPACE
+    {
+    /// \internal
+    /// \brief Private data for WakeupChannel.
+    class WakeupChannelPrivate
+    {
+      /// \brief Inproc endpoint of the channel. Each channel has its own
+      /// context, so the name does not need to be unique.
+      public: static constexpr const char *kEndpoint =
+        "inproc://gz-transport-wakeup";
+
+      /// \brief Context of the channel. It only serves inproc sockets, so
+      /// it does not need any I/O thread. Always declare this object before
+      /// the sockets to make sure that it is destroyed after them.
+      public: zmq::context_t context{0};
+
+      /// \brief Socket polled by the thread to wake up.
+      public: zmq::socket_t receiver{context, ZMQ_PAIR};
+
+      /// \brief Socket used by Notify().
+      public: zmq::socket_t sender{context, ZMQ_PAIR};
+
+      /// \brief Serializes the use of the sender, since ZMQ sockets are not
+      /// thread-safe.
+      public: std::mutex senderMutex;
+    };
+    }
+  }
+}
+
+using namespace gz;
+using namespace transport;
+
+//////////////////////////////////////////////////
+WakeupChannel::WakeupChannel()
+  : dataPtr(new WakeupChannelPrivate())
+{
+  const int kZero = 0;
+  const int kOne = 1;
+  try
+  {
+    // One pending notification is enough to wake up the thread.
+    this->dataPtr->receiver.setsockopt(ZMQ_RCVHWM, &kOne, sizeof(kOne));
+    this->dataPtr->receiver.setsockopt(ZMQ_LINGER, &kZero, sizeof(kZero));
+    this->dataPtr->sender.setsockopt(ZMQ_SNDHWM, &kOne, sizeof(kOne));
+    this->dataPtr->sender.setsockopt(ZMQ_LINGER, &kZero, sizeof(kZero));
+
+    this->dataPtr->receiver.bind(WakeupChannelPrivate::kEndpoint);
+    this->dataPtr->sender.connect(WakeupChannelPrivate::kEndpoint);
+  }
+  catch(const zmq::error_t &_e)
+  {
+    std::cerr << "WakeupChannel() error: " << _e.what() << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+WakeupChannel::~WakeupChannel()
+{
+}
+
+//////////////////////////////////////////////////
+void WakeupChannel::Notify()
+{
+  std::lock_guard<std::mutex> lk(this->dataPtr->senderMutex);
+
+  // Fails with EAGAIN if a notification is already pending, which is fine.
+  const char signal = 0;
+  zmq_send(static_cast<void *>(this->dataPtr->sender), &signal,
+    sizeof(signal), ZMQ_DONTWAIT);
+}
+
+//////////////////////////////////////////////////
+bool WakeupChannel::Drain()
+{
+  bool notified = false;
+  char signal;
+  while (zmq_recv(static_cast<void *>(this->dataPtr->receiver), &signal,
+           sizeof(signal), ZMQ_DONTWAIT) >= 0)
+  {
+    notified = true;
+  }
+  return notified;
+}
+
+//////////////////////////////////////////////////
+void *WakeupChannel::Socket() const
+{
+  return static_cast<void *>(this->dataPtr->receiver);
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <zmq.hpp>
+
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "gz/transport/WakeupChannel.hh"
+
+using namespace gz;
+using namespace transport;
+
+//////////////////////////////////////////////////
+/// \brief Poll the socket of a wakeup channel.
+/// \param[in] _channel The channel.
+/// \param[in] _timeout Poll timeout (ms). Negative waits indefinitely.
+/// \return True if the socket is readable.
+static bool pollChannel(WakeupChannel &_channel, const int _timeout)
+{
+  zmq::pollitem_t items[] =
+  {
+    {_channel.Socket(), 0, ZMQ_POLLIN, 0},
+  };
+  zmq::poll(&items[0], 1, std::chrono::milliseconds(_timeout));
+  return items[0].revents & ZMQ_POLLIN;
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that notifications make the socket readable and that they
+/// are coalesced.
+TEST(WakeupChannelTest, NotifyAndDrain)
+{
+  WakeupChannel channel;
+  ASSERT_NE(nullptr, channel.Socket());
+
+  EXPECT_FALSE(pollChannel(channel, 0));
+  EXPECT_FALSE(channel.Drain());
+
+  channel.Notify();
+  channel.Notify();
+  channel.Notify();
+  EXPECT_TRUE(pollChannel(channel, 0));
+  EXPECT_TRUE(channel.Drain());
+
+  // All the notifications were consumed.
+  EXPECT_FALSE(pollChannel(channel, 0));
+  EXPECT_FALSE(channel.Drain());
+}
+
+//////////////////////////////////////////////////
+/// \brief Check that a notification from another thread interrupts a poll
+/// without timeout.
+TEST(WakeupChannelTest, WakeupBlockedThread)
+{
+  WakeupChannel channel;
+
+  bool woken = false;
+  std::thread poller([&channel, &woken]()
+  {
+    woken = pollChannel(channel, -1);
+    channel.Drain();
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  channel.Notify();
+  poller.join();
+  EXPECT_TRUE(woken);
+}
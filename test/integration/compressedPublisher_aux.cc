@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gz/msgs/bytes.pb.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "gz/transport/AdvertiseOptions.hh"
+#include "gz/transport/Helpers.hh"
+#include "gz/transport/Node.hh"
+#include "test_config.hh"
+
+using namespace gz;
+
+static std::string g_topic = "/foo"; // NOLINT(*)
+
+//////////////////////////////////////////////////
+/// \brief A publisher node sending large compressible messages.
+/// \param[in] _codec Name of the compression codec.
+void advertiseAndPublish(const std::string &_codec)
+{
+  gz::msgs::Bytes msg;
+  std::string data;
+  for (int i = 0; i < 100000; ++i)
+    data += static_cast<char>('a' + (i / 1000) % 26);
+  msg.set_data(data);
+
+  transport::AdvertiseMessageOptions opts;
+  if (_codec == "lz4")
+    opts.SetCompression(transport::Compression_t::LZ4);
+  else if (_codec == "zstd")
+    opts.SetCompression(transport::Compression_t::ZSTD);
+  opts.SetCompressionThreshold(1024u);
+
+  transport::Node node;
+
+  auto pub = node.Advertise<gz::msgs::Bytes>(g_topic, opts);
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  pub.Publish(msg);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  pub.Publish(msg);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  if (argc != 2)
+  {
+    std::cerr << "Partition name has not be passed as argument" << std::endl;
+    return -1;
+  }
+
+  // Set the partition name for this test.
+  setenv("GZ_PARTITION", argv[1], 1);
+
+  // The codec is inherited from the test process.
+  std::string codec;
+  gz::transport::env("COMPRESSION_TEST_CODEC", codec);
+
+  advertiseAndPublish(codec);
+}
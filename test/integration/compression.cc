@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gz/msgs/bytes.pb.h>
+
+#include <mutex>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "gz/transport/Compression.hh"
+#include "gz/transport/MessageInfo.hh"
+#include "gz/transport/Node.hh"
+#include "gz/transport/TransportTypes.hh"
+#include "test_config.hh"
+
+using namespace gz;
+
+static std::string partition;  // NOLINT(*)
+static const std::string g_topic = "/foo";  // NOLINT(*)
+static std::mutex cbMutex;
+static int counter = 0;
+static int rawCounter = 0;
+
+//////////////////////////////////////////////////
+/// \brief Initialize some global variables.
+void reset()
+{
+  std::lock_guard<std::mutex> lk(cbMutex);
+  counter = 0;
+  rawCounter = 0;
+}
+
+//////////////////////////////////////////////////
+/// \brief Check the content sent by compressedPublisher_aux.
+/// \param[in] _data The received bytes.
+void checkData(const std::string &_data)
+{
+  ASSERT_EQ(100000u, _data.size());
+  for (std::size_t i = 0; i < _data.size(); i += 997)
+    EXPECT_EQ(static_cast<char>('a' + (i / 1000) % 26), _data[i]);
+}
+
+//////////////////////////////////////////////////
+/// \brief Function called each time a topic update is received.
+void cb(const gz::msgs::Bytes &_msg)
+{
+  checkData(_msg.data());
+
+  std::lock_guard<std::mutex> lk(cbMutex);
+  ++counter;
+}
+
+//////////////////////////////////////////////////
+/// \brief Raw subscribers get the uncompressed serialized message.
+void rawCb(const char *_data, const std::size_t _size,
+           const gz::transport::MessageInfo &)
+{
+  EXPECT_FALSE(transport::isCompressed(_data, _size));
+  gz::msgs::Bytes msg;
+  ASSERT_TRUE(msg.ParseFromArray(_data, static_cast<int>(_size)));
+  checkData(msg.data());
+
+  std::lock_guard<std::mutex> lk(cbMutex);
+  ++rawCounter;
+}
+
+//////////////////////////////////////////////////
+/// \brief Receive messages from a publisher using a codec.
+/// \param[in] _codec Name of the codec used by the publisher.
+void pubSub(const std::string &_codec)
+{
+  setenv("COMPRESSION_TEST_CODEC", _codec.c_str(), 1);
+
+  std::string publisherPath = testing::portablePathUnion(
+     GZ_TRANSPORT_TEST_DIR,
+     "INTEGRATION_compressedPublisher_aux");
+
+  testing::forkHandlerType pi = testing::forkAndRun(publisherPath.c_str(),
+    partition.c_str());
+
+  reset();
+
+  transport::Node node;
+  EXPECT_TRUE(node.Subscribe(g_topic, cb));
+  EXPECT_TRUE(node.SubscribeRaw(g_topic, rawCb,
+    gz::msgs::Bytes().GetTypeName()));
+
+  testing::waitAndCleanupFork(pi);
+
+  std::lock_guard<std::mutex> lk(cbMutex);
+  EXPECT_GT(counter, 0);
+  EXPECT_EQ(counter, rawCounter);
+}
+
+//////////////////////////////////////////////////
+/// \brief Messages compressed with LZ4. The publisher falls back to
+/// uncompressed messages if LZ4 is not available.
+TEST(compression, PubSubLz4)
+{
+  pubSub("lz4");
+}
+
+//////////////////////////////////////////////////
+/// \brief Messages compressed with Zstandard. The publisher falls back to
+/// uncompressed messages if Zstandard is not available.
+TEST(compression, PubSubZstd)
+{
+  pubSub("zstd");
+}
+
+//////////////////////////////////////////////////
+/// \brief Messages sent uncompressed.
+TEST(compression, PubSubUncompressed)
+{
+  pubSub("none");
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  // Get a random partition name.
+  partition = testing::getRandomNumber();
+
+  // Set the partition name for this process.
+  setenv("GZ_PARTITION", partition.c_str(), 1);
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
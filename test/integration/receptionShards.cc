@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gz/msgs/vector3d.pb.h>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "gz/transport/MessageInfo.hh"
+#include "gz/transport/Node.hh"
+#include "gz/transport/TransportTypes.hh"
+#include "test_config.hh"
+
+using namespace gz;
+
+static std::string partition;  // NOLINT(*)
+static const std::string g_topic = "/foo";  // NOLINT(*)
+static std::mutex cbMutex;
+static int counter = 0;
+
+//////////////////////////////////////////////////
+/// \brief Initialize some global variables.
+void reset()
+{
+  std::lock_guard<std::mutex> lk(cbMutex);
+  counter = 0;
+}
+
+//////////////////////////////////////////////////
+/// \brief Function called each time a topic update is received.
+void cb(const gz::msgs::Vector3d &_msg,
+        const gz::transport::MessageInfo &_info)
+{
+  EXPECT_EQ(g_topic, _info.Topic());
+  EXPECT_FALSE(_info.IntraProcess());
+  EXPECT_DOUBLE_EQ(1.0, _msg.x());
+  EXPECT_DOUBLE_EQ(2.0, _msg.y());
+  EXPECT_DOUBLE_EQ(3.0, _msg.z());
+
+  std::lock_guard<std::mutex> lk(cbMutex);
+  ++counter;
+}
+
+//////////////////////////////////////////////////
+/// \brief Receive messages from another process when the subscriptions are
+/// spread across several subscriber sockets.
+TEST(receptionShards, PubSub)
+{
+  std::string publisherPath = testing::portablePathUnion(
+     GZ_TRANSPORT_TEST_DIR,
+     "INTEGRATION_twoProcsPublisher_aux");
+
+  testing::forkHandlerType pi = testing::forkAndRun(publisherPath.c_str(),
+    partition.c_str());
+
+  reset();
+
+  transport::Node node;
+  EXPECT_TRUE(node.Subscribe(g_topic, cb));
+
+  testing::waitAndCleanupFork(pi);
+
+  std::lock_guard<std::mutex> lk(cbMutex);
+  EXPECT_GT(counter, 0);
+}
+
+//////////////////////////////////////////////////
+/// \brief Same as PubSub, with the compact header. Its subscription filter
+/// must be added to the shard of the topic.
+TEST(receptionShards, PubSubCompactHeader)
+{
+  setenv("GZ_TRANSPORT_COMPACT_HEADER", "1", 1);
+
+  std::string publisherPath = testing::portablePathUnion(
+     GZ_TRANSPORT_TEST_DIR,
+     "INTEGRATION_twoProcsPublisher_aux");
+
+  testing::forkHandlerType pi = testing::forkAndRun(publisherPath.c_str(),
+    partition.c_str());
+
+  reset();
+
+  transport::Node node;
+  EXPECT_TRUE(node.Subscribe(g_topic, cb));
+
+  testing::waitAndCleanupFork(pi);
+
+  std::lock_guard<std::mutex> lk(cbMutex);
+  EXPECT_GT(counter, 0);
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  // Get a random partition name.
+  partition = testing::getRandomNumber();
+
+  // Set the partition name for this process.
+  setenv("GZ_PARTITION", partition.c_str(), 1);
+
+  // Spread the subscriptions of this process across several sockets.
+  setenv("GZ_TRANSPORT_RECEPTION_SHARDS", "4", 1);
+  setenv("GZ_TRANSPORT_COMPACT_HEADER", "1", 1);
+  transport::NodeShared::Instance();
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
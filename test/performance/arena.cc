@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gz/msgs/model.pb.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "gz/transport/SubscribeOptions.hh"
+#include "gz/transport/SubscriptionHandler.hh"
+#include "gz/transport/TransportTypes.hh"
+
+using namespace gz;
+
+/// \brief Number of deserializations per configuration.
+static const int kIterations = 2000;
+
+//////////////////////////////////////////////////
+/// \brief Create a model with many small nested messages.
+/// \param[in] _links Number of links.
+/// \return The serialized model.
+static std::string nestedModel(const int _links)
+{
+  msgs::Model model;
+  model.set_name("benchmark_model");
+  for (int i = 0; i < _links; ++i)
+  {
+    msgs::Link *link = model.add_link();
+    link->set_name("link_" + std::to_string(i));
+    link->mutable_pose()->mutable_position()->set_x(i);
+    for (int j = 0; j < 4; ++j)
+    {
+      msgs::Visual *visual = link->add_visual();
+      visual->set_name("visual_" + std::to_string(j));
+      visual->mutable_pose()->mutable_orientation()->set_w(1);
+      visual->mutable_geometry()->mutable_box()->mutable_size()->set_x(j);
+      visual->mutable_material()->mutable_diffuse()->set_r(0.5);
+
+      msgs::Collision *collision = link->add_collision();
+      collision->set_name("collision_" + std::to_string(j));
+      collision->mutable_geometry()->mutable_sphere()->set_radius(j);
+    }
+  }
+  return model.SerializeAsString();
+}
+
+//////////////////////////////////////////////////
+/// \brief Time the deserialization of one message with a handler.
+/// \param[in] _handler The subscription handler.
+/// \param[in] _data The serialized message.
+/// \param[in] _type The message type.
+/// \return Average time per message (ns).
+static int64_t deserialize(const transport::ISubscriptionHandler &_handler,
+  const std::string &_data, const std::string &_type)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i)
+  {
+    auto msg = _handler.CreateMsg(_data.data(), _data.size(), _type);
+    EXPECT_NE(nullptr, msg);
+  }
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - start).count() / kIterations;
+}
+
+//////////////////////////////////////////////////
+/// \brief Compare heap and arena deserialization of nested messages with
+/// typed and generic handlers.
+TEST(ArenaPerformance, CreateMsg)
+{
+  const std::string type = msgs::Model().GetTypeName();
+
+  transport::SubscribeOptions arenaOpts;
+  arenaOpts.SetUseArena(true);
+
+  transport::SubscriptionHandler<msgs::Model> typedHeap("node");
+  transport::SubscriptionHandler<msgs::Model> typedArena("node", arenaOpts);
+  transport::SubscriptionHandler<transport::ProtoMsg> genericHeap("node");
+  transport::SubscriptionHandler<transport::ProtoMsg> genericArena("node",
+    arenaOpts);
+
+  for (const int links : {1, 10, 100})
+  {
+    const std::string data = nestedModel(links);
+
+    std::cout << "Model [" << links << " links, " << data.size() << " B]\n"
+              << "\tTyped heap:     "
+              << deserialize(typedHeap, data, type) << " ns/msg\n"
+              << "\tTyped arena:    "
+              << deserialize(typedArena, data, type) << " ns/msg\n"
+              << "\tGeneric heap:   "
+              << deserialize(genericHeap, data, type) << " ns/msg\n"
+              << "\tGeneric arena:  "
+              << deserialize(genericArena, data, type) << " ns/msg"
+              << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gz/msgs/bytes.pb.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gz/transport/BufferPool.hh"
+#include "gz/transport/MessageInfo.hh"
+#include "gz/transport/Node.hh"
+#include "gz/transport/NodeShared.hh"
+#include "gz/transport/TransportTypes.hh"
+#include "test_config.hh"
+
+using namespace gz;
+
+/// \brief Message sizes used in the benchmarks (bytes).
+static const std::vector<std::size_t> kSizes = {64, 1024, 65536, 1048576};
+
+/// \brief Number of buffers requested per message size.
+static const int kIterations = 10000;
+
+/// \brief Number of publications per message size.
+static const int kPublications = 1000;
+
+//////////////////////////////////////////////////
+/// \brief Time the allocation of one buffer per publication with the heap
+/// (previous behavior) and with the buffer pool.
+TEST(BufferPoolPerformance, AllocationRate)
+{
+  for (const std::size_t size : kSizes)
+  {
+    // Heap: one allocation per publication.
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i)
+    {
+      char *buffer = new char[size];
+      buffer[0] = static_cast<char>(i);
+      delete[] buffer;
+    }
+    auto heapNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start).count();
+
+    // Pool: allocations only until the size class is warm.
+    transport::BufferPool pool;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i)
+    {
+      char *buffer = pool.Acquire(size);
+      buffer[0] = static_cast<char>(i);
+      transport::BufferPool::Deallocate(buffer, &pool);
+    }
+    auto poolNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Size [" << size << " B]\n"
+              << "\tHeap: " << kIterations << " allocations, "
+              << heapNs / kIterations << " ns/buffer\n"
+              << "\tPool: " << pool.Misses() << " allocations, "
+              << pool.Hits() << " hits, "
+              << poolNs / kIterations << " ns/buffer" << std::endl;
+
+    EXPECT_EQ(1u, pool.Misses());
+    EXPECT_EQ(static_cast<uint64_t>(kIterations - 1), pool.Hits());
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Publish with a raw subscriber, which forces serialization, and
+/// report how many serialization buffers came from the heap.
+TEST(BufferPoolPerformance, PublishAllocationRate)
+{
+  const std::string topic = "/buffer_pool_performance";
+  transport::Node node;
+
+  auto pub = node.Advertise<msgs::Bytes>(topic);
+  ASSERT_TRUE(pub);
+
+  transport::RawCallback rawCb =
+    [](const char *, const std::size_t, const transport::MessageInfo &)
+    {
+    };
+  ASSERT_TRUE(node.SubscribeRaw(topic, rawCb, msgs::Bytes().GetTypeName()));
+
+  auto &pool = transport::NodeShared::Instance()->SerializationBufferPool();
+
+  for (const std::size_t size : kSizes)
+  {
+    msgs::Bytes msg;
+    msg.set_data(std::string(size, 'x'));
+
+    const uint64_t hits = pool.Hits();
+    const uint64_t misses = pool.Misses();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kPublications; ++i)
+      EXPECT_TRUE(pub.Publish(msg));
+    auto elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Publish [" << size << " B]: "
+              << elapsedNs / kPublications << " ns/msg, "
+              << pool.Misses() - misses << " allocations, "
+              << pool.Hits() - hits << " hits, "
+              << pool.BytesHeld() << " bytes held" << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  // Get a random partition name.
+  std::string partition = testing::getRandomNumber();
+
+  // Set the partition name for this process.
+  setenv("GZ_PARTITION", partition.c_str(), 1);
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gz/transport/Compression.hh"
+
+using namespace gz;
+
+/// \brief Number of iterations per payload and codec.
+static const int kIterations = 20;
+
+/// \brief A named payload.
+struct Payload
+{
+  /// \brief Name printed in the results.
+  std::string name;
+
+  /// \brief Payload bytes.
+  std::string data;
+};
+
+//////////////////////////////////////////////////
+/// \brief Payloads similar to the large messages of a simulation.
+/// \return The payloads.
+std::vector<Payload> payloads()
+{
+  std::vector<Payload> result;
+
+  // 640x480 RGB camera image with smooth gradients.
+  Payload image{"Image 640x480 RGB", std::string(640 * 480 * 3, '\0')};
+  for (int y = 0; y < 480; ++y)
+  {
+    for (int x = 0; x < 640; ++x)
+    {
+      const std::size_t i = static_cast<std::size_t>((y * 640 + x) * 3);
+      image.data[i] = static_cast<char>(x / 3);
+      image.data[i + 1] = static_cast<char>(y / 2);
+      image.data[i + 2] = static_cast<char>((x + y) / 5);
+    }
+  }
+  result.push_back(image);
+
+  // Point cloud of 100k XYZ float points on a wavy surface.
+  Payload cloud{"Point cloud 100k XYZ", ""};
+  cloud.data.reserve(100000 * 3 * sizeof(float));
+  for (int i = 0; i < 100000; ++i)
+  {
+    const float point[3] = {
+      static_cast<float>(i % 316) * 0.01f,
+      static_cast<float>(i / 316) * 0.01f,
+      std::sin(static_cast<float>(i % 316) * 0.05f)};
+    cloud.data.append(reinterpret_cast<const char *>(point), sizeof(point));
+  }
+  result.push_back(cloud);
+
+  // 1000x1000 occupancy grid, mostly free space.
+  Payload map{"Occupancy grid 1000x1000", std::string(1000 * 1000, '\0')};
+  for (std::size_t i = 0; i < map.data.size(); i += 37)
+    map.data[i] = static_cast<char>(100);
+  result.push_back(map);
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+/// \brief Report the compression ratio and throughput of each codec.
+TEST(CompressionPerformance, Throughput)
+{
+  const std::vector<std::pair<std::string, transport::Compression_t>>
+    codecs = {{"LZ4", transport::Compression_t::LZ4},
+              {"ZSTD", transport::Compression_t::ZSTD}};
+
+  for (const auto &payload : payloads())
+  {
+    const std::size_t size = payload.data.size();
+    std::cout << payload.name << " [" << size << " B]" << std::endl;
+
+    for (const auto &codec : codecs)
+    {
+      if (!(transport::supportedCodecs() &
+            transport::codecMask(codec.second)))
+      {
+        std::cout << "\t" << codec.first << ": not available" << std::endl;
+        continue;
+      }
+
+      std::vector<char> out(
+        transport::maxCompressedSize(codec.second, size));
+      std::size_t compressedSize = 0;
+
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < kIterations; ++i)
+      {
+        compressedSize = transport::compress(codec.second,
+          payload.data.data(), size, out.data(), out.size());
+      }
+      const double compressSec = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+      ASSERT_GT(compressedSize, 0u);
+
+      std::string result;
+      start = std::chrono::steady_clock::now();
+      for (int i = 0; i < kIterations; ++i)
+        EXPECT_TRUE(transport::decompress(out.data(), compressedSize, result));
+      const double decompressSec = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+      EXPECT_EQ(payload.data, result);
+
+      const double mb = static_cast<double>(size) * kIterations / 1e6;
+      std::cout << "\t" << codec.first << ": ratio "
+                << static_cast<double>(size) / compressedSize
+                << ", compress " << mb / compressSec << " MB/s"
+                << ", decompress " << mb / decompressSec << " MB/s"
+                << std::endl;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gz/msgs/int32.pb.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "gz/transport/InternTable.hh"
+#include "gz/transport/MessageInfo.hh"
+#include "gz/transport/Node.hh"
+#include "gz/transport/SubscribeOptions.hh"
+#include "gz/transport/SubscriptionHandler.hh"
+#include "gz/transport/TopicUtils.hh"
+#include "test_config.hh"
+
+using namespace gz;
+
+/// \brief Number of iterations per measurement.
+static const int kIterations = 100000;
+
+//////////////////////////////////////////////////
+/// \brief Time an operation.
+/// \param[in] _op The operation, executed kIterations times.
+/// \return Average time per iteration (ns).
+template<typename Op>
+static int64_t timeNs(Op _op)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i)
+    _op(i);
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - start).count() / kIterations;
+}
+
+//////////////////////////////////////////////////
+/// \brief Compare parsing the fully qualified topic name of every message
+/// (previous behavior) with the interned topic used by MessageInfo.
+TEST(DispatchPerformance, MessageInfo)
+{
+  const std::string fq = "@/benchmark_partition@/benchmark/topic";
+
+  const int64_t parseNs = timeNs([&fq](int)
+  {
+    std::string partition;
+    std::string topic;
+    EXPECT_TRUE(
+      transport::TopicUtils::DecomposeFullyQualifiedTopic(fq, partition,
+        topic));
+  });
+
+  const int64_t internNs = timeNs([&fq](int)
+  {
+    transport::MessageInfo info;
+    EXPECT_TRUE(info.SetTopicAndPartition(fq));
+    info.SetType("gz.msgs.Int32");
+  });
+
+  std::cout << "MessageInfo\n"
+            << "\tParse topic:        " << parseNs << " ns/msg\n"
+            << "\tInterned info:      " << internNs << " ns/msg" << std::endl;
+}
+
+//////////////////////////////////////////////////
+/// \brief Compare matching a handler by type name (previous behavior, which
+/// built a temporary message to get the name) with the interned type.
+TEST(DispatchPerformance, TypeMatch)
+{
+  transport::SubscriptionHandler<msgs::Int32> handler("node");
+  const std::string type = msgs::Int32().GetTypeName();
+  const std::string *typeId = transport::InternTable::String(type);
+
+  const int64_t nameNs = timeNs([&type](int)
+  {
+    EXPECT_EQ(type, msgs::Int32().GetTypeName());
+  });
+
+  const int64_t idNs = timeNs([&handler, typeId](int)
+  {
+    EXPECT_TRUE(handler.AcceptsType(typeId));
+  });
+
+  std::cout << "Handler type match\n"
+            << "\tType name:          " << nameNs << " ns/msg\n"
+            << "\tInterned type:      " << idNs << " ns/msg" << std::endl;
+}
+
+//////////////////////////////////////////////////
+/// \brief Measure the cost per message of an intra-process publication
+/// dispatched to a local subscriber.
+TEST(DispatchPerformance, LocalPublish)
+{
+  const std::string topic = "/dispatch_performance";
+  transport::Node node;
+
+  auto pub = node.Advertise<msgs::Int32>(topic);
+  ASSERT_TRUE(pub);
+
+  std::atomic<int> received{0};
+  std::function<void(const msgs::Int32 &)> cb =
+    [&received](const msgs::Int32 &)
+    {
+      ++received;
+    };
+  ASSERT_TRUE(node.Subscribe(topic, cb));
+
+  msgs::Int32 msg;
+  const int64_t publishNs = timeNs([&pub, &msg](int _i)
+  {
+    msg.set_data(_i);
+    EXPECT_TRUE(pub.Publish(msg));
+  });
+
+  std::cout << "Local publish: " << publishNs << " ns/msg, "
+            << received << " callbacks" << std::endl;
+}
+
+//////////////////////////////////////////////////
+/// \brief Measure the end-to-end latency of an intra-process publication,
+/// from Publish() to the callback, with the queued and the inline delivery.
+TEST(DispatchPerformance, InlineLatency)
+{
+  for (const bool inlineDelivery : {false, true})
+  {
+    const std::string topic = inlineDelivery ?
+      "/dispatch_inline" : "/dispatch_queued";
+    transport::Node node;
+
+    auto pub = node.Advertise<msgs::Int32>(topic);
+    ASSERT_TRUE(pub);
+
+    std::atomic<int> received{0};
+    std::atomic<int64_t> totalNs{0};
+    std::chrono::steady_clock::time_point sent;
+    std::function<void(const msgs::Int32 &)> cb =
+      [&received, &totalNs, &sent](const msgs::Int32 &)
+      {
+        totalNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - sent).count();
+        received.store(received + 1, std::memory_order_release);
+      };
+
+    transport::SubscribeOptions opts;
+    opts.SetInlineDelivery(inlineDelivery);
+    ASSERT_TRUE(node.Subscribe(topic, cb, opts));
+
+    // One message in flight at a time, so each one is measured alone.
+    const int kMsgs = kIterations / 10;
+    msgs::Int32 msg;
+    for (int i = 0; i < kMsgs; ++i)
+    {
+      msg.set_data(i);
+      sent = std::chrono::steady_clock::now();
+      EXPECT_TRUE(pub.Publish(msg));
+      while (received.load(std::memory_order_acquire) <= i)
+        std::this_thread::yield();
+    }
+
+    std::cout << (inlineDelivery ? "Inline" : "Queued")
+              << " delivery latency: " << totalNs / kMsgs << " ns/msg"
+              << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  // Get a random partition name.
+  std::string partition = testing::getRandomNumber();
+
+  // Set the partition name for this process.
+  setenv("GZ_PARTITION", partition.c_str(), 1);
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
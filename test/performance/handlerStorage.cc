@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gz/msgs/int32.pb.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gz/transport/HandlerStorage.hh"
+#include "gz/transport/SubscriptionHandler.hh"
+#include "gz/transport/TransportTypes.hh"
+
+using namespace gz;
+
+/// \brief Number of lookups per reader thread.
+static const int kLookups = 200000;
+
+/// \brief Number of topics in the storage.
+static const int kTopics = 100;
+
+/// \brief Number of nodes subscribed to each topic.
+static const int kNodes = 4;
+
+//////////////////////////////////////////////////
+/// \brief Run a lookup from several threads while another thread keeps
+/// subscribing and unsubscribing.
+/// \param[in] _threads Number of reader threads.
+/// \param[in] _lookup The lookup. It receives the topic name and returns
+/// the number of handlers found.
+/// \param[in] _churn One subscription change.
+/// \return Average time per lookup (ns).
+static int64_t timeLookups(int _threads,
+  const std::function<std::size_t(const std::string &)> &_lookup,
+  const std::function<void()> &_churn)
+{
+  std::atomic<bool> done{false};
+  std::thread writer([&]()
+  {
+    while (!done)
+    {
+      _churn();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+
+  std::vector<std::string> topics;
+  for (int t = 0; t < kTopics; ++t)
+    topics.push_back("/topic_" + std::to_string(t));
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> readers;
+  for (int r = 0; r < _threads; ++r)
+  {
+    readers.emplace_back([&]()
+    {
+      std::size_t found = 0;
+      for (int i = 0; i < kLookups; ++i)
+        found += _lookup(topics[i % kTopics]);
+      EXPECT_GT(found, 0u);
+    });
+  }
+  for (auto &reader : readers)
+    reader.join();
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  done = true;
+  writer.join();
+
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    elapsed).count() / kLookups;
+}
+
+//////////////////////////////////////////////////
+/// \brief Compare copying the handlers of a topic under a mutex (previous
+/// behavior of every publication and received message) with reading the
+/// lock-free snapshot.
+TEST(HandlerStoragePerformance, Lookup)
+{
+  using Storage = transport::HandlerStorage<transport::ISubscriptionHandler>;
+  Storage storage(true);
+  std::mutex mutex;
+
+  for (int t = 0; t < kTopics; ++t)
+  {
+    for (int n = 0; n < kNodes; ++n)
+    {
+      const std::string nUuid = "node_" + std::to_string(n);
+      storage.AddHandler("/topic_" + std::to_string(t), nUuid,
+        std::make_shared<transport::SubscriptionHandler<msgs::Int32>>(
+          nUuid));
+    }
+  }
+
+  // Subscribe and unsubscribe an extra node to a topic.
+  auto extra =
+    std::make_shared<transport::SubscriptionHandler<msgs::Int32>>("extra");
+  bool subscribed = false;
+  auto churn = [&]()
+  {
+    std::lock_guard<std::mutex> lk(mutex);
+    if (subscribed)
+      storage.RemoveHandlersForNode("/topic_0", "extra");
+    else
+      storage.AddHandler("/topic_0", "extra", extra);
+    subscribed = !subscribed;
+  };
+
+  auto copyLookup = [&](const std::string &_topic) -> std::size_t
+  {
+    std::map<std::string, transport::ISubscriptionHandler_M> handlers;
+    std::lock_guard<std::mutex> lk(mutex);
+    storage.Handlers(_topic, handlers);
+    return handlers.size();
+  };
+
+  auto snapshotLookup = [&](const std::string &_topic) -> std::size_t
+  {
+    Storage::HandlerListPtr handlers = storage.Snapshot(_topic);
+    return handlers ? handlers->size() : 0u;
+  };
+
+  for (int threads = 1; threads <= 8; threads *= 2)
+  {
+    const int64_t copyNs = timeLookups(threads, copyLookup, churn);
+    const int64_t snapshotNs = timeLookups(threads, snapshotLookup, churn);
+
+    std::cout << threads << " reader threads\n"
+              << "\tCopy under mutex: " << copyNs << " ns/lookup\n"
+              << "\tSnapshot:         " << snapshotNs << " ns/lookup"
+              << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef _WIN32
+  #include <arpa/inet.h>
+  #include <netinet/in.h>
+  #include <poll.h>
+  #include <sys/socket.h>
+  #include <unistd.h>
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "gz/transport/AdvertiseOptions.hh"
+#include "gz/transport/Discovery.hh"
+#include "gz/transport/NetUtils.hh"
+#include "gz/transport/Publisher.hh"
+#include "gz/transport/Uuid.hh"
+
+using namespace gz;
+using namespace transport;
+
+/// \brief Multicast group used by the discovery instances of this test.
+static const char kGroup[] = "224.0.0.7";
+
+/// \brief Port used by the discovery instances of this test.
+static const int kPort = 11329;
+
+/// \brief Number of heartbeats measured per configuration.
+static const int kHeartbeats = 5;
+
+#ifndef _WIN32
+//////////////////////////////////////////////////
+/// \brief Open a socket listening to the discovery multicast group.
+/// \return The socket or -1 on error.
+static int openListener()
+{
+  int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (sock < 0)
+    return -1;
+
+  int reuse = 1;
+  setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#ifdef SO_REUSEPORT
+  setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse));
+#endif
+
+  sockaddr_in localAddr;
+  memset(&localAddr, 0, sizeof(localAddr));
+  localAddr.sin_family = AF_INET;
+  localAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+  localAddr.sin_port = htons(kPort);
+  if (bind(sock, reinterpret_cast<sockaddr *>(&localAddr),
+      sizeof(localAddr)) != 0)
+  {
+    close(sock);
+    return -1;
+  }
+
+  ip_mreq group;
+  group.imr_multiaddr.s_addr = inet_addr(kGroup);
+  group.imr_interface.s_addr = inet_addr(determineHost().c_str());
+  if (setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &group,
+      sizeof(group)) != 0)
+  {
+    close(sock);
+    return -1;
+  }
+
+  return sock;
+}
+
+//////////////////////////////////////////////////
+/// \brief Count the discovery datagrams and bytes sent by a process that
+/// advertises 10 to 1000 topics, during a few heartbeats. Before the
+/// heartbeat packed the advertisements, every topic cost one datagram per
+/// heartbeat.
+TEST(HeartbeatPerformance, DatagramsPerHeartbeat)
+{
+  for (int topics = 10; topics <= 1000; topics *= 10)
+  {
+    int sock = openListener();
+    ASSERT_GE(sock, 0);
+
+    const std::string pUuid = Uuid().ToString();
+    const std::string nUuid = Uuid().ToString();
+    MsgDiscovery discovery(pUuid, kGroup, kPort);
+    discovery.Start();
+
+    for (int i = 0; i < topics; ++i)
+    {
+      MessagePublisher publisher(
+        "/world/default/model/model_" + std::to_string(i) + "/pose",
+        "tcp://127.0.0.1:12345", "tcp://127.0.0.1:12346", pUuid, nUuid,
+        "gz.msgs.Pose", AdvertiseMessageOptions());
+      EXPECT_TRUE(discovery.Advertise(publisher));
+    }
+
+    // Let the advertisements sent by Advertise() go by.
+    const auto interval =
+      std::chrono::milliseconds(discovery.HeartbeatInterval());
+    auto deadline = std::chrono::steady_clock::now() + interval / 2;
+    char buffer[65536];
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+      pollfd item = {sock, POLLIN, 0};
+      if (poll(&item, 1, 10) > 0)
+        recv(sock, buffer, sizeof(buffer), 0);
+    }
+
+    int64_t datagrams = 0;
+    int64_t bytes = 0;
+    deadline = std::chrono::steady_clock::now() + interval * kHeartbeats;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+      pollfd item = {sock, POLLIN, 0};
+      if (poll(&item, 1, 10) <= 0)
+        continue;
+
+      auto received = recv(sock, buffer, sizeof(buffer), 0);
+      if (received > 0)
+      {
+        ++datagrams;
+        bytes += received;
+      }
+    }
+
+    close(sock);
+
+    EXPECT_GT(datagrams, 0);
+    std::cout << topics << " topics\n"
+              << "\tdatagrams per heartbeat: " << datagrams / kHeartbeats
+              << "\n\tbytes per heartbeat:     " << bytes / kHeartbeats
+              << std::endl;
+  }
+}
+#endif
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gz/msgs/int64.pb.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "gz/transport/Node.hh"
+#include "gz/transport/OverflowPolicy.hh"
+#include "gz/transport/SubscribeOptions.hh"
+#include "test_config.hh"
+
+using namespace gz;
+
+/// \brief Number of messages published per measurement.
+static const int kMsgs = 1000;
+
+/// \brief Time spent by the slow subscriber in each callback.
+static const std::chrono::milliseconds kSlowCallback{5};
+
+//////////////////////////////////////////////////
+/// \brief Current time (ns).
+static int64_t nowNs()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//////////////////////////////////////////////////
+/// \brief Measure the latency of a fast subscriber sharing a topic with a
+/// slow one, when the local callbacks run on a pool of threads. The slow
+/// subscriber keeps at most 10 messages and drops the oldest ones. With a
+/// single publish thread, every message of the fast subscriber would wait
+/// for the previous callback of the slow one.
+TEST(LocalDeliveryPerformance, SlowNeighbor)
+{
+  const std::string topic = "/local_delivery_performance";
+  transport::Node node;
+
+  auto pub = node.Advertise<msgs::Int64>(topic);
+  ASSERT_TRUE(pub);
+
+  std::atomic<int> slowReceived{0};
+  std::function<void(const msgs::Int64 &)> slowCb =
+    [&slowReceived](const msgs::Int64 &)
+    {
+      std::this_thread::sleep_for(kSlowCallback);
+      ++slowReceived;
+    };
+  transport::SubscribeOptions slowOpts;
+  slowOpts.SetLocalQueueDepth(10);
+  slowOpts.SetOverflow(transport::OverflowPolicy::DROP_OLDEST);
+  ASSERT_TRUE(node.Subscribe(topic, slowCb, slowOpts));
+
+  std::atomic<int> fastReceived{0};
+  std::atomic<bool> inOrder{true};
+  int64_t last = 0;
+  int64_t totalLatencyNs = 0;
+  int64_t maxLatencyNs = 0;
+  std::function<void(const msgs::Int64 &)> fastCb =
+    [&](const msgs::Int64 &_msg)
+    {
+      const int64_t latency = nowNs() - _msg.data();
+      totalLatencyNs += latency;
+      maxLatencyNs = std::max(maxLatencyNs, latency);
+      if (_msg.data() < last)
+        inOrder = false;
+      last = _msg.data();
+      ++fastReceived;
+    };
+  ASSERT_TRUE(node.Subscribe(topic, fastCb));
+
+  msgs::Int64 msg;
+  for (int i = 0; i < kMsgs; ++i)
+  {
+    msg.set_data(nowNs());
+    EXPECT_TRUE(pub.Publish(msg));
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+  }
+
+  for (int i = 0; i < 500 && fastReceived < kMsgs; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  EXPECT_EQ(kMsgs, fastReceived);
+  EXPECT_TRUE(inOrder);
+
+  std::cout << "Fast subscriber\n"
+            << "\tAverage latency: "
+            << totalLatencyNs / std::max(1, fastReceived.load()) << " ns\n"
+            << "\tMax latency:     " << maxLatencyNs << " ns\n"
+            << "Slow subscriber\n"
+            << "\tDelivered:       " << slowReceived << " of " << kMsgs
+            << std::endl;
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  // Get a random partition name.
+  std::string partition = testing::getRandomNumber();
+
+  // Set the partition name for this process.
+  setenv("GZ_PARTITION", partition.c_str(), 1);
+
+  // Run the local callbacks on a pool of threads.
+  setenv("GZ_TRANSPORT_LOCAL_CALLBACK_THREADS", "4", 1);
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gz/msgs/bytes.pb.h>
+#include <gz/msgs/int64.pb.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "gz/transport/Node.hh"
+#include "test_config.hh"
+
+using namespace gz;
+
+static std::string partition;  // NOLINT(*)
+
+/// \brief Latency of the control messages.
+struct Latency
+{
+  /// \brief Protects the members.
+  std::mutex mutex;
+
+  /// \brief Number of control messages received.
+  int64_t count = 0;
+
+  /// \brief Sum of the latencies (ns).
+  int64_t sumNs = 0;
+
+  /// \brief Maximum latency (ns).
+  int64_t maxNs = 0;
+
+  /// \brief Number of bulk messages received.
+  int64_t bulk = 0;
+};
+
+//////////////////////////////////////////////////
+/// \brief Receive the messages of priorityLanes_aux and measure the latency
+/// of the control messages while the bulk messages saturate the link.
+/// \param[in] _lanes True if the publisher uses the priority lanes.
+/// \param[out] _latency The measured latency.
+void measure(const bool _lanes, Latency &_latency)
+{
+  setenv("PRIORITY_LANES_TEST", _lanes ? "1" : "0", 1);
+
+  std::string publisherPath = testing::portablePathUnion(
+     GZ_TRANSPORT_TEST_DIR,
+     "PERFORMANCE_priorityLanes_aux");
+
+  testing::forkHandlerType pi = testing::forkAndRun(publisherPath.c_str(),
+    partition.c_str());
+
+  transport::Node node;
+  std::function<void(const msgs::Bytes &)> bulkCb =
+    [&_latency](const msgs::Bytes &)
+    {
+      std::lock_guard<std::mutex> lk(_latency.mutex);
+      ++_latency.bulk;
+    };
+  std::function<void(const msgs::Int64 &)> controlCb =
+    [&_latency](const msgs::Int64 &_msg)
+    {
+      const int64_t now =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count();
+      std::lock_guard<std::mutex> lk(_latency.mutex);
+      ++_latency.count;
+      _latency.sumNs += now - _msg.data();
+      _latency.maxNs = std::max(_latency.maxNs, now - _msg.data());
+    };
+  EXPECT_TRUE(node.Subscribe("/bulk", bulkCb));
+  EXPECT_TRUE(node.Subscribe("/control", controlCb));
+
+  testing::waitAndCleanupFork(pi);
+
+  EXPECT_TRUE(node.Unsubscribe("/bulk"));
+  EXPECT_TRUE(node.Unsubscribe("/control"));
+}
+
+//////////////////////////////////////////////////
+/// \brief Print the results of a measurement.
+/// \param[in] _name Name of the configuration.
+/// \param[in] _latency The measured latency.
+void print(const std::string &_name, Latency &_latency)
+{
+  std::lock_guard<std::mutex> lk(_latency.mutex);
+  std::cout << _name << "\n"
+            << "\tBulk messages:      " << _latency.bulk << "\n"
+            << "\tControl messages:   " << _latency.count << "\n";
+  if (_latency.count > 0)
+  {
+    std::cout << "\tAverage latency:    "
+              << _latency.sumNs / _latency.count / 1000 << " us\n"
+              << "\tMaximum latency:    " << _latency.maxNs / 1000 << " us\n";
+  }
+  std::cout << std::flush;
+}
+
+//////////////////////////////////////////////////
+/// \brief Compare the latency of small control messages published next to
+/// 10 MB messages, first in the same lane and then in separate lanes.
+TEST(PriorityLanesPerformance, ControlLatency)
+{
+  Latency sameLane;
+  measure(false, sameLane);
+  print("Control and bulk in the NORMAL lane", sameLane);
+
+  Latency lanes;
+  measure(true, lanes);
+  print("Control in the REALTIME lane, bulk in the BULK lane", lanes);
+
+  std::lock_guard<std::mutex> lk(lanes.mutex);
+  EXPECT_GT(lanes.count, 0);
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  // Get a random partition name.
+  partition = testing::getRandomNumber();
+
+  // Set the partition name for this process.
+  setenv("GZ_PARTITION", partition.c_str(), 1);
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
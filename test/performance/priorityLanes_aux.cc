@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gz/msgs/bytes.pb.h>
+#include <gz/msgs/int64.pb.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "gz/transport/AdvertiseOptions.hh"
+#include "gz/transport/Helpers.hh"
+#include "gz/transport/Node.hh"
+#include "test_config.hh"
+
+using namespace gz;
+
+/// \brief Size of the bulk messages (bytes).
+static const std::size_t kBulkSize = 10 * 1024 * 1024;
+
+//////////////////////////////////////////////////
+/// \brief Publish large messages on /bulk as fast as possible while small
+/// timestamped messages are published on /control every 10 ms.
+/// \param[in] _lanes True to publish /bulk in the BULK lane and /control in
+/// the REALTIME lane, false to publish both in the NORMAL lane.
+void advertiseAndPublish(const bool _lanes)
+{
+  transport::AdvertiseMessageOptions bulkOpts;
+  transport::AdvertiseMessageOptions controlOpts;
+  if (_lanes)
+  {
+    bulkOpts.SetPriority(transport::Priority_t::BULK);
+    controlOpts.SetPriority(transport::Priority_t::REALTIME);
+  }
+
+  transport::Node node;
+  auto bulkPub = node.Advertise<msgs::Bytes>("/bulk", bulkOpts);
+  auto controlPub = node.Advertise<msgs::Int64>("/control", controlOpts);
+
+  // Wait for the subscriber.
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+  std::atomic<bool> done{false};
+  std::thread bulkThread([&bulkPub, &done]()
+  {
+    msgs::Bytes msg;
+    msg.set_data(std::string(kBulkSize, 'x'));
+    while (!done)
+      bulkPub.Publish(msg);
+  });
+
+  msgs::Int64 msg;
+  for (int i = 0; i < 300; ++i)
+  {
+    msg.set_data(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+    controlPub.Publish(msg);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  done = true;
+  bulkThread.join();
+
+  // Let the subscriber drain the queues.
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  if (argc != 2)
+  {
+    std::cerr << "Partition name has not be passed as argument" << std::endl;
+    return -1;
+  }
+
+  // Set the partition name for this test.
+  setenv("GZ_PARTITION", argv[1], 1);
+
+  // The mode is inherited from the test process.
+  std::string lanes;
+  gz::transport::env("PRIORITY_LANES_TEST", lanes);
+
+  advertiseAndPublish(lanes == "1");
+}
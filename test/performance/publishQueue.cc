@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gz/msgs/int32.pb.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gz/transport/Node.hh"
+#include "test_config.hh"
+
+using namespace gz;
+
+/// \brief Number of messages published per measurement.
+static const int kMsgs = 320000;
+
+//////////////////////////////////////////////////
+/// \brief Measure the throughput of the intra-process publications, from
+/// the first Publish() to the last callback, while 1 to 32 threads publish
+/// on the same topic.
+TEST(PublishQueuePerformance, Contention)
+{
+  const std::string topic = "/publish_queue_performance";
+  transport::Node node;
+
+  auto pub = node.Advertise<msgs::Int32>(topic);
+  ASSERT_TRUE(pub);
+
+  std::atomic<int> received{0};
+  std::function<void(const msgs::Int32 &)> cb =
+    [&received](const msgs::Int32 &)
+    {
+      received.fetch_add(1, std::memory_order_relaxed);
+    };
+  ASSERT_TRUE(node.Subscribe(topic, cb));
+
+  for (int numThreads = 1; numThreads <= 32; numThreads *= 2)
+  {
+    received = 0;
+    const int msgsPerThread = kMsgs / numThreads;
+    const int total = msgsPerThread * numThreads;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t)
+    {
+      threads.emplace_back([&pub, msgsPerThread]()
+      {
+        msgs::Int32 msg;
+        for (int i = 0; i < msgsPerThread; ++i)
+        {
+          msg.set_data(i);
+          EXPECT_TRUE(pub.Publish(msg));
+        }
+      });
+    }
+
+    for (auto &thread : threads)
+      thread.join();
+    const auto published = std::chrono::steady_clock::now();
+
+    while (received.load(std::memory_order_relaxed) < total)
+      std::this_thread::yield();
+    const auto delivered = std::chrono::steady_clock::now();
+
+    const auto publishNs = std::chrono::duration_cast<
+      std::chrono::nanoseconds>(published - start).count();
+    const auto deliveryNs = std::chrono::duration_cast<
+      std::chrono::nanoseconds>(delivered - start).count();
+
+    std::cout << numThreads << " publishing threads\n"
+              << "\tPublish():          " << publishNs / total
+              << " ns/msg\n"
+              << "\tDelivered:          "
+              << static_cast<int64_t>(total * 1e9 / deliveryNs)
+              << " msgs/s\n"
+              << "\tQueue high water:   " << transport::publishQueueHighWater()
+              << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  // Get a random partition name.
+  std::string partition = testing::getRandomNumber();
+
+  // Set the partition name for this process.
+  setenv("GZ_PARTITION", partition.c_str(), 1);
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gz/msgs/int32.pb.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gz/transport/Node.hh"
+#include "test_config.hh"
+
+using namespace gz;
+
+static std::string partition;  // NOLINT(*)
+
+/// \brief Number of responser processes launched.
+static const int kRounds = 5;
+
+/// \brief Number of calls after the first one to each responser.
+static const int kCalls = 100;
+
+//////////////////////////////////////////////////
+/// \brief Wait until the /echo service is discovered.
+/// \param[in] _node Node used to query the services.
+/// \return True if the service was discovered.
+bool waitForService(transport::Node &_node)
+{
+  for (int i = 0; i < 300; ++i)
+  {
+    std::vector<std::string> services;
+    _node.ServiceList(services);
+    if (std::find(services.begin(), services.end(), "/echo") !=
+        services.end())
+    {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+/// \brief Measure the time of the first service call to a new responser
+/// process, which includes connecting to it, and compare it with the
+/// following calls.
+TEST(ServiceFirstCallPerformance, FirstCallLatency)
+{
+  std::string responserPath = testing::portablePathUnion(
+     GZ_TRANSPORT_TEST_DIR,
+     "PERFORMANCE_serviceFirstCall_aux");
+
+  int64_t firstSumUs = 0;
+  int64_t firstMaxUs = 0;
+  int64_t nextSumUs = 0;
+  int firstCount = 0;
+  int nextCount = 0;
+
+  for (int round = 0; round < kRounds; ++round)
+  {
+    testing::forkHandlerType pi = testing::forkAndRun(responserPath.c_str(),
+      partition.c_str());
+
+    {
+      transport::Node node;
+      ASSERT_TRUE(waitForService(node));
+
+      msgs::Int32 req;
+      msgs::Int32 rep;
+      bool result = false;
+      req.set_data(round);
+
+      auto start = std::chrono::steady_clock::now();
+      bool executed = node.Request("/echo", req, 2000, rep, result);
+      auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+      EXPECT_TRUE(executed);
+      EXPECT_TRUE(result);
+      if (executed)
+      {
+        firstSumUs += elapsed;
+        firstMaxUs = std::max<int64_t>(firstMaxUs, elapsed);
+        ++firstCount;
+      }
+
+      for (int i = 0; i < kCalls; ++i)
+      {
+        start = std::chrono::steady_clock::now();
+        executed = node.Request("/echo", req, 2000, rep, result);
+        elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start).count();
+        if (executed)
+        {
+          nextSumUs += elapsed;
+          ++nextCount;
+        }
+      }
+    }
+
+    testing::waitAndCleanupFork(pi);
+  }
+
+  std::cout << "Service calls to " << kRounds << " new responsers\n";
+  if (firstCount > 0)
+  {
+    std::cout << "\tFirst call average:  " << firstSumUs / firstCount
+              << " us\n"
+              << "\tFirst call maximum:  " << firstMaxUs << " us\n";
+  }
+  if (nextCount > 0)
+  {
+    std::cout << "\tNext calls average:  " << nextSumUs / nextCount
+              << " us\n";
+  }
+  std::cout << std::flush;
+
+  EXPECT_EQ(kRounds, firstCount);
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  // Get a random partition name.
+  partition = testing::getRandomNumber();
+
+  // Set the partition name for this process.
+  setenv("GZ_PARTITION", partition.c_str(), 1);
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "TopicPatternTrie.hh"
+
+using namespace gz;
+using namespace transport;
+
+/// \brief Number of advertised topics matched against the patterns.
+static const int kTopics = 10000;
+
+//////////////////////////////////////////////////
+/// \brief Get an advertised topic of a large world.
+/// \param[in] _index Topic index.
+/// \return The topic name.
+static std::string makeTopic(int _index)
+{
+  static const char *kLeaves[] = {"pose", "twist", "joint_state", "image"};
+  return "@/partition@/world/default/model/model_" +
+    std::to_string(_index / 4) + "/" + kLeaves[_index % 4];
+}
+
+//////////////////////////////////////////////////
+/// \brief Compare the cost of matching every advertisement against 10 to
+/// 1000 patterns with a regular expression per pattern, as the recorder
+/// does, and with the trie used by the pattern subscriptions.
+TEST(TopicPatternPerformance, Match)
+{
+  std::vector<std::string> topics;
+  for (int i = 0; i < kTopics; ++i)
+    topics.push_back(makeTopic(i));
+
+  for (int patterns = 10; patterns <= 1000; patterns *= 10)
+  {
+    // One pattern matches the poses of every model and the rest select
+    // the images of single models.
+    std::vector<std::regex> regexes;
+    TopicPatternTrie<int> trie;
+    regexes.emplace_back("@/partition@/world/default/model/[^/]+/pose");
+    trie.Insert("@/partition@/world/default/model/*/pose", 0);
+    for (int p = 1; p < patterns; ++p)
+    {
+      const std::string model = "model_" + std::to_string(p);
+      regexes.emplace_back(
+        "@/partition@/world/default/model/" + model + "/.*");
+      trie.Insert("@/partition@/world/default/model/" + model + "/**", p);
+    }
+
+    int regexMatches = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &topic : topics)
+    {
+      for (const auto &regex : regexes)
+        regexMatches += std::regex_match(topic, regex) ? 1 : 0;
+    }
+    const int64_t regexNs =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count() / kTopics;
+
+    int trieMatches = 0;
+    std::vector<int> values;
+    start = std::chrono::steady_clock::now();
+    for (const auto &topic : topics)
+    {
+      values.clear();
+      trie.Match(topic, values);
+      trieMatches += static_cast<int>(values.size());
+    }
+    const int64_t trieNs =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count() / kTopics;
+
+    EXPECT_EQ(regexMatches, trieMatches);
+
+    std::cout << patterns << " patterns, " << kTopics << " topics\n"
+              << "\tstd::regex per pattern: " << regexNs << " ns/topic\n"
+              << "\tTopicPatternTrie:       " << trieNs << " ns/topic"
+              << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
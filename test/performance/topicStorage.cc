@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gz/transport/AdvertiseOptions.hh"
+#include "gz/transport/Publisher.hh"
+#include "gz/transport/TopicStorage.hh"
+
+using namespace gz;
+using namespace transport;
+
+/// \brief Number of processes in the discovery graph.
+static const int kProcs = 200;
+
+/// \brief Number of processes publishing each topic.
+static const int kPubsPerTopic = 2;
+
+//////////////////////////////////////////////////
+/// \brief Create a publisher of the discovery graph.
+/// \param[in] _topic Topic index.
+/// \param[in] _proc Process index.
+/// \return The publisher.
+static MessagePublisher makePublisher(int _topic, int _proc)
+{
+  const std::string proc = std::to_string(_proc);
+  return MessagePublisher("@/partition@/topic_" + std::to_string(_topic),
+    "tcp://10.0.0.1:" + proc, "tcp://10.0.0.1:ctrl" + proc, "proc_" + proc,
+    "node_" + proc, "gz.msgs.Int32", AdvertiseMessageOptions());
+}
+
+//////////////////////////////////////////////////
+/// \brief Time an operation.
+/// \param[in] _iterations Number of iterations.
+/// \param[in] _op The operation, receiving the iteration number.
+/// \return Average time per iteration (ns).
+template<typename Op>
+static int64_t timeNs(int _iterations, Op _op)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < _iterations; ++i)
+    _op(i);
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - start).count() / _iterations;
+}
+
+//////////////////////////////////////////////////
+/// \brief Measure the discovery operations on graphs of 100 to 10000
+/// topics. Each operation should cost about the same regardless of the
+/// number of topics, except for removing a process, which depends on the
+/// number of publishers of that process.
+TEST(TopicStoragePerformance, Scaling)
+{
+  for (int topics = 100; topics <= 10000; topics *= 10)
+  {
+    TopicStorage<MessagePublisher> storage;
+
+    // Publishers of topic t live in processes t % kProcs, t % kProcs + 1...
+    std::vector<std::vector<MessagePublisher>> byProc(kProcs);
+    for (int t = 0; t < topics; ++t)
+    {
+      for (int p = 0; p < kPubsPerTopic; ++p)
+      {
+        auto pub = makePublisher(t, (t + p) % kProcs);
+        EXPECT_TRUE(storage.AddPublisher(pub));
+        byProc[(t + p) % kProcs].push_back(pub);
+      }
+    }
+
+    const int kIterations = 10000;
+    std::vector<MessagePublisher> extra;
+    for (int i = 0; i < kIterations; ++i)
+      extra.push_back(makePublisher(topics + i, i % kProcs));
+
+    const int64_t addNs = timeNs(kIterations, [&](int _i)
+    {
+      storage.AddPublisher(extra[_i]);
+    });
+
+    const int64_t delNodeNs = timeNs(kIterations, [&](int _i)
+    {
+      storage.DelPublisherByNode(extra[_i].Topic(), extra[_i].PUuid(),
+        extra[_i].NUuid());
+    });
+
+    bool found = true;
+    const int64_t hasTopicNs = timeNs(kIterations, [&](int _i)
+    {
+      found &= storage.HasTopic(byProc[_i % kProcs][0].Topic(),
+        "gz.msgs.Int32");
+    });
+    EXPECT_TRUE(found);
+
+    const int64_t hasPublisherNs = timeNs(kIterations, [&](int _i)
+    {
+      found &= storage.HasPublisher(byProc[_i % kProcs][0].Addr());
+    });
+    EXPECT_TRUE(found);
+
+    std::map<std::string, std::vector<MessagePublisher>> pubs;
+    const int64_t byProcNs = timeNs(kProcs, [&](int _i)
+    {
+      storage.PublishersByProc("proc_" + std::to_string(_i), pubs);
+    });
+
+    // Remove every process and add its publishers again.
+    int64_t delProcNs = 0;
+    for (int p = 0; p < kProcs; ++p)
+    {
+      delProcNs += timeNs(1, [&](int)
+      {
+        EXPECT_TRUE(storage.DelPublishersByProc("proc_" + std::to_string(p)));
+      });
+      for (const auto &pub : byProc[p])
+        storage.AddPublisher(pub);
+    }
+    delProcNs /= kProcs;
+
+    std::cout << topics << " topics, " << kProcs << " processes\n"
+              << "\tAddPublisher():        " << addNs << " ns\n"
+              << "\tDelPublisherByNode():  " << delNodeNs << " ns\n"
+              << "\tHasTopic(type):        " << hasTopicNs << " ns\n"
+              << "\tHasPublisher():        " << hasPublisherNs << " ns\n"
+              << "\tPublishersByProc():    " << byProcNs << " ns\n"
+              << "\tDelPublishersByProc(): " << delProcNs << " ns ("
+              << topics * kPubsPerTopic / kProcs << " publishers)"
+              << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}